@@ -1,4 +1,13 @@
 #include "src/addon_core.inl"
 #include "src/addon_exports.inl"
+#include "src/addon_gpu_timers.inl"
+#include "src/addon_perf.inl"
+#include "src/addon_timeline.inl"
+#include "src/addon_trace.inl"
+#include "src/addon_camera.inl"
+#include "src/addon_view_cache.inl"
+#include "src/addon_depth_classes.inl"
+#include "src/addon_fx_products.inl"
+#include "src/addon_prehud_depth.inl"
 #include "src/addon_runtime.inl"
 #include "src/addon_dllmain.inl"
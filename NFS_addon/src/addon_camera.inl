@@ -0,0 +1,126 @@
+// ---------- Camera uniforms ----------
+// Publishes the bridge camera feed (NFSTweak_PushCameraState) to effect uniforms selected by their
+// 'source' annotation. Variables are resolved once per effect reload; values are written once per
+// present and only when a new camera sample arrived.
+//
+//   uniform float4x4 View     < source = "nfstweak_view"; >;       // row-major, v * M
+//   uniform float4x4 Proj     < source = "nfstweak_proj"; >;
+//   uniform float4x4 PrevView < source = "nfstweak_view_prev"; >;
+//   uniform float4x4 PrevProj < source = "nfstweak_proj_prev"; >;
+//   uniform float4   Camera   < source = "nfstweak_camera"; >;     // near, far, fov_y (rad), aspect
+//   uniform uint     CamFlags < source = "nfstweak_camera_flags"; >; // NFSTWEAK_CAMERA_* (0 = no feed)
+
+enum camera_uniform_source : uint32_t
+{
+    k_camera_src_view = 0,
+    k_camera_src_proj,
+    k_camera_src_view_prev,
+    k_camera_src_proj_prev,
+    k_camera_src_params,
+    k_camera_src_flags,
+    k_camera_src_count
+};
+static const char *const k_camera_uniform_sources[k_camera_src_count] = {
+    "nfstweak_view", "nfstweak_proj", "nfstweak_view_prev", "nfstweak_proj_prev", "nfstweak_camera", "nfstweak_camera_flags",
+};
+
+struct camera_uniform_binding
+{
+    effect_uniform_variable var;
+    uint32_t source;
+};
+static std::vector<camera_uniform_binding> g_camera_uniforms;
+static bool g_camera_uniforms_resolved = false;
+static uint32_t g_camera_uniforms_published_frame = 0;
+static uint32_t g_camera_uniforms_published_flags = 0;
+static constexpr uint64_t k_camera_stale_frames = 30; // treat the feed as lost after this many presents
+
+static void invalidate_camera_uniforms()
+{
+    g_camera_uniforms.clear();
+    g_camera_uniforms_resolved = false;
+    g_camera_uniforms_published_frame = 0;
+    g_camera_uniforms_published_flags = 0;
+}
+
+static void resolve_camera_uniforms()
+{
+    g_camera_uniforms_resolved = true;
+    g_camera_uniforms.clear();
+    g_runtime->enumerate_uniform_variables(nullptr, [](effect_runtime *runtime, effect_uniform_variable var) {
+        char source[64] = {};
+        if (!runtime->get_annotation_string_from_uniform_variable(var, "source", source))
+            return;
+        for (uint32_t i = 0; i < k_camera_src_count; ++i)
+        {
+            if (strcmp(source, k_camera_uniform_sources[i]) == 0)
+            {
+                g_camera_uniforms.push_back({ var, i });
+                break;
+            }
+        }
+    });
+
+    if (!g_camera_uniforms.empty())
+    {
+        char msg[128] = {};
+        sprintf_s(msg, "NFSTweakBridge: %u effect uniforms consume the camera feed.\n", static_cast<unsigned>(g_camera_uniforms.size()));
+        log_info(msg);
+    }
+}
+
+static void publish_camera_uniforms()
+{
+    if (g_runtime == nullptr)
+        return;
+    if (!g_camera_uniforms_resolved)
+        resolve_camera_uniforms();
+    if (g_camera_uniforms.empty())
+        return;
+
+    NFSTweakCameraState cur = {};
+    NFSTweakCameraState prev = {};
+    uint64_t pushed_at = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_camera_mutex);
+        cur = g_camera_state;
+        prev = g_camera_state_prev;
+        pushed_at = g_camera_state_addon_frame;
+    }
+
+    const uint64_t frame = g_frame_index.load(std::memory_order_relaxed);
+    const bool stale = pushed_at == 0 || frame > pushed_at + k_camera_stale_frames;
+    const uint32_t flags = stale ? 0u : cur.flags;
+    if (cur.frame == g_camera_uniforms_published_frame && flags == g_camera_uniforms_published_flags)
+        return;
+    g_camera_uniforms_published_frame = cur.frame;
+    g_camera_uniforms_published_flags = flags;
+
+    // Without a valid previous sample (first frame, camera cut) reproject against the current camera.
+    const bool prev_ok = (prev.flags & NFSTWEAK_CAMERA_VALID) != 0 && (cur.flags & NFSTWEAK_CAMERA_CUT) == 0;
+    const float params[4] = { cur.near_plane, cur.far_plane, cur.fov_y, cur.aspect };
+    for (const camera_uniform_binding &b : g_camera_uniforms)
+    {
+        switch (b.source)
+        {
+        case k_camera_src_view:
+            g_runtime->set_uniform_value_float(b.var, cur.view, 16);
+            break;
+        case k_camera_src_proj:
+            g_runtime->set_uniform_value_float(b.var, cur.proj, 16);
+            break;
+        case k_camera_src_view_prev:
+            g_runtime->set_uniform_value_float(b.var, prev_ok ? prev.view : cur.view, 16);
+            break;
+        case k_camera_src_proj_prev:
+            g_runtime->set_uniform_value_float(b.var, prev_ok ? prev.proj : cur.proj, 16);
+            break;
+        case k_camera_src_params:
+            g_runtime->set_uniform_value_float(b.var, params, 4);
+            break;
+        case k_camera_src_flags:
+            g_runtime->set_uniform_value_uint(b.var, &flags, 1);
+            break;
+        }
+    }
+}
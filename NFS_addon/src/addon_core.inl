@@ -5,7 +5,7 @@
 //  - Link against ReShade addon headers/libs and D3D9 (for IDirect3DSurface9 usage).
 //  - This file intentionally leaves GPU-copy details as TODOs — see comments below.
 
-#include "..\\third_party\\imgui_19250_docking.h"
+#include "../third_party/imgui_19250_docking.h"
 #include <reshade.hpp>
 #include <reshade_api.hpp>
 #include <reshade_events.hpp>
@@ -17,15 +17,277 @@
 #include <atomic>
 #include <mutex>
 #include <vector>
+#include <new>
 #include <cstdlib>
+#include <cmath>
+#include <cstdarg>
+#include "NFSTweakBridgeAPI.h"
+#include "NFSTweakTraceFile.h"
 
 using namespace reshade::api;
 
-static void log_info(const char *msg)
+static uint64_t qpc_now()
+{
+    LARGE_INTEGER now = {};
+    QueryPerformanceCounter(&now);
+    return static_cast<uint64_t>(now.QuadPart);
+}
+
+static uint64_t qpc_frequency()
+{
+    // Fixed at boot; query once.
+    static const uint64_t s_freq = []() {
+        LARGE_INTEGER freq = {};
+        return QueryPerformanceFrequency(&freq) ? static_cast<uint64_t>(freq.QuadPart) : 0ull;
+    }();
+    return s_freq;
+}
+
+static double qpc_to_ms(uint64_t ticks)
+{
+    const uint64_t freq = qpc_frequency();
+    return freq != 0 ? (static_cast<double>(ticks) * 1000.0) / static_cast<double>(freq) : 0.0;
+}
+
+// ---------- Log sink ----------
+// While an effect runtime exists, log_info only copies the line into a bounded lock-free MPSC queue (Vyukov-style
+// sequence per slot); a below-normal priority thread writes queued lines to ReShade.log and the debugger. Outside
+// that window (DllMain, exports before init) lines are written synchronously. A full queue drops the line and counts it.
+// Slot sequences are stored relative to the slot index (lap base = pos & ~mask), so the zero-initialized array is a
+// valid empty queue: base = free for this lap, base + 1 = line published, base + slots = released for the next lap.
+
+static void log_write_now(const char *msg)
 {
     // Write to ReShade.log (and also to debugger output, if attached).
     reshade::log::message(reshade::log::level::info, msg);
     OutputDebugStringA(msg);
 }
 
+static constexpr uint32_t k_log_queue_slots = 256; // power of two
+static constexpr uint32_t k_log_line_bytes = 320;  // matches the largest caller buffers; longer lines are truncated
+struct log_slot
+{
+    std::atomic_uint32_t seq;
+    char text[k_log_line_bytes];
+};
+static log_slot g_log_queue[k_log_queue_slots];
+static std::atomic_uint32_t g_log_enqueue_pos(0);
+static std::atomic_uint32_t g_log_dequeue_pos(0);
+static std::atomic_bool g_log_sink_running(false);
+static std::atomic_uint32_t g_log_producers(0); // log_info/log_infof calls between the running check and the publish
+static std::atomic_bool g_log_sink_stop(false);
+static HANDLE g_log_sink_thread = nullptr;
+static HANDLE g_log_sink_wake = nullptr;
+static std::atomic_uint64_t g_log_lines_queued(0);
+static std::atomic_uint64_t g_log_lines_written(0);
+static std::atomic_uint64_t g_log_lines_dropped(0);
+static std::atomic_uint64_t g_log_lines_rate_limited(0);
+
+// Claims a slot and returns its buffer, or nullptr when the queue is full. Must be followed by log_queue_publish.
+static char *log_queue_claim(uint32_t &out_pos)
+{
+    uint32_t pos = g_log_enqueue_pos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        log_slot &slot = g_log_queue[pos & (k_log_queue_slots - 1)];
+        const int32_t diff = static_cast<int32_t>(slot.seq.load(std::memory_order_acquire) - (pos & ~(k_log_queue_slots - 1)));
+        if (diff == 0)
+        {
+            if (g_log_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                out_pos = pos;
+                return slot.text;
+            }
+        }
+        else if (diff < 0)
+        {
+            return nullptr; // full: the consumer has not released this slot yet
+        }
+        else
+        {
+            pos = g_log_enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+static void log_queue_publish(uint32_t pos)
+{
+    g_log_queue[pos & (k_log_queue_slots - 1)].seq.store((pos & ~(k_log_queue_slots - 1)) + 1, std::memory_order_release);
+    g_log_lines_queued.fetch_add(1, std::memory_order_relaxed);
+    // Wake the writer early only when the queue is filling up; otherwise it drains on its own tick.
+    if (pos - g_log_dequeue_pos.load(std::memory_order_relaxed) >= k_log_queue_slots / 2 && g_log_sink_wake != nullptr)
+        SetEvent(g_log_sink_wake);
+}
+
+// A producer counts itself in flight before it checks g_log_sink_running, and stop_log_sink clears the flag before it
+// waits for the count to drop to zero (both sides sequentially consistent), so every line that saw the sink running is
+// published before the final drain, and no producer touches the wake event after it is closed.
+static bool log_producer_enter()
+{
+    g_log_producers.fetch_add(1, std::memory_order_seq_cst);
+    if (g_log_sink_running.load(std::memory_order_seq_cst))
+        return true;
+    g_log_producers.fetch_sub(1, std::memory_order_release);
+    return false;
+}
+
+static void log_producer_leave()
+{
+    g_log_producers.fetch_sub(1, std::memory_order_release);
+}
+
+// Single consumer: the sink thread, or the thread stopping the sink once it has joined.
+static void log_queue_drain()
+{
+    uint32_t pos = g_log_dequeue_pos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        log_slot &slot = g_log_queue[pos & (k_log_queue_slots - 1)];
+        const uint32_t base = pos & ~(k_log_queue_slots - 1);
+        if (slot.seq.load(std::memory_order_acquire) != base + 1)
+            break;
+        log_write_now(slot.text);
+        g_log_lines_written.fetch_add(1, std::memory_order_relaxed);
+        slot.seq.store(base + k_log_queue_slots, std::memory_order_release);
+        ++pos;
+        g_log_dequeue_pos.store(pos, std::memory_order_relaxed);
+    }
+}
+
+static void log_info(const char *msg)
+{
+    if (!log_producer_enter())
+    {
+        log_write_now(msg);
+        g_log_lines_written.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    uint32_t pos = 0;
+    if (char *const text = log_queue_claim(pos))
+    {
+        strncpy_s(text, k_log_line_bytes, msg, _TRUNCATE);
+        log_queue_publish(pos);
+    }
+    else
+    {
+        g_log_lines_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    log_producer_leave();
+}
+
+// Formats straight into the queue slot (no caller stack buffer, no second copy).
+static void log_infof(_Printf_format_string_ const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    if (!log_producer_enter())
+    {
+        char line[k_log_line_bytes];
+        vsnprintf_s(line, sizeof(line), _TRUNCATE, format, args);
+        log_write_now(line);
+        g_log_lines_written.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        uint32_t pos = 0;
+        if (char *const text = log_queue_claim(pos))
+        {
+            vsnprintf_s(text, k_log_line_bytes, _TRUNCATE, format, args);
+            log_queue_publish(pos);
+        }
+        else
+        {
+            g_log_lines_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        log_producer_leave();
+    }
+    va_end(args);
+}
+
+static DWORD WINAPI log_sink_thread(LPVOID)
+{
+    while (!g_log_sink_stop.load(std::memory_order_acquire))
+    {
+        WaitForSingleObject(g_log_sink_wake, 20);
+        log_queue_drain();
+    }
+    return 0;
+}
+
+// Called from init/destroy_effect_runtime (never under the loader lock, so joining the thread is safe).
+static void start_log_sink()
+{
+    if (g_log_sink_thread != nullptr)
+        return;
+    g_log_sink_stop.store(false, std::memory_order_relaxed);
+    g_log_sink_wake = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+    g_log_sink_thread = g_log_sink_wake != nullptr ? CreateThread(nullptr, 0, log_sink_thread, nullptr, 0, nullptr) : nullptr;
+    if (g_log_sink_thread == nullptr)
+    {
+        if (g_log_sink_wake != nullptr)
+            CloseHandle(g_log_sink_wake);
+        g_log_sink_wake = nullptr;
+        log_write_now("NFSTweakBridge: Log sink thread unavailable; logging synchronously.\n");
+        return;
+    }
+    SetThreadPriority(g_log_sink_thread, THREAD_PRIORITY_BELOW_NORMAL);
+    g_log_sink_running.store(true, std::memory_order_release);
+}
+
+static void stop_log_sink()
+{
+    if (g_log_sink_thread == nullptr)
+        return;
+    g_log_sink_running.store(false, std::memory_order_seq_cst);
+    // Producers that saw the sink running finish publishing; new ones write synchronously.
+    while (g_log_producers.load(std::memory_order_acquire) != 0)
+        Sleep(0);
+    g_log_sink_stop.store(true, std::memory_order_release);
+    SetEvent(g_log_sink_wake);
+    WaitForSingleObject(g_log_sink_thread, INFINITE);
+    CloseHandle(g_log_sink_thread);
+    CloseHandle(g_log_sink_wake);
+    g_log_sink_thread = nullptr;
+    g_log_sink_wake = nullptr;
+    log_queue_drain(); // lines published after the thread's last pass
+}
+
+// Per-call-site limiter: the first `burst` hits pass, then at most one per `interval_ms`. Replaces frame-count patterns
+// like `n <= 4 || (n % 2400) == 0`, whose real rate depended on the frame rate.
+struct log_rate_limit
+{
+    log_rate_limit(uint32_t burst, uint32_t interval_ms) : burst(burst), interval_ms(interval_ms) {}
+
+    const uint32_t burst;
+    const uint32_t interval_ms;
+    std::atomic_uint64_t hits { 0 };
+    std::atomic_uint64_t next_qpc { 0 };
+    std::atomic_uint64_t suppressed { 0 }; // since the last line that passed
+};
+
+// Returns true when the caller should log; out_suppressed receives how many hits were swallowed since the last line.
+static bool log_rate_allow(log_rate_limit &site, uint64_t *out_suppressed = nullptr)
+{
+    const uint64_t hit = site.hits.fetch_add(1, std::memory_order_relaxed) + 1;
+    const uint64_t now = qpc_now();
+    if (hit > site.burst)
+    {
+        uint64_t next = site.next_qpc.load(std::memory_order_relaxed);
+        if (now < next || !site.next_qpc.compare_exchange_strong(next, now + (qpc_frequency() * site.interval_ms) / 1000, std::memory_order_relaxed))
+        {
+            site.suppressed.fetch_add(1, std::memory_order_relaxed);
+            g_log_lines_rate_limited.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    else
+    {
+        site.next_qpc.store(now + (qpc_frequency() * site.interval_ms) / 1000, std::memory_order_relaxed);
+    }
+    const uint64_t suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    if (out_suppressed != nullptr)
+        *out_suppressed = suppressed;
+    return true;
+}
+
 // exported metadata
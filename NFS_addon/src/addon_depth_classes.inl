@@ -0,0 +1,282 @@
+// ---------- Depth classification (main / mirror / shadow) ----------
+// Every DS the game binds or clears is tagged once per phase epoch from its size, aspect, format,
+// clear pattern and render target pairing. Secondary classes are published under their own semantics
+// through the depth view cache, so effects can sample mirror/shadow depth without another copy.
+// Observation cost per pass is a single slot lookup; classification/publication runs once per present.
+
+enum class depth_class : uint32_t
+{
+    unknown = 0,
+    main,
+    mirror, // mirror / reflection camera: color-paired, smaller than the backbuffer
+    shadow, // depth-only passes, square power-of-two
+    count
+};
+static const char *const k_depth_class_names[static_cast<uint32_t>(depth_class::count)] = {
+    "unknown", "main", "mirror", "shadow",
+};
+
+struct depth_class_slot
+{
+    resource res;
+    resource_view dsv;
+    uint32_t w;
+    uint32_t h;
+    uint32_t samples;
+    format fmt;
+    bool frame_seen;
+    bool frame_color;      // bound with at least one color RT this frame
+    bool frame_depth_only; // bound without color RTs this frame
+    bool frame_bb_paired;  // bound with the backbuffer (or a backbuffer-sized RT) this frame
+    bool frame_cleared;
+    uint32_t frames_seen;
+    uint32_t color_frames;
+    uint32_t depth_only_frames;
+    uint32_t bb_frames;
+    uint32_t clear_only_frames;
+    depth_class cls;
+    bool decided;
+};
+static constexpr uint32_t k_depth_class_slots = 8;
+static constexpr uint32_t k_depth_class_min_frames = 8;
+static depth_class_slot g_depth_class_table[k_depth_class_slots] = {};
+static depth_class_slot *g_depth_class_last = nullptr; // last hit; consecutive passes usually share a DS
+static uint32_t g_depth_class_epoch = 0;
+static std::atomic_bool g_enable_depth_classes(true);
+
+// Published secondary depths; indices are depth_class values, bit (1 << class) is the view cache pin.
+static constexpr const char *k_depth_class_semantics[static_cast<uint32_t>(depth_class::count)] = {
+    nullptr, nullptr, "NFSTWEAK_DEPTH_MIRROR", "NFSTWEAK_DEPTH_SHADOW",
+};
+static resource g_depth_class_bound_res[static_cast<uint32_t>(depth_class::count)] = {};
+static resource_view g_depth_class_bound_view[static_cast<uint32_t>(depth_class::count)] = {};
+static std::atomic_uint64_t g_depth_class_binding_updates(0);
+
+static void clear_depth_class_table()
+{
+    for (uint32_t i = 0; i < k_depth_class_slots; ++i)
+        g_depth_class_table[i] = {};
+    g_depth_class_last = nullptr;
+}
+
+static depth_class_slot *depth_class_find_or_insert(resource res)
+{
+    if (g_depth_class_last != nullptr && g_depth_class_last->res.handle == res.handle)
+        return g_depth_class_last;
+
+    depth_class_slot *victim = nullptr;
+    for (uint32_t i = 0; i < k_depth_class_slots; ++i)
+    {
+        depth_class_slot &s = g_depth_class_table[i];
+        if (s.res.handle == res.handle)
+            return g_depth_class_last = &s;
+        // Prefer empty slots, then the least seen one that is not currently published.
+        if (s.res.handle == 0)
+        {
+            if (victim == nullptr || victim->res.handle != 0)
+                victim = &s;
+            continue;
+        }
+        bool published = s.res.handle == g_runtime_depth_resource.handle;
+        for (uint32_t c = 0; c < static_cast<uint32_t>(depth_class::count); ++c)
+            published = published || s.res.handle == g_depth_class_bound_res[c].handle;
+        if (published)
+            continue;
+        if (victim == nullptr || (victim->res.handle != 0 && s.frames_seen < victim->frames_seen))
+            victim = &s;
+    }
+    if (victim == nullptr)
+        return nullptr;
+
+    const resource_desc desc = g_device->get_resource_desc(res);
+    if (desc.type != resource_type::texture_2d)
+        return nullptr;
+    *victim = {};
+    victim->res = res;
+    victim->w = desc.texture.width;
+    victim->h = desc.texture.height;
+    victim->samples = desc.texture.samples;
+    return g_depth_class_last = victim;
+}
+
+// Records one bind/begin-pass/clear of 'dsv'. 'bb_paired' mirrors the RT score (>= 600) of the caller.
+static void depth_class_observe(resource_view dsv, bool has_color, bool bb_paired, bool cleared)
+{
+    if (dsv.handle == 0 || g_device == nullptr || !g_enable_depth_classes.load(std::memory_order_relaxed))
+        return;
+    const resource res = g_device->get_resource_from_view(dsv);
+    if (res.handle == 0)
+        return;
+    depth_class_slot *const s = depth_class_find_or_insert(res);
+    if (s == nullptr)
+        return;
+    if (s->dsv.handle != dsv.handle)
+    {
+        s->dsv = dsv;
+        s->fmt = g_device->get_resource_view_desc(dsv).format;
+    }
+    s->frame_seen = true;
+    if (cleared)
+    {
+        s->frame_cleared = true;
+        return;
+    }
+    s->frame_color = s->frame_color || has_color;
+    s->frame_depth_only = s->frame_depth_only || !has_color;
+    s->frame_bb_paired = s->frame_bb_paired || bb_paired;
+}
+
+static bool depth_format_has_stencil(format fmt)
+{
+    switch (format_to_typeless(fmt))
+    {
+    case format::r24_g8_typeless:
+    case format::r32_g8_typeless:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static depth_class classify_depth_slot(const depth_class_slot &s, uint32_t bb_w, uint32_t bb_h)
+{
+    if (s.res.handle == g_runtime_depth_resource.handle)
+        return depth_class::main;
+    const uint32_t n = s.frames_seen;
+    // Cleared but never rendered to: nothing worth sampling.
+    if (s.clear_only_frames * 2 > n)
+        return depth_class::unknown;
+
+    const bool bb_sized = s.w == bb_w && s.h == bb_h;
+    const bool square = s.w == s.h;
+    const bool pow2 = s.w != 0 && (s.w & (s.w - 1)) == 0 && s.h != 0 && (s.h & (s.h - 1)) == 0;
+    if (s.depth_only_frames * 2 > n && !bb_sized)
+    {
+        // Shadow maps: depth-only, square power-of-two, usually without stencil.
+        const uint32_t votes = (square ? 1u : 0u) + (pow2 ? 1u : 0u) + (depth_format_has_stencil(s.fmt) ? 0u : 1u);
+        if (votes >= 2)
+            return depth_class::shadow;
+    }
+    if (s.color_frames * 2 > n && s.bb_frames * 2 <= n && !bb_sized &&
+        static_cast<uint64_t>(s.w) * s.h < static_cast<uint64_t>(bb_w) * bb_h)
+        return depth_class::mirror;
+    return depth_class::unknown;
+}
+
+static void bind_depth_class_view(depth_class cls, resource res, resource_view view)
+{
+    const uint32_t c = static_cast<uint32_t>(cls);
+    if (g_runtime == nullptr || k_depth_class_semantics[c] == nullptr || view.handle == g_depth_class_bound_view[c].handle)
+        return;
+    g_runtime->update_texture_bindings(k_depth_class_semantics[c], view, view);
+    depth_view_cache_set_pin(g_depth_class_bound_view[c], 1u << c, false);
+    depth_view_cache_set_pin(view, 1u << c, true);
+    g_depth_class_bound_res[c] = res;
+    g_depth_class_bound_view[c] = view;
+    g_depth_class_binding_updates.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Called once per present: fold this frame's flags, tag new slots and publish the winners per class.
+static void update_depth_classes()
+{
+    if (g_device == nullptr || g_runtime == nullptr || !g_enable_depth_classes.load(std::memory_order_relaxed))
+        return;
+    const uint32_t epoch = g_phase_epoch.load(std::memory_order_relaxed);
+    if (epoch != g_depth_class_epoch)
+    {
+        // Keep published views across the transition; they are replaced once the new epoch decides.
+        clear_depth_class_table();
+        g_depth_class_epoch = epoch;
+        return;
+    }
+
+    const resource_desc back_desc = g_device->get_resource_desc(g_runtime->get_current_back_buffer());
+    const depth_class_slot *best[static_cast<uint32_t>(depth_class::count)] = {};
+    for (uint32_t i = 0; i < k_depth_class_slots; ++i)
+    {
+        depth_class_slot &s = g_depth_class_table[i];
+        if (s.res.handle == 0)
+            continue;
+        if (s.frame_seen)
+        {
+            ++s.frames_seen;
+            s.color_frames += s.frame_color ? 1u : 0u;
+            s.depth_only_frames += s.frame_depth_only ? 1u : 0u;
+            s.bb_frames += s.frame_bb_paired ? 1u : 0u;
+            s.clear_only_frames += (s.frame_cleared && !s.frame_color && !s.frame_depth_only) ? 1u : 0u;
+        }
+        s.frame_seen = s.frame_color = s.frame_depth_only = s.frame_bb_paired = s.frame_cleared = false;
+
+        // Tag once per epoch; the main depth may change through the candidate table at any time.
+        if (!s.decided && s.frames_seen >= k_depth_class_min_frames)
+        {
+            s.cls = classify_depth_slot(s, back_desc.texture.width, back_desc.texture.height);
+            s.decided = true;
+        }
+        if (s.decided && s.cls != depth_class::main && s.res.handle == g_runtime_depth_resource.handle)
+            s.cls = depth_class::main;
+        if (!s.decided || s.samples > 1)
+            continue;
+
+        // Most frequently seen slot wins; the published one wins ties to avoid rebinding.
+        const uint32_t c = static_cast<uint32_t>(s.cls);
+        const depth_class_slot *const cur = best[c];
+        if (cur == nullptr || s.frames_seen > cur->frames_seen ||
+            (s.frames_seen == cur->frames_seen && s.res.handle == g_depth_class_bound_res[c].handle))
+            best[c] = &s;
+    }
+
+    for (uint32_t c = static_cast<uint32_t>(depth_class::mirror); c < static_cast<uint32_t>(depth_class::count); ++c)
+    {
+        const depth_class_slot *const s = best[c];
+        if (s == nullptr || s->res.handle == g_depth_class_bound_res[c].handle)
+            continue;
+        // Keep the live runtime SRV: with the snapshot active it is not the bound view, but it is rebound when the
+        // snapshot is switched off and reused as-is while the same depth stays selected.
+        const resource_view view = depth_view_cache_acquire(g_device, s->res, g_device->get_resource_view_desc(s->dsv), g_runtime_depth_srv);
+        if (view.handle == 0)
+            continue;
+        bind_depth_class_view(static_cast<depth_class>(c), s->res, view);
+
+        char msg[192] = {};
+        sprintf_s(msg, "NFSTweakBridge: Published %s depth as %s (res=%llu %ux%u).\n",
+            k_depth_class_names[c], k_depth_class_semantics[c],
+            static_cast<unsigned long long>(s->res.handle), s->w, s->h);
+        log_info(msg);
+    }
+}
+
+// The app is destroying 'res': unbind any class published from it before its cached views go away.
+static void depth_class_on_destroy_resource(resource res)
+{
+    for (uint32_t i = 0; i < k_depth_class_slots; ++i)
+    {
+        if (g_depth_class_table[i].res.handle == res.handle)
+        {
+            if (g_depth_class_last == &g_depth_class_table[i])
+                g_depth_class_last = nullptr;
+            g_depth_class_table[i] = {};
+        }
+    }
+    for (uint32_t c = 0; c < static_cast<uint32_t>(depth_class::count); ++c)
+    {
+        if (g_depth_class_bound_res[c].handle != res.handle)
+            continue;
+        if (g_runtime != nullptr && k_depth_class_semantics[c] != nullptr)
+            g_runtime->update_texture_bindings(k_depth_class_semantics[c], resource_view { 0 }, resource_view { 0 });
+        depth_view_cache_set_pin(g_depth_class_bound_view[c], 1u << c, false);
+        g_depth_class_bound_res[c] = { 0 };
+        g_depth_class_bound_view[c] = { 0 };
+    }
+}
+
+static void reset_depth_classes()
+{
+    clear_depth_class_table();
+    for (uint32_t c = 0; c < static_cast<uint32_t>(depth_class::count); ++c)
+    {
+        g_depth_class_bound_res[c] = { 0 };
+        g_depth_class_bound_view[c] = { 0 };
+    }
+    g_depth_class_epoch = 0;
+}
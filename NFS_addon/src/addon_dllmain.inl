@@ -1,9 +1,34 @@
-BOOL APIENTRY DllMain(HMODULE hModule, DWORD reason, LPVOID)
+extern "C" __declspec(dllexport)
+const NFSTweakInterfaceV1 *NFSTweak_GetInterface(unsigned int version)
+{
+    if (version == 0 || version > NFSTWEAK_INTERFACE_VERSION)
+        return nullptr;
+    static const NFSTweakInterfaceV1 s_interface = {
+        NFSTWEAK_INTERFACE_VERSION,
+        sizeof(NFSTweakInterfaceV1),
+        NFSTweak_PushDepthSurface,
+        NFSTweak_PushDepthBufferR32F,
+        NFSTweak_RequestPreHudEffects,
+        NFSTweak_BeginPreHudWindow,
+        NFSTweak_EndPreHudWindow,
+        NFSTweak_BeginPreHudWindowEx,
+        NFSTweak_EndPreHudWindowEx,
+        NFSTweak_NotifyPrecipitationChanged,
+        NFSTweak_NotifyPhaseInvalidate,
+        NFSTweak_NotifyPhaseInvalidateEx,
+        NFSTweak_PushCameraState,
+        NFSTweak_MarkTimelineEvent,
+    };
+    return &s_interface;
+}
+
+BOOL APIENTRY DllMain(HMODULE hModule, DWORD reason, LPVOID reserved)
 {
     if (reason == DLL_PROCESS_ATTACH)
     {
         if (!reshade::register_addon(hModule))
             return FALSE;
+        open_trace_flight_recorder();
 
         // Register lifecycle events
         reshade::register_event<reshade::addon_event::init_effect_runtime>(on_init_effect_runtime);
@@ -13,6 +38,7 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD reason, LPVOID)
         reshade::register_event<reshade::addon_event::bind_render_targets_and_depth_stencil>(on_bind_render_targets_and_depth_stencil);
         reshade::register_event<reshade::addon_event::begin_render_pass>(on_begin_render_pass);
         reshade::register_event<reshade::addon_event::clear_depth_stencil_view>(on_clear_depth_stencil_view);
+        reshade::register_event<reshade::addon_event::destroy_resource>(on_destroy_resource);
         reshade::register_event<reshade::addon_event::reshade_reloaded_effects>(on_reshade_reloaded_effects);
         reshade::register_event<reshade::addon_event::reshade_begin_effects>(on_reshade_begin_effects);
         reshade::register_event<reshade::addon_event::reshade_finish_effects>(on_reshade_finish_effects);
@@ -21,6 +47,10 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD reason, LPVOID)
         reshade::register_event<reshade::addon_event::dispatch>(on_dispatch_block_effects);
         reshade::register_event<reshade::addon_event::draw_or_dispatch_indirect>(on_draw_or_dispatch_indirect_block_effects);
     }
+    else if (reason == DLL_THREAD_DETACH)
+    {
+        trace_release_thread_ring();
+    }
     else if (reason == DLL_PROCESS_DETACH)
     {
         reshade::unregister_event<reshade::addon_event::present>(on_present);
@@ -30,6 +60,7 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD reason, LPVOID)
         reshade::unregister_event<reshade::addon_event::bind_render_targets_and_depth_stencil>(on_bind_render_targets_and_depth_stencil);
         reshade::unregister_event<reshade::addon_event::begin_render_pass>(on_begin_render_pass);
         reshade::unregister_event<reshade::addon_event::clear_depth_stencil_view>(on_clear_depth_stencil_view);
+        reshade::unregister_event<reshade::addon_event::destroy_resource>(on_destroy_resource);
         reshade::unregister_event<reshade::addon_event::reshade_reloaded_effects>(on_reshade_reloaded_effects);
         reshade::unregister_event<reshade::addon_event::reshade_begin_effects>(on_reshade_begin_effects);
         reshade::unregister_event<reshade::addon_event::reshade_finish_effects>(on_reshade_finish_effects);
@@ -38,6 +69,7 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD reason, LPVOID)
         reshade::unregister_event<reshade::addon_event::dispatch>(on_dispatch_block_effects);
         reshade::unregister_event<reshade::addon_event::draw_or_dispatch_indirect>(on_draw_or_dispatch_indirect_block_effects);
         reshade::unregister_addon(hModule);
+        close_trace_flight_recorder(reserved != nullptr);
     }
     return TRUE;
 }
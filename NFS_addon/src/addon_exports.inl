@@ -72,20 +72,20 @@ static std::atomic_uint64_t g_null_rtv_burst_last_frame(0);
 static std::atomic_int g_null_rtv_burst_count(0);
 static std::atomic_uint64_t g_manual_prehud_cooldown_until_frame(0);
 
-struct prehud_trace_entry
-{
-    uint64_t frame;
-    uint64_t bp;
-    uint64_t rtv;
-    uint64_t dsv;
-    uint32_t score;
-    uint32_t token;
-    uint32_t reason;
-    uint32_t kind; // 1=render, 2=skip, 3=transition
-};
-static constexpr uint32_t k_prehud_trace_capacity = 512;
-static prehud_trace_entry g_prehud_trace[k_prehud_trace_capacity] = {};
-static std::atomic_uint32_t g_prehud_trace_write(0);
+// Pre-HUD render invariants (checked on every successful manual render, both paths).
+// Violations are counted, traced (kind=4) and shown in the overlay; they never block rendering.
+static constexpr uint32_t k_prehud_invariant_double_frame = 0x01;  // second render in the same frame
+static constexpr uint32_t k_prehud_invariant_double_token = 0x02;  // second render for the same token (bind path)
+static constexpr uint32_t k_prehud_invariant_unlocked_pair = 0x04; // render on a non-locked RT/DS pair while the lock is frozen
+// Lowest RT score either selector accepts for a pair other than the locked one (full-resolution RT).
+static constexpr uint32_t k_prehud_min_unlocked_score = 600;
+static std::atomic_uint64_t g_prehud_invariant_checks(0);
+static std::atomic_uint64_t g_prehud_invariant_double_frame(0);
+static std::atomic_uint64_t g_prehud_invariant_double_token(0);
+static std::atomic_uint64_t g_prehud_invariant_unlocked_pair(0);
+static std::atomic_uint64_t g_prehud_invariant_last_frame(0);
+static std::atomic_uint32_t g_prehud_invariant_last_token(0);
+static std::atomic_uint32_t g_prehud_invariant_last_epoch(0);
 
 static unsigned int g_last_width = 0, g_last_height = 0;
 
@@ -139,19 +139,51 @@ static std::atomic_bool g_require_vulkan_backbuffer_rt(false);
 static std::atomic_bool g_lock_vulkan_depth(false);
 static uint32_t g_vulkan_depth_last_score = 0;
 
-// Optional resolved depth path for MSAA depth buffers.
-static resource g_vulkan_depth_resolved = { 0 };
-static resource_view g_vulkan_depth_resolved_srv = { 0 };
-static uint32_t g_vulkan_depth_resolved_w = 0;
-static uint32_t g_vulkan_depth_resolved_h = 0;
-static format g_vulkan_depth_resolved_format = format::unknown;
-static std::atomic_bool g_enable_vulkan_msaa_resolve(false);
+// Per-epoch depth candidate table: per DS resource, per-frame observation folded into an exponentially
+// weighted mean/variance. Bound depth only switches when a challenger beats the incumbent by
+// k_depth_switch_sigma combined standard deviations plus k_depth_switch_margin.
+struct depth_candidate_slot
+{
+    resource res;
+    resource_view dsv;
+    uint32_t w;
+    uint32_t h;
+    uint32_t samples;
+    format fmt;
+    uint32_t frame_obs;        // best observation this frame (score + area bonus), 0 if not seen
+    uint32_t frame_hits;       // binds/clears seen this frame
+    uint32_t frame_first_pass; // beginpass ordinal (in frame) of first hit this frame
+    bool frame_paired;         // seen with a full-resolution/backbuffer RT this frame
+    float mean;
+    float var;
+    uint32_t frames_seen;
+    uint32_t paired_frames;
+    uint32_t last_first_pass;
+    uint64_t total_hits;
+};
+static constexpr uint32_t k_depth_candidate_slots = 8;
+static constexpr float k_depth_candidate_alpha = 0.125f;
+static constexpr float k_depth_switch_sigma = 2.0f;
+static constexpr float k_depth_switch_margin = 50.0f;
+static constexpr uint32_t k_depth_candidate_min_frames = 4;
+static depth_candidate_slot g_depth_candidates[k_depth_candidate_slots] = {};
+static uint32_t g_depth_candidate_epoch = 0;
+// Last challenger picked at present, for the overlay (the frame-best fields above restart every frame).
+static depth_candidate_slot g_depth_candidate_pick = {};
+static std::atomic_uint64_t g_depth_rebinds(0);
+static std::atomic_uint64_t g_depth_rebinds_avoided(0);
+
+// Resolve MSAA depth buffers at the pre-HUD point (see addon_prehud_depth.inl). On by default; it only takes effect on
+// devices with resolve_depth_stencil (g_msaa_resolve_supported) and on the bind path. A user's choice survives runtime
+// re-init.
+static std::atomic_bool g_enable_vulkan_msaa_resolve(true);
 static std::atomic_bool g_require_vulkan_backbuffer_match(false);
 
 // Forward decl
 static void ProcessPendingDepth();
 static void try_bind_vulkan_depth(resource_view dsv, uint32_t score_hint);
 static void bind_vulkan_candidate_if_good();
+static void bind_runtime_depth_view(resource_view view);
 static void reset_prehud_transition(const char *reason, int settle_frames, bool clear_lock = true)
 {
     g_transition_settle_frames.store(settle_frames, std::memory_order_relaxed);
@@ -335,6 +367,34 @@ void NFSTweak_NotifyPhaseInvalidateEx(unsigned int reason, unsigned int epoch)
     g_phase_invalidate_pending.store(true, std::memory_order_relaxed);
 }
 
+// Camera feed from the bridge: written on the game thread, consumed at present (see addon_camera.inl).
+static std::mutex g_camera_mutex;
+static NFSTweakCameraState g_camera_state = {};
+static NFSTweakCameraState g_camera_state_prev = {};
+static uint64_t g_camera_state_addon_frame = 0; // g_frame_index when g_camera_state was last pushed
+static std::atomic_uint64_t g_camera_push_count(0);
+static std::atomic_uint64_t g_camera_push_rejected(0);
+
+extern "C" __declspec(dllexport)
+void NFSTweak_PushCameraState(const NFSTweakCameraState *state)
+{
+    if (!g_runtime_alive.load(std::memory_order_relaxed) || state == nullptr)
+        return;
+    if (state->version != NFSTWEAK_CAMERA_STATE_VERSION || state->size < sizeof(NFSTweakCameraState))
+    {
+        g_camera_push_rejected.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(g_camera_mutex);
+    // Same bridge frame pushed again: refresh the sample, keep the previous-frame one.
+    if (g_camera_state.frame != state->frame || g_camera_push_count.load(std::memory_order_relaxed) == 0)
+        g_camera_state_prev = g_camera_state;
+    g_camera_state = *state;
+    g_camera_state_addon_frame = g_frame_index.load(std::memory_order_relaxed);
+    g_camera_push_count.fetch_add(1, std::memory_order_relaxed);
+}
+
 extern "C" __declspec(dllexport)
 void NFSTweak_RenderEffectsPreHudNow()
 {
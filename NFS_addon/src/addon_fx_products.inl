@@ -0,0 +1,244 @@
+// ---------- Shared FX products (Hi-Z, normals, camera motion) ----------
+// Hidden techniques shipped in shaders/ are rendered once per frame on the pre-HUD command list, right
+// after the depth snapshot and before render_effects (bind path only, like the snapshot they read). Their output textures are copied into addon-owned
+// textures published under NFSTWEAK_* semantics, so every effect shares one result and the binding
+// survives effect reloads (technique/texture handles are re-resolved after each reload).
+
+static constexpr uint32_t k_fx_product_max_levels = 8;
+
+struct fx_product
+{
+    const char *effect_file;                              // as listed by ReShade, e.g. "NFSTweak_HiZ.fx"
+    const char *technique;
+    const char *semantic;
+    const char *level_textures[k_fx_product_max_levels]; // copied into mip N of the published texture
+    uint32_t level_count;
+    uint32_t timer_scope;
+    std::atomic_bool *enabled;
+    bool requires_camera;                                 // skipped unless the published camera flags are valid
+
+    // Resolved per effect reload.
+    effect_technique tech = {};
+    resource level_res[k_fx_product_max_levels] = {};
+    bool resolved = false;
+    bool missing_logged = false;
+
+    // Addon-owned published copy.
+    resource out = {};
+    resource_view out_srv = {};
+    resource_view out_rtv = {};                           // level 0, camera products only (cleared while skipped)
+    bool out_cleared = false;
+    uint32_t out_w = 0;
+    uint32_t out_h = 0;
+    format out_fmt = format::unknown;
+    uint64_t runs = 0;
+};
+
+static std::atomic_bool g_enable_fx_hiz(true);
+static std::atomic_bool g_enable_fx_normals(true);
+static std::atomic_bool g_enable_fx_motion(true);
+
+static fx_product g_fx_products[] = {
+    { "NFSTweak_HiZ.fx", "NFSTweak_HiZ", "NFSTWEAK_DEPTH_HIZ",
+        { "NFSTweak_HiZ0", "NFSTweak_HiZ1", "NFSTweak_HiZ2", "NFSTweak_HiZ3", "NFSTweak_HiZ4", "NFSTweak_HiZ5" }, 6,
+        k_timer_fx_hiz, &g_enable_fx_hiz, false },
+    // Runs after Hi-Z; both only read NFSTWEAK_DEPTH (the snapshot).
+    { "NFSTweak_Normals.fx", "NFSTweak_Normals", "NFSTWEAK_NORMALS",
+        { "NFSTweak_NormalsTex" }, 1,
+        k_timer_fx_normals, &g_enable_fx_normals, false },
+    // Uses the camera uniforms published at the start of prepare_prehud_depth(); reprojecting without a valid camera
+    // produces garbage, so it is skipped then and the published texture cleared to zero motion.
+    { "NFSTweak_Motion.fx", "NFSTweak_Motion", "NFSTWEAK_MOTION",
+        { "NFSTweak_MotionTex" }, 1,
+        k_timer_fx_motion, &g_enable_fx_motion, true },
+};
+static constexpr uint32_t k_fx_product_count = static_cast<uint32_t>(sizeof(g_fx_products) / sizeof(g_fx_products[0]));
+
+// Effect handles die with a reload; the published textures stay bound and are refilled next frame.
+static void invalidate_fx_products()
+{
+    for (uint32_t i = 0; i < k_fx_product_count; ++i)
+    {
+        fx_product &p = g_fx_products[i];
+        p.tech = { 0 };
+        for (uint32_t l = 0; l < k_fx_product_max_levels; ++l)
+            p.level_res[l] = { 0 };
+        p.resolved = false;
+    }
+}
+
+static void destroy_fx_products()
+{
+    for (uint32_t i = 0; i < k_fx_product_count; ++i)
+    {
+        fx_product &p = g_fx_products[i];
+        if (g_device != nullptr)
+        {
+            if (p.out_rtv.handle != 0)
+                g_device->destroy_resource_view(p.out_rtv);
+            if (p.out_srv.handle != 0)
+                g_device->destroy_resource_view(p.out_srv);
+            if (p.out.handle != 0)
+                g_device->destroy_resource(p.out);
+        }
+        p.out = { 0 };
+        p.out_srv = { 0 };
+        p.out_rtv = { 0 };
+        p.out_cleared = false;
+        p.out_w = 0;
+        p.out_h = 0;
+        p.out_fmt = format::unknown;
+        p.missing_logged = false;
+    }
+    invalidate_fx_products();
+}
+
+static bool resolve_fx_product(fx_product &p)
+{
+    if (p.resolved)
+        return p.tech.handle != 0;
+    p.resolved = true;
+    p.tech = g_runtime->find_technique(p.effect_file, p.technique);
+    bool ok = p.tech.handle != 0;
+    for (uint32_t l = 0; ok && l < p.level_count; ++l)
+    {
+        const effect_texture_variable var = g_runtime->find_texture_variable(p.effect_file, p.level_textures[l]);
+        resource_view srv = { 0 }, srv_srgb = { 0 };
+        if (var.handle != 0)
+            g_runtime->get_texture_binding(var, &srv, &srv_srgb);
+        p.level_res[l] = srv.handle != 0 ? g_device->get_resource_from_view(srv) : resource { 0 };
+        ok = p.level_res[l].handle != 0;
+    }
+    if (!ok)
+    {
+        p.tech = { 0 };
+        if (!p.missing_logged)
+        {
+            p.missing_logged = true;
+            char msg[256] = {};
+            sprintf_s(msg, "NFSTweakBridge: %s/%s not loaded; %s unavailable (copy shaders/%s to the ReShade shader path).\n",
+                p.effect_file, p.technique, p.semantic, p.effect_file);
+            log_info(msg);
+        }
+        return false;
+    }
+    p.missing_logged = false;
+    return true;
+}
+
+// (Re)creates the published texture to match level 0 of the technique output; returns false on failure.
+static bool ensure_fx_product_output(fx_product &p, const resource_desc &level0)
+{
+    if (p.out.handle != 0 && p.out_w == level0.texture.width && p.out_h == level0.texture.height && p.out_fmt == level0.texture.format)
+        return true;
+
+    resource_desc desc = {};
+    desc.type = resource_type::texture_2d;
+    desc.texture.width = level0.texture.width;
+    desc.texture.height = level0.texture.height;
+    desc.texture.depth_or_layers = 1;
+    desc.texture.levels = static_cast<uint16_t>(p.level_count);
+    desc.texture.format = level0.texture.format;
+    desc.texture.samples = 1;
+    desc.usage = resource_usage::copy_dest | resource_usage::shader_resource;
+    if (p.requires_camera)
+        desc.usage |= resource_usage::render_target;
+
+    resource res = { 0 };
+    resource_view srv = { 0 };
+    resource_view rtv = { 0 };
+    if (!g_device->create_resource(desc, nullptr, resource_usage::shader_resource, &res) ||
+        !g_device->create_resource_view(res, resource_usage::shader_resource,
+            resource_view_desc(resource_view_type::texture_2d, desc.texture.format, 0, p.level_count, 0, 1), &srv) ||
+        (p.requires_camera && !g_device->create_resource_view(res, resource_usage::render_target,
+            resource_view_desc(resource_view_type::texture_2d, desc.texture.format, 0, 1, 0, 1), &rtv)))
+    {
+        if (srv.handle != 0)
+            g_device->destroy_resource_view(srv);
+        if (res.handle != 0)
+            g_device->destroy_resource(res);
+        char msg[192] = {};
+        sprintf_s(msg, "NFSTweakBridge: Failed to create %s texture %ux%u.\n", p.semantic, desc.texture.width, desc.texture.height);
+        log_info(msg);
+        return false;
+    }
+
+    // Publish the new view before destroying the old one.
+    g_runtime->update_texture_bindings(p.semantic, srv, srv);
+    if (p.out_rtv.handle != 0)
+        g_device->destroy_resource_view(p.out_rtv);
+    if (p.out_srv.handle != 0)
+        g_device->destroy_resource_view(p.out_srv);
+    if (p.out.handle != 0)
+        g_device->destroy_resource(p.out);
+    p.out = res;
+    p.out_srv = srv;
+    p.out_rtv = rtv;
+    p.out_cleared = false;
+    p.out_w = desc.texture.width;
+    p.out_h = desc.texture.height;
+    p.out_fmt = desc.texture.format;
+
+    char msg[192] = {};
+    sprintf_s(msg, "NFSTweakBridge: Publishing %s (%ux%u, %u levels).\n", p.semantic, p.out_w, p.out_h, p.level_count);
+    log_info(msg);
+    return true;
+}
+
+// The published texture stays bound while a product is skipped; zero it once so effects do not keep sampling the last
+// valid frame's output.
+static void clear_fx_product_output(fx_product &p, command_list *cmd_list)
+{
+    if (p.out_rtv.handle == 0 || p.out_cleared)
+        return;
+    static const float k_zero[4] = {};
+    cmd_list->barrier(p.out, resource_usage::shader_resource, resource_usage::render_target);
+    cmd_list->clear_render_target_view(p.out_rtv, k_zero);
+    cmd_list->barrier(p.out, resource_usage::render_target, resource_usage::shader_resource);
+    p.out_cleared = true;
+}
+
+static void run_fx_product(fx_product &p, command_list *cmd_list, resource_view rtv, uint64_t frame)
+{
+    if (!p.enabled->load(std::memory_order_relaxed))
+        return;
+    if (p.requires_camera && (g_camera_uniforms_published_flags & NFSTWEAK_CAMERA_VALID) == 0)
+    {
+        clear_fx_product_output(p, cmd_list);
+        return;
+    }
+    if (!resolve_fx_product(p))
+        return;
+    const resource_desc level0 = g_device->get_resource_desc(p.level_res[0]);
+    if (!ensure_fx_product_output(p, level0))
+        return;
+
+    timer_begin(cmd_list, p.timer_scope, frame);
+    g_runtime->render_technique(p.tech, cmd_list, rtv, rtv);
+
+    // Effect textures rest in shader_resource state between passes.
+    cmd_list->barrier(p.out, resource_usage::shader_resource, resource_usage::copy_dest);
+    for (uint32_t l = 0; l < p.level_count; ++l)
+    {
+        const resource src = p.level_res[l];
+        const resource_desc src_desc = l == 0 ? level0 : g_device->get_resource_desc(src);
+        if (src_desc.texture.width != std::max(1u, p.out_w >> l) || src_desc.texture.height != std::max(1u, p.out_h >> l))
+            break;
+        cmd_list->barrier(src, resource_usage::shader_resource, resource_usage::copy_source);
+        cmd_list->copy_texture_region(src, 0, nullptr, p.out, l, nullptr);
+        cmd_list->barrier(src, resource_usage::copy_source, resource_usage::shader_resource);
+    }
+    cmd_list->barrier(p.out, resource_usage::copy_dest, resource_usage::shader_resource);
+    timer_end(cmd_list, p.timer_scope, frame);
+    p.out_cleared = false;
+    ++p.runs;
+}
+
+// Not inside the game's render pass: render_technique begins its own passes and the copies need barriers.
+static void run_fx_products(command_list *cmd_list, resource_view rtv, uint64_t frame, bool in_render_pass)
+{
+    if (in_render_pass || g_runtime == nullptr || rtv.handle == 0 || g_bound_runtime_depth_view.handle == 0)
+        return;
+    for (uint32_t i = 0; i < k_fx_product_count; ++i)
+        run_fx_product(g_fx_products[i], cmd_list, rtv, frame);
+}
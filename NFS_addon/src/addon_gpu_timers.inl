@@ -0,0 +1,100 @@
+// ---------- Pre-HUD cost timers ----------
+// GPU timestamps (query heap ring, read back a few frames later without waiting) and CPU QPC per scope.
+// Values are exponentially smoothed for the overlay.
+
+enum prehud_timer_scope : uint32_t
+{
+    k_timer_prehud_depth = 0,   // whole prepare_prehud_depth()
+    k_timer_depth_snapshot,     // depth snapshot copies
+    k_timer_fx_hiz,             // NFSTweak_HiZ.fx technique + level copies
+    k_timer_fx_normals,         // NFSTweak_Normals.fx technique + copy
+    k_timer_fx_motion,          // NFSTweak_Motion.fx technique + copy
+    k_timer_prehud_effects,     // manual render_effects at the pre-HUD point
+    k_timer_scope_count
+};
+static const char *const k_timer_scope_names[k_timer_scope_count] = {
+    "prehud depth",
+    "depth snapshot",
+    "hi-z pyramid",
+    "normals",
+    "camera motion",
+    "pre-HUD effects",
+};
+
+static constexpr uint32_t k_gpu_timer_frames = 4; // frames in flight before a slot is read back
+static query_heap g_gpu_timer_heap = { 0 };
+static uint64_t g_gpu_timer_frequency = 0;
+static uint64_t g_gpu_timer_written_frame[k_gpu_timer_frames][k_timer_scope_count] = {};
+static float g_gpu_timer_ms[k_timer_scope_count] = {};
+static float g_cpu_timer_ms[k_timer_scope_count] = {};
+static uint64_t g_cpu_timer_begin_qpc[k_timer_scope_count] = {};
+
+static void smooth_timer_ms(float &value, double sample_ms)
+{
+    value = (value == 0.0f) ? static_cast<float>(sample_ms) : value + 0.1f * (static_cast<float>(sample_ms) - value);
+}
+
+static void init_gpu_timers(effect_runtime *runtime)
+{
+    if (g_device == nullptr || runtime == nullptr)
+        return;
+    command_queue *const queue = runtime->get_command_queue();
+    g_gpu_timer_frequency = queue != nullptr ? queue->get_timestamp_frequency() : 0;
+    if (g_gpu_timer_frequency == 0 ||
+        !g_device->create_query_heap(query_type::timestamp, k_gpu_timer_frames * k_timer_scope_count * 2, &g_gpu_timer_heap))
+    {
+        g_gpu_timer_heap = { 0 };
+        log_info("NFSTweakBridge: GPU timestamp queries unavailable; pre-HUD GPU timings disabled.\n");
+    }
+    memset(g_gpu_timer_written_frame, 0, sizeof(g_gpu_timer_written_frame));
+}
+
+static void destroy_gpu_timers()
+{
+    if (g_device != nullptr && g_gpu_timer_heap.handle != 0)
+        g_device->destroy_query_heap(g_gpu_timer_heap);
+    g_gpu_timer_heap = { 0 };
+    g_gpu_timer_frequency = 0;
+    memset(g_gpu_timer_written_frame, 0, sizeof(g_gpu_timer_written_frame));
+}
+
+static uint32_t gpu_timer_query_index(uint64_t frame, uint32_t scope)
+{
+    return ((static_cast<uint32_t>(frame % k_gpu_timer_frames) * k_timer_scope_count) + scope) * 2;
+}
+
+static void timer_begin(command_list *cmd_list, uint32_t scope, uint64_t frame)
+{
+    g_cpu_timer_begin_qpc[scope] = qpc_now();
+    if (g_gpu_timer_heap.handle != 0 && cmd_list != nullptr)
+        cmd_list->end_query(g_gpu_timer_heap, query_type::timestamp, gpu_timer_query_index(frame, scope));
+}
+
+static void timer_end(command_list *cmd_list, uint32_t scope, uint64_t frame)
+{
+    smooth_timer_ms(g_cpu_timer_ms[scope], qpc_to_ms(qpc_now() - g_cpu_timer_begin_qpc[scope]));
+    if (g_gpu_timer_heap.handle != 0 && cmd_list != nullptr)
+    {
+        cmd_list->end_query(g_gpu_timer_heap, query_type::timestamp, gpu_timer_query_index(frame, scope) + 1);
+        g_gpu_timer_written_frame[frame % k_gpu_timer_frames][scope] = frame;
+    }
+}
+
+// Called once per present: read the oldest slot (written k_gpu_timer_frames - 1 frames ago) if it is ready.
+static void collect_gpu_timers(uint64_t frame)
+{
+    if (g_device == nullptr || g_gpu_timer_heap.handle == 0 || g_gpu_timer_frequency == 0)
+        return;
+    const uint64_t slot_frame = frame + 1;
+    const uint32_t slot = static_cast<uint32_t>(slot_frame % k_gpu_timer_frames);
+    for (uint32_t scope = 0; scope < k_timer_scope_count; ++scope)
+    {
+        const uint64_t written = g_gpu_timer_written_frame[slot][scope];
+        if (written == 0)
+            continue;
+        uint64_t ts[2] = {};
+        if (g_device->get_query_heap_results(g_gpu_timer_heap, gpu_timer_query_index(written, scope), 2, ts, sizeof(uint64_t)) && ts[1] >= ts[0])
+            smooth_timer_ms(g_gpu_timer_ms[scope], (static_cast<double>(ts[1] - ts[0]) * 1000.0) / static_cast<double>(g_gpu_timer_frequency));
+        g_gpu_timer_written_frame[slot][scope] = 0;
+    }
+}
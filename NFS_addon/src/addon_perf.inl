@@ -0,0 +1,160 @@
+// ---------- Add-on cost dashboard ----------
+// Always-on CPU cost of the hot callbacks: each call adds its QPC delta to a per-frame accumulator, present closes the
+// frame into a 600-frame sliding window backed by a fixed log-linear histogram per scope (percentiles without sorting).
+// Also keeps the frame-time history for the overlay graph and per-second rates of a few resource counters.
+
+enum perf_scope : uint32_t
+{
+    k_perf_bind = 0,           // bind_render_targets_and_depth_stencil
+    k_perf_begin_render_pass,
+    k_perf_present,            // lands in the following frame's sample (the frame is closed inside present)
+    k_perf_begin_effects,      // reshade_begin_effects
+    k_perf_process_depth,      // ProcessPendingDepth
+    k_perf_scope_count
+};
+static const char *const k_perf_scope_names[k_perf_scope_count] = {
+    "bind RT/DS",
+    "begin_render_pass",
+    "present",
+    "begin_effects",
+    "ProcessPendingDepth",
+};
+
+enum perf_rate : uint32_t
+{
+    k_rate_depth_upload_bytes = 0,
+    k_rate_view_creations,     // depth view cache misses (every miss creates a view)
+    k_rate_binding_updates,
+    k_rate_count
+};
+
+// Buckets: exact below 8 us, then 4 per power of two (<= 12.5% wide) up to 2^21 us; the last bucket is open-ended.
+static constexpr uint32_t k_perf_linear_buckets = 8;
+static constexpr uint32_t k_perf_buckets = k_perf_linear_buckets + (20 - 3 + 1) * 4 + 1;
+static constexpr uint32_t k_perf_window = 600;
+
+struct perf_window_histogram
+{
+    uint16_t buckets[k_perf_buckets];
+    uint8_t samples[k_perf_window]; // bucket index per frame, ring
+    uint32_t count;
+    uint32_t last_us;
+};
+
+static std::atomic_uint64_t g_perf_frame_ticks[k_perf_scope_count] = {};
+static std::atomic_uint32_t g_perf_frame_calls[k_perf_scope_count] = {};
+static std::atomic_uint64_t g_depth_upload_bytes(0); // ProcessPendingDepth texture uploads
+
+// Present-thread only from here on (closed in on_present, read by the overlay inside present).
+static perf_window_histogram g_perf_hist[k_perf_scope_count] = {};
+static uint32_t g_perf_last_calls[k_perf_scope_count] = {};
+static uint32_t g_perf_window_pos = 0;
+static float g_perf_frame_ms[k_perf_window] = {}; // same ring position as the histograms
+static uint64_t g_perf_last_present_qpc = 0;
+static uint64_t g_perf_rate_qpc = 0;
+static uint64_t g_perf_rate_base[k_rate_count] = {};
+static double g_perf_rate_per_s[k_rate_count] = {};
+
+static uint32_t perf_bucket(uint32_t us)
+{
+    if (us < k_perf_linear_buckets)
+        return us;
+    uint32_t exponent = 3;
+    while (exponent < 20 && (us >> (exponent + 1)) != 0)
+        ++exponent;
+    if ((us >> exponent) > 1) // >= 2^21
+        return k_perf_buckets - 1;
+    return k_perf_linear_buckets + (exponent - 3) * 4 + ((us >> (exponent - 2)) & 3);
+}
+
+// Largest value that maps to `bucket`.
+static uint32_t perf_bucket_upper_us(uint32_t bucket)
+{
+    if (bucket < k_perf_linear_buckets)
+        return bucket;
+    if (bucket >= k_perf_buckets - 1)
+        return 1u << 21;
+    const uint32_t exponent = 3 + (bucket - k_perf_linear_buckets) / 4;
+    const uint32_t sub = (bucket - k_perf_linear_buckets) % 4;
+    return (1u << exponent) + ((sub + 1) << (exponent - 2)) - 1;
+}
+
+static uint32_t perf_percentile_us(const perf_window_histogram &h, uint32_t pct)
+{
+    if (h.count == 0)
+        return 0;
+    const uint32_t target = (h.count * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (uint32_t b = 0; b < k_perf_buckets; ++b)
+    {
+        seen += h.buckets[b];
+        if (seen >= target)
+            return perf_bucket_upper_us(b);
+    }
+    return perf_bucket_upper_us(k_perf_buckets - 1);
+}
+
+static void perf_add(uint32_t scope, uint64_t begin_qpc)
+{
+    g_perf_frame_ticks[scope].fetch_add(qpc_now() - begin_qpc, std::memory_order_relaxed);
+    g_perf_frame_calls[scope].fetch_add(1, std::memory_order_relaxed);
+}
+
+struct perf_scope_timer
+{
+    explicit perf_scope_timer(uint32_t scope) : scope(scope), begin(qpc_now()) {}
+    ~perf_scope_timer() { perf_add(scope, begin); }
+    perf_scope_timer(const perf_scope_timer &) = delete;
+    perf_scope_timer &operator=(const perf_scope_timer &) = delete;
+    const uint32_t scope;
+    const uint64_t begin;
+};
+
+// Once per present. `counters` are the running totals behind the k_rate_* rates.
+static void perf_end_frame(const uint64_t (&counters)[k_rate_count])
+{
+    const uint64_t now = qpc_now();
+    const uint64_t freq = qpc_frequency();
+    const uint32_t pos = g_perf_window_pos;
+    for (uint32_t scope = 0; scope < k_perf_scope_count; ++scope)
+    {
+        const uint64_t ticks = g_perf_frame_ticks[scope].exchange(0, std::memory_order_relaxed);
+        g_perf_last_calls[scope] = g_perf_frame_calls[scope].exchange(0, std::memory_order_relaxed);
+        const uint64_t us = freq != 0 ? (ticks * 1000000ull) / freq : 0;
+        perf_window_histogram &h = g_perf_hist[scope];
+        if (h.count == k_perf_window)
+            --h.buckets[h.samples[pos]];
+        else
+            ++h.count;
+        h.last_us = us > 0xFFFFFFFFull ? 0xFFFFFFFFu : static_cast<uint32_t>(us);
+        h.samples[pos] = static_cast<uint8_t>(perf_bucket(h.last_us));
+        ++h.buckets[h.samples[pos]];
+    }
+    g_perf_frame_ms[pos] = g_perf_last_present_qpc != 0 ? static_cast<float>(qpc_to_ms(now - g_perf_last_present_qpc)) : 0.0f;
+    g_perf_last_present_qpc = now;
+    g_perf_window_pos = (pos + 1) % k_perf_window;
+
+    if (g_perf_rate_qpc == 0)
+    {
+        g_perf_rate_qpc = now;
+        memcpy(g_perf_rate_base, counters, sizeof(g_perf_rate_base));
+    }
+    else if (freq != 0 && now - g_perf_rate_qpc >= freq)
+    {
+        const double seconds = static_cast<double>(now - g_perf_rate_qpc) / static_cast<double>(freq);
+        for (uint32_t r = 0; r < k_rate_count; ++r)
+            g_perf_rate_per_s[r] = static_cast<double>(counters[r] - g_perf_rate_base[r]) / seconds;
+        g_perf_rate_qpc = now;
+        memcpy(g_perf_rate_base, counters, sizeof(g_perf_rate_base));
+    }
+}
+
+static void reset_perf_dashboard()
+{
+    memset(g_perf_hist, 0, sizeof(g_perf_hist));
+    memset(g_perf_frame_ms, 0, sizeof(g_perf_frame_ms));
+    memset(g_perf_rate_per_s, 0, sizeof(g_perf_rate_per_s));
+    g_perf_window_pos = 0;
+    g_perf_last_present_qpc = 0;
+    g_perf_rate_qpc = 0;
+}
@@ -0,0 +1,338 @@
+// ---------- Pre-HUD depth preparation ----------
+// Runs on the manual pre-HUD command list right before render_effects (both bind and beginpass paths),
+// i.e. after the scene has finished writing the locked DS and before HUD/FE passes touch it. The beginpass path runs
+// inside the game's render pass, where copies, resolves and their barriers are not allowed, so only the bind path
+// records them; the beginpass path binds the live depth view instead.
+
+// MSAA depth resolve: pooled single-sample targets per (size, format), one resolve per frame.
+struct msaa_resolve_target
+{
+    resource res;
+    resource_view srv;
+    uint32_t w;
+    uint32_t h;
+    format fmt;
+    uint64_t last_frame;
+};
+static constexpr uint32_t k_msaa_resolve_pool_size = 4;
+static msaa_resolve_target g_msaa_resolve_pool[k_msaa_resolve_pool_size] = {};
+static std::atomic_uint64_t g_msaa_resolve_frame(0);
+static std::atomic_uint64_t g_msaa_resolve_count(0);
+static std::atomic_uint64_t g_msaa_resolve_unsupported(0);
+static bool g_msaa_resolve_supported = false;
+static resource_view g_msaa_resolve_bound_srv = { 0 };
+static resource g_msaa_resolve_last_res = { 0 };
+
+// Depth snapshot: addon-owned single-sample copies of scene depth taken at the pre-HUD point (bind path only).
+// [0] = this frame (NFSTWEAK_DEPTH), [1] = previous frame (NFSTWEAK_DEPTH_PREV).
+// Later HUD/FE passes and clears can no longer change what effects sample.
+static constexpr const char *k_runtime_depth_prev_semantic = "NFSTWEAK_DEPTH_PREV";
+static std::atomic_bool g_enable_depth_snapshot(true);
+static resource g_depth_snapshot[2] = {};
+static resource_view g_depth_snapshot_srv[2] = {};
+static uint32_t g_depth_snapshot_w = 0;
+static uint32_t g_depth_snapshot_h = 0;
+static format g_depth_snapshot_format = format::unknown;
+static bool g_depth_snapshot_has_current = false;
+static uint64_t g_depth_snapshot_frame = 0;
+static std::atomic_uint64_t g_depth_snapshot_count(0);
+
+// While active, the snapshot owns NFSTWEAK_DEPTH and the live/resolved views are not bound directly.
+static bool depth_snapshot_active()
+{
+    return g_enable_depth_snapshot.load(std::memory_order_relaxed) && g_depth_snapshot_srv[0].handle != 0;
+}
+
+static msaa_resolve_target *acquire_msaa_resolve_target(uint32_t w, uint32_t h, format fmt, uint64_t frame)
+{
+    msaa_resolve_target *victim = nullptr;
+    for (uint32_t i = 0; i < k_msaa_resolve_pool_size; ++i)
+    {
+        msaa_resolve_target &t = g_msaa_resolve_pool[i];
+        if (t.res.handle != 0 && t.w == w && t.h == h && t.fmt == fmt)
+        {
+            t.last_frame = frame;
+            return &t;
+        }
+        // Never recycle the target currently bound to effects.
+        if (t.res.handle != 0 && t.srv.handle == g_msaa_resolve_bound_srv.handle)
+            continue;
+        if (victim == nullptr || t.res.handle == 0 || (victim->res.handle != 0 && t.last_frame < victim->last_frame))
+            victim = &t;
+    }
+    if (victim == nullptr)
+        return nullptr;
+
+    if (victim->srv.handle != 0)
+        g_device->destroy_resource_view(victim->srv);
+    if (victim->res.handle != 0)
+        g_device->destroy_resource(victim->res);
+    *victim = {};
+
+    // Same layout as generic depth copies: typeless storage, default-typed SRV.
+    resource_desc desc = {};
+    desc.type = resource_type::texture_2d;
+    desc.texture.width = w;
+    desc.texture.height = h;
+    desc.texture.depth_or_layers = 1;
+    desc.texture.levels = 1;
+    desc.texture.format = format_to_typeless(fmt);
+    desc.texture.samples = 1;
+    desc.usage = resource_usage::resolve_dest | resource_usage::shader_resource | resource_usage::depth_stencil;
+
+    resource res = { 0 };
+    if (!g_device->create_resource(desc, nullptr, resource_usage::shader_resource, &res))
+    {
+        char msg[192] = {};
+        sprintf_s(msg, "NFSTweakBridge: Failed to create MSAA resolve target (%ux%u fmt=%u).\n", w, h, static_cast<unsigned>(fmt));
+        log_info(msg);
+        return nullptr;
+    }
+
+    resource_view srv = { 0 };
+    if (!g_device->create_resource_view(res, resource_usage::shader_resource,
+        resource_view_desc(format_to_default_typed(desc.texture.format, 0)), &srv))
+    {
+        g_device->destroy_resource(res);
+        log_info("NFSTweakBridge: Failed to create MSAA resolve SRV.\n");
+        return nullptr;
+    }
+
+    victim->res = res;
+    victim->srv = srv;
+    victim->w = w;
+    victim->h = h;
+    victim->fmt = fmt;
+    victim->last_frame = frame;
+
+    char msg[192] = {};
+    sprintf_s(msg, "NFSTweakBridge: Created MSAA depth resolve target %ux%u (fmt=%u).\n", w, h, static_cast<unsigned>(fmt));
+    log_info(msg);
+    return victim;
+}
+
+static void destroy_msaa_resolve_pool()
+{
+    for (uint32_t i = 0; i < k_msaa_resolve_pool_size; ++i)
+    {
+        msaa_resolve_target &t = g_msaa_resolve_pool[i];
+        if (g_device != nullptr)
+        {
+            if (t.srv.handle != 0)
+                g_device->destroy_resource_view(t.srv);
+            if (t.res.handle != 0)
+                g_device->destroy_resource(t.res);
+        }
+        t = {};
+    }
+    g_msaa_resolve_bound_srv = { 0 };
+    g_msaa_resolve_last_res = { 0 };
+    g_msaa_resolve_frame.store(0, std::memory_order_relaxed);
+}
+
+// Resolves the bound runtime depth if it is multisampled and publishes the resolved copy.
+static void resolve_prehud_depth(command_list *cmd_list, uint64_t frame)
+{
+    if (!g_enable_vulkan_msaa_resolve.load(std::memory_order_relaxed))
+        return;
+    const resource src = g_runtime_depth_resource;
+    if (src.handle == 0)
+        return;
+    const resource_desc src_desc = g_device->get_resource_desc(src);
+    if (src_desc.type != resource_type::texture_2d || src_desc.texture.samples <= 1)
+        return;
+    if (g_msaa_resolve_frame.exchange(frame, std::memory_order_relaxed) == frame)
+        return;
+
+    if (!g_msaa_resolve_supported)
+    {
+        // Shader-based fallback is not possible here: ReShade FX cannot sample multisampled textures.
+        if (g_msaa_resolve_unsupported.fetch_add(1, std::memory_order_relaxed) == 0)
+            log_info("NFSTweakBridge: MSAA depth detected but device lacks resolve_depth_stencil; NFSTWEAK_DEPTH unavailable with in-game AA.\n");
+        return;
+    }
+
+    msaa_resolve_target *dst = acquire_msaa_resolve_target(src_desc.texture.width, src_desc.texture.height, src_desc.texture.format, frame);
+    if (dst == nullptr)
+        return;
+
+    // Scene writes to the DS are done at this point; return it to depth write afterwards for HUD passes.
+    cmd_list->barrier(src, resource_usage::depth_stencil_write, resource_usage::resolve_source);
+    cmd_list->barrier(dst->res, resource_usage::shader_resource, resource_usage::resolve_dest);
+    cmd_list->resolve_texture_region(src, 0, nullptr, dst->res, 0, 0, 0, 0, src_desc.texture.format);
+    cmd_list->barrier(dst->res, resource_usage::resolve_dest, resource_usage::shader_resource);
+    cmd_list->barrier(src, resource_usage::resolve_source, resource_usage::depth_stencil_write);
+
+    g_msaa_resolve_bound_srv = dst->srv;
+    g_msaa_resolve_last_res = dst->res;
+    g_runtime_depth_srv = dst->srv;
+    if (!depth_snapshot_active())
+        bind_runtime_depth_view(dst->srv);
+    g_msaa_resolve_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void destroy_depth_snapshot()
+{
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        if (g_device != nullptr)
+        {
+            if (g_depth_snapshot_srv[i].handle != 0)
+                g_device->destroy_resource_view(g_depth_snapshot_srv[i]);
+            if (g_depth_snapshot[i].handle != 0)
+                g_device->destroy_resource(g_depth_snapshot[i]);
+        }
+        g_depth_snapshot_srv[i] = { 0 };
+        g_depth_snapshot[i] = { 0 };
+    }
+    g_depth_snapshot_w = 0;
+    g_depth_snapshot_h = 0;
+    g_depth_snapshot_format = format::unknown;
+    g_depth_snapshot_has_current = false;
+    g_depth_snapshot_frame = 0;
+}
+
+static bool ensure_depth_snapshot(uint32_t w, uint32_t h, format fmt)
+{
+    const format storage_format = format_to_typeless(fmt);
+    if (g_depth_snapshot[0].handle != 0 && g_depth_snapshot_w == w && g_depth_snapshot_h == h && g_depth_snapshot_format == storage_format)
+        return true;
+
+    resource_desc desc = {};
+    desc.type = resource_type::texture_2d;
+    desc.texture.width = w;
+    desc.texture.height = h;
+    desc.texture.depth_or_layers = 1;
+    desc.texture.levels = 1;
+    desc.texture.format = storage_format;
+    desc.texture.samples = 1;
+    desc.usage = resource_usage::copy_dest | resource_usage::copy_source | resource_usage::shader_resource;
+
+    resource res[2] = {};
+    resource_view srv[2] = {};
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        if (!g_device->create_resource(desc, nullptr, resource_usage::shader_resource, &res[i]) ||
+            !g_device->create_resource_view(res[i], resource_usage::shader_resource,
+                resource_view_desc(format_to_default_typed(storage_format, 0)), &srv[i]))
+        {
+            for (uint32_t j = 0; j <= i; ++j)
+            {
+                if (srv[j].handle != 0)
+                    g_device->destroy_resource_view(srv[j]);
+                if (res[j].handle != 0)
+                    g_device->destroy_resource(res[j]);
+            }
+            char msg[192] = {};
+            sprintf_s(msg, "NFSTweakBridge: Failed to create depth snapshot %ux%u (fmt=%u).\n", w, h, static_cast<unsigned>(fmt));
+            log_info(msg);
+            return false;
+        }
+    }
+
+    // Publish the new views before destroying the old ones (bindings may still reference them).
+    const resource old_res[2] = { g_depth_snapshot[0], g_depth_snapshot[1] };
+    const resource_view old_srv[2] = { g_depth_snapshot_srv[0], g_depth_snapshot_srv[1] };
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        g_depth_snapshot[i] = res[i];
+        g_depth_snapshot_srv[i] = srv[i];
+    }
+    g_depth_snapshot_w = w;
+    g_depth_snapshot_h = h;
+    g_depth_snapshot_format = storage_format;
+    g_depth_snapshot_has_current = false;
+    bind_runtime_depth_view(srv[0]);
+    g_runtime->update_texture_bindings(k_runtime_depth_prev_semantic, srv[1], srv[1]);
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        if (old_srv[i].handle != 0)
+            g_device->destroy_resource_view(old_srv[i]);
+        if (old_res[i].handle != 0)
+            g_device->destroy_resource(old_res[i]);
+    }
+
+    char msg[192] = {};
+    sprintf_s(msg, "NFSTweakBridge: Created depth snapshot %ux%u (fmt=%u).\n", w, h, static_cast<unsigned>(storage_format));
+    log_info(msg);
+    return true;
+}
+
+// Copies current snapshot -> previous, then scene depth -> current.
+static void snapshot_prehud_depth(command_list *cmd_list, uint64_t frame)
+{
+    if (!g_enable_depth_snapshot.load(std::memory_order_relaxed) || g_runtime == nullptr)
+        return;
+    if (g_depth_snapshot_frame == frame)
+        return;
+
+    // Source: this frame's resolve target if MSAA, otherwise the selected single-sample depth.
+    resource src = { 0 };
+    resource_usage src_state = resource_usage::depth_stencil_write;
+    if (g_msaa_resolve_last_res.handle != 0 && g_msaa_resolve_frame.load(std::memory_order_relaxed) == frame &&
+        g_runtime_depth_srv.handle == g_msaa_resolve_bound_srv.handle)
+    {
+        src = g_msaa_resolve_last_res;
+        src_state = resource_usage::shader_resource;
+    }
+    else
+    {
+        src = g_runtime_depth_resource;
+    }
+    if (src.handle == 0)
+        return;
+    const resource_desc src_desc = g_device->get_resource_desc(src);
+    if (src_desc.type != resource_type::texture_2d || src_desc.texture.samples > 1)
+        return;
+    if (!ensure_depth_snapshot(src_desc.texture.width, src_desc.texture.height, src_desc.texture.format))
+        return;
+
+    timer_begin(cmd_list, k_timer_depth_snapshot, frame);
+    const resource cur = g_depth_snapshot[0];
+    const resource prev = g_depth_snapshot[1];
+    if (g_depth_snapshot_has_current)
+    {
+        cmd_list->barrier(cur, resource_usage::shader_resource, resource_usage::copy_source);
+        cmd_list->barrier(prev, resource_usage::shader_resource, resource_usage::copy_dest);
+        cmd_list->copy_texture_region(cur, 0, nullptr, prev, 0, nullptr);
+        cmd_list->barrier(prev, resource_usage::copy_dest, resource_usage::shader_resource);
+        cmd_list->barrier(cur, resource_usage::copy_source, resource_usage::copy_dest);
+    }
+    else
+    {
+        cmd_list->barrier(cur, resource_usage::shader_resource, resource_usage::copy_dest);
+    }
+    cmd_list->barrier(src, src_state, resource_usage::copy_source);
+    cmd_list->copy_texture_region(src, 0, nullptr, cur, 0, nullptr);
+    cmd_list->barrier(src, resource_usage::copy_source, src_state);
+    cmd_list->barrier(cur, resource_usage::copy_dest, resource_usage::shader_resource);
+    timer_end(cmd_list, k_timer_depth_snapshot, frame);
+
+    g_depth_snapshot_has_current = true;
+    g_depth_snapshot_frame = frame;
+    bind_runtime_depth_view(g_depth_snapshot_srv[0]);
+    g_depth_snapshot_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+// 'in_render_pass': called from begin_render_pass, so the command list is inside the game's render pass.
+static void prepare_prehud_depth(command_list *cmd_list, resource_view rtv, uint64_t frame, bool in_render_pass)
+{
+    if (cmd_list == nullptr || g_device == nullptr || g_device_api != device_api::vulkan)
+        return;
+    timer_begin(cmd_list, k_timer_prehud_depth, frame);
+    // Same-frame camera for the FX products and effects rendered right after this.
+    publish_camera_uniforms();
+    if (in_render_pass)
+    {
+        // No snapshot here: effects sample the live depth, as before the snapshot existed.
+        if (g_runtime_depth_srv.handle != 0)
+            bind_runtime_depth_view(g_runtime_depth_srv);
+    }
+    else
+    {
+        resolve_prehud_depth(cmd_list, frame);
+        snapshot_prehud_depth(cmd_list, frame);
+    }
+    run_fx_products(cmd_list, rtv, frame, in_render_pass);
+    timer_end(cmd_list, k_timer_prehud_depth, frame);
+}
@@ -1,81 +1,55 @@
-static constexpr bool k_enable_prehud_trace = true;
-static constexpr bool k_sample_render_trace = false;
-
-static void prehud_trace_push(uint32_t kind, uint64_t frame, uint64_t bp, uint64_t rtv, uint64_t dsv, uint32_t score, uint32_t token, uint32_t reason)
+// Check pre-HUD render invariants right after a successful manual render (before lock refresh).
+// Beginpass path intentionally re-renders the same token on later frames, so per-token check is bind-path only.
+static void prehud_check_render_invariants(bool check_token, uint64_t frame, uint64_t bp, uint32_t token, resource rt, resource ds, uint32_t score)
 {
-    if (!k_enable_prehud_trace)
-        return;
-    // Optional sampling for high-frequency render events.
-    // Diagnostics build can disable this to capture every preHUD render.
-    if (k_sample_render_trace && kind == 1 && (frame % 4) != 0)
-        return;
-    const uint32_t pos = g_prehud_trace_write.fetch_add(1, std::memory_order_relaxed);
-    prehud_trace_entry &e = g_prehud_trace[pos % k_prehud_trace_capacity];
-    e.kind = kind;
-    e.frame = frame;
-    e.bp = bp;
-    e.rtv = rtv;
-    e.dsv = dsv;
-    e.score = score;
-    e.token = token;
-    e.reason = reason;
-}
-
-static void prehud_trace_dump(uint32_t max_entries)
-{
-    if (!k_enable_prehud_trace)
-        return;
-    const uint32_t write = g_prehud_trace_write.load(std::memory_order_relaxed);
-    const uint32_t available = (write < k_prehud_trace_capacity) ? write : k_prehud_trace_capacity;
-    const uint32_t count = (max_entries < available) ? max_entries : available;
-    char exe_path[MAX_PATH] = {};
-    DWORD n = GetModuleFileNameA(nullptr, exe_path, MAX_PATH);
-    std::string dump_path = "NFSTweakBridge_TraceDump.log";
-    if (n > 0 && n < MAX_PATH)
+    g_prehud_invariant_checks.fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t violated = 0;
+    const uint32_t epoch = g_phase_epoch.load(std::memory_order_relaxed);
+    const uint64_t prev_frame = g_prehud_invariant_last_frame.exchange(frame, std::memory_order_relaxed);
+    const uint32_t prev_token = g_prehud_invariant_last_token.exchange(token, std::memory_order_relaxed);
+    const uint32_t prev_epoch = g_prehud_invariant_last_epoch.exchange(epoch, std::memory_order_relaxed);
+    if (prev_frame != 0 && prev_frame == frame)
     {
-        std::string exe(exe_path, n);
-        const size_t slash = exe.find_last_of("\\/");
-        if (slash != std::string::npos)
-            dump_path = exe.substr(0, slash + 1) + "NFSTweakBridge_TraceDump.log";
+        violated |= k_prehud_invariant_double_frame;
+        g_prehud_invariant_double_frame.fetch_add(1, std::memory_order_relaxed);
     }
-
-    std::ofstream out(dump_path.c_str(), std::ios::out | std::ios::trunc);
-    if (!out.is_open())
+    if (check_token && token != 0 && prev_token == token && prev_epoch == epoch)
     {
-        char msg[320] = {};
-        sprintf_s(msg, "NFSTweakBridge: TRACE DUMP failed to open '%s' (err=%lu)\n", dump_path.c_str(), GetLastError());
-        log_info(msg);
-        return;
+        violated |= k_prehud_invariant_double_token;
+        g_prehud_invariant_double_token.fetch_add(1, std::memory_order_relaxed);
     }
-
-    out << "NFSTweakBridge TRACE DUMP begin (entries=" << count << ", write=" << write << ")\n";
-    if (count == 0)
+    // While the lock is frozen (set when the beginpass selector acquires it) no path may render on another pair.
+    if (g_prehud_locked_rt_resource.handle != 0 &&
+        g_prehud_locked_ds_resource.handle != 0 &&
+        frame < g_prehud_lock_freeze_until_frame.load(std::memory_order_relaxed) &&
+        (rt.handle != g_prehud_locked_rt_resource.handle || ds.handle != g_prehud_locked_ds_resource.handle))
     {
-        out << "NFSTweakBridge TRACE DUMP empty\n";
+        violated |= k_prehud_invariant_unlocked_pair;
+        g_prehud_invariant_unlocked_pair.fetch_add(1, std::memory_order_relaxed);
     }
-    else
+    if (violated == 0)
+        return;
+
+    prehud_trace_push(4, frame, bp, static_cast<uint64_t>(rt.handle), static_cast<uint64_t>(ds.handle), score, token, violated);
+
+    static log_rate_limit s_violation_log(8, 5000);
+    uint64_t suppressed = 0;
+    if (log_rate_allow(s_violation_log, &suppressed))
     {
-        const uint32_t start = write - count;
-        for (uint32_t i = 0; i < count; ++i)
-        {
-            const prehud_trace_entry &e = g_prehud_trace[(start + i) % k_prehud_trace_capacity];
-            out << "NFSTrace: kind=" << e.kind
-                << " frame=" << static_cast<unsigned long long>(e.frame)
-                << " bp=" << static_cast<unsigned long long>(e.bp)
-                << " token=" << e.token
-                << " rtv=" << static_cast<unsigned long long>(e.rtv)
-                << " dsv=" << static_cast<unsigned long long>(e.dsv)
-                << " score=" << e.score
-                << " reason=0x" << std::hex << std::uppercase << e.reason << std::dec << "\n";
-        }
+        log_infof(
+            "NFSTweakBridge: PreHUD invariant violated mask=0x%02X frame=%llu bp=%llu token=%u epoch=%u rtv=%llu dsv=%llu locked_rtv=%llu locked_dsv=%llu (suppressed=%llu)\n",
+            violated,
+            static_cast<unsigned long long>(frame),
+            static_cast<unsigned long long>(bp),
+            token,
+            epoch,
+            static_cast<unsigned long long>(rt.handle),
+            static_cast<unsigned long long>(ds.handle),
+            static_cast<unsigned long long>(g_prehud_locked_rt_resource.handle),
+            static_cast<unsigned long long>(g_prehud_locked_ds_resource.handle),
+            static_cast<unsigned long long>(suppressed));
     }
-    out << "NFSTweakBridge TRACE DUMP end\n";
-    out.flush();
-    out.close();
-
-    char ok_msg[320] = {};
-    sprintf_s(ok_msg, "NFSTweakBridge: TRACE DUMP wrote '%s' (entries=%u)\n", dump_path.c_str(), count);
-    log_info(ok_msg);
 }
 
 static constexpr const char *k_runtime_depth_semantic = "NFSTWEAK_DEPTH";
@@ -86,12 +60,56 @@ static void bind_runtime_depth_view(resource_view view)
     if (!g_runtime || view.handle == 0)
         return;
 
+    // Every binding update makes the runtime rewrite descriptors of all effects; skip if nothing changed.
+    const bool mirror = g_mirror_customdepth_debug.load(std::memory_order_relaxed);
+    if (view.handle == g_bound_runtime_depth_view.handle && mirror == g_bound_runtime_depth_mirror)
+    {
+        g_depth_binding_skips.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
     g_runtime->update_texture_bindings(k_runtime_depth_semantic, view, view);
-    if (g_mirror_customdepth_debug.load(std::memory_order_relaxed))
+    if (mirror)
         g_runtime->update_texture_bindings(k_debug_customdepth_semantic, view, view);
+    g_depth_binding_updates.fetch_add(1, std::memory_order_relaxed);
+    g_bound_runtime_depth_view = view;
+    g_bound_runtime_depth_mirror = mirror;
+
+    std::lock_guard<std::mutex> lock(g_depth_view_cache_mutex);
+    if (g_retired_runtime_depth_view.handle != 0 && g_retired_runtime_depth_view.handle != view.handle && g_device)
+    {
+        g_device->destroy_resource_view(g_retired_runtime_depth_view);
+        g_retired_runtime_depth_view = { 0 };
+    }
 }
 
-static void on_bind_render_targets_and_depth_stencil(command_list *cmd_list, uint32_t count, const resource_view *rtvs, resource_view dsv)
+// The resource behind the bound view was destroyed: reset the semantic(s) to the effects' default texture now and
+// destroy the retired view, instead of leaving a dangling descriptor bound until the next candidate binds.
+static void unbind_retired_runtime_depth_view()
+{
+    {
+        std::lock_guard<std::mutex> lock(g_depth_view_cache_mutex);
+        if (g_retired_runtime_depth_view.handle == 0 || g_retired_runtime_depth_view.handle != g_bound_runtime_depth_view.handle)
+            return;
+    }
+
+    if (g_runtime)
+    {
+        g_runtime->update_texture_bindings(k_runtime_depth_semantic, resource_view { 0 }, resource_view { 0 });
+        if (g_bound_runtime_depth_mirror)
+            g_runtime->update_texture_bindings(k_debug_customdepth_semantic, resource_view { 0 }, resource_view { 0 });
+        g_depth_binding_updates.fetch_add(1, std::memory_order_relaxed);
+    }
+    g_bound_runtime_depth_view = { 0 };
+    g_bound_runtime_depth_mirror = false;
+
+    std::lock_guard<std::mutex> lock(g_depth_view_cache_mutex);
+    if (g_device)
+        g_device->destroy_resource_view(g_retired_runtime_depth_view);
+    g_retired_runtime_depth_view = { 0 };
+}
+
+static void handle_bind_render_targets_and_depth_stencil(command_list *cmd_list, uint32_t count, const resource_view *rtvs, resource_view dsv)
 {
     if (!g_runtime_alive.load(std::memory_order_relaxed))
         return;
@@ -203,7 +221,7 @@ static void on_bind_render_targets_and_depth_stencil(command_list *cmd_list, uin
                 g_prehud_locked_ds_resource.handle != 0 &&
                 prehud_rtv_resource.handle == g_prehud_locked_rt_resource.handle &&
                 prehud_dsv_resource.handle == g_prehud_locked_ds_resource.handle;
-            const uint32_t min_score_bind = locked_pair_pass_bind ? 0u : 600u;
+            const uint32_t min_score_bind = locked_pair_pass_bind ? 0u : k_prehud_min_unlocked_score;
 
             if (prehud_rtv.handle != 0 &&
                 prehud_rtv_resource.handle != 0 &&
@@ -219,26 +237,39 @@ static void on_bind_render_targets_and_depth_stencil(command_list *cmd_list, uin
                 g_skip_manual_prehud_frames.load() <= 0 &&
                 !g_running_manual_effects.exchange(true))
             {
+                timeline_mark_pass(token);
                 bool render_ok = true;
+                bool timer_open = false; // end the scope even when render_effects faults
+                trace_span_begin(k_span_render_effects);
                 __try
                 {
                     g_manual_effects_cmdlist.store(reinterpret_cast<uintptr_t>(cmd_list), std::memory_order_relaxed);
                     g_manual_effects_frame.store(frame, std::memory_order_relaxed);
                     g_manual_effects_budget.store(1, std::memory_order_relaxed);
+                    prepare_prehud_depth(cmd_list, prehud_rtv, frame, false);
+                    timer_begin(cmd_list, k_timer_prehud_effects, frame);
+                    timer_open = true;
                     g_runtime->render_effects(cmd_list, prehud_rtv, prehud_rtv);
+                    timer_open = false;
+                    timer_end(cmd_list, k_timer_prehud_effects, frame);
                     g_manual_effects_budget.store(0, std::memory_order_relaxed);
                 }
                 __except (EXCEPTION_EXECUTE_HANDLER)
                 {
                     render_ok = false;
+                    if (timer_open)
+                        timer_end(cmd_list, k_timer_prehud_effects, frame);
                     g_manual_effects_budget.store(0, std::memory_order_relaxed);
                     g_disable_beginpass_after_fault.store(true, std::memory_order_relaxed);
                     log_info("NFSTweakBridge: render_effects fault in bind_render_targets path; disabling manual path.\n");
+                    trace_note_fault();
                 }
+                trace_span_end(k_span_render_effects);
 
                 g_running_manual_effects.store(false, std::memory_order_relaxed);
                 if (render_ok)
                 {
+                    timeline_mark_render();
                     g_manual_render_latch_frame.store(frame, std::memory_order_relaxed);
                     g_last_manual_prehud_frame.store(frame, std::memory_order_relaxed);
                     g_pre_hud_effects_issued_this_frame.store(true, std::memory_order_relaxed);
@@ -249,6 +280,8 @@ static void on_bind_render_targets_and_depth_stencil(command_list *cmd_list, uin
                         static_cast<uint64_t>(prehud_rtv_resource.handle),
                         static_cast<uint64_t>(prehud_dsv_resource.handle),
                         score, token, 0);
+                    prehud_check_render_invariants(true, frame, g_beginpass_counter.load(std::memory_order_relaxed),
+                        token, prehud_rtv_resource, prehud_dsv_resource, score);
                     g_scene_window_rendered_token.store(token, std::memory_order_relaxed);
                     g_scene_window_open.store(false, std::memory_order_relaxed);
                     g_scene_window_close_pending.store(false, std::memory_order_relaxed);
@@ -267,6 +300,11 @@ static void on_bind_render_targets_and_depth_stencil(command_list *cmd_list, uin
 
     if (dsv.handle != 0)
     {
+        bool has_color = false;
+        for (uint32_t i = 0; i < count && rtvs != nullptr && !has_color; ++i)
+            has_color = rtvs[i].handle != 0;
+        depth_class_observe(dsv, has_color, score >= 600, false);
+
         if (g_prehud_locked_ds_resource.handle != 0)
         {
             const resource ds_res = g_device->get_resource_from_view(dsv);
@@ -277,6 +315,46 @@ static void on_bind_render_targets_and_depth_stencil(command_list *cmd_list, uin
     }
 }
 
+// The handler uses __try, so the cost is measured here rather than with a scope object inside it.
+static void on_bind_render_targets_and_depth_stencil(command_list *cmd_list, uint32_t count, const resource_view *rtvs, resource_view dsv)
+{
+    const uint64_t begin = qpc_now();
+    handle_bind_render_targets_and_depth_stencil(cmd_list, count, rtvs, dsv);
+    perf_add(k_perf_bind, begin);
+}
+
+static void reset_vulkan_depth_candidate()
+{
+    g_vulkan_depth_candidate_dsv = { 0 };
+    g_vulkan_depth_candidate_res = { 0 };
+    g_vulkan_depth_candidate_w = 0;
+    g_vulkan_depth_candidate_h = 0;
+    g_vulkan_depth_candidate_samples = 1;
+    g_vulkan_depth_candidate_format = format::unknown;
+    g_vulkan_depth_candidate_score = 0;
+}
+
+// Drops every slot except 'keep' (the incumbent), whose statistics carry over so hysteresis still applies.
+static void clear_depth_candidate_table(resource keep)
+{
+    for (uint32_t i = 0; i < k_depth_candidate_slots; ++i)
+    {
+        if (keep.handle == 0 || g_depth_candidates[i].res.handle != keep.handle)
+            g_depth_candidates[i] = {};
+    }
+}
+
+static void remove_depth_candidate(resource res)
+{
+    for (uint32_t i = 0; i < k_depth_candidate_slots; ++i)
+    {
+        if (g_depth_candidates[i].res.handle == res.handle)
+            g_depth_candidates[i] = {};
+    }
+    if (g_depth_candidate_pick.res.handle == res.handle)
+        g_depth_candidate_pick = {};
+}
+
 static void try_bind_vulkan_depth(resource_view dsv, uint32_t score_hint)
 {
     if (!g_runtime || !g_device)
@@ -290,7 +368,7 @@ static void try_bind_vulkan_depth(resource_view dsv, uint32_t score_hint)
     if (dsv.handle == 0)
         return;
 
-    // Record candidate; actual bind happens once per frame in 'on_present' (reduces flicker and partial binds).
+    // Record observation; actual bind decision happens once per frame in 'on_present' (reduces flicker and partial binds).
     const resource depth_res = g_device->get_resource_from_view(dsv);
     if (depth_res.handle == 0)
         return;
@@ -299,7 +377,7 @@ static void try_bind_vulkan_depth(resource_view dsv, uint32_t score_hint)
     if (res_desc.type != resource_type::texture_2d)
         return;
 
-    // Choose the "best" candidate by preferring the highest score (main camera pass), then largest area.
+    // Frame-best candidate by score then largest area (kept for overlay and to count avoided rebinds).
     const uint64_t area = static_cast<uint64_t>(res_desc.texture.width) * res_desc.texture.height;
     const uint64_t best_area = static_cast<uint64_t>(g_vulkan_depth_candidate_w) * g_vulkan_depth_candidate_h;
     if (score_hint > g_vulkan_depth_candidate_score || (score_hint == g_vulkan_depth_candidate_score && area >= best_area))
@@ -312,6 +390,107 @@ static void try_bind_vulkan_depth(resource_view dsv, uint32_t score_hint)
         g_vulkan_depth_candidate_format = g_device->get_resource_view_desc(dsv).format;
         g_vulkan_depth_candidate_score = score_hint;
     }
+
+    // Observation: RT score plus up to 200 for covering the backbuffer area (same ordering as above).
+    uint32_t obs = score_hint;
+    if (g_runtime != nullptr)
+    {
+        const resource_desc back_desc = g_device->get_resource_desc(g_runtime->get_current_back_buffer());
+        const uint64_t bb_area = static_cast<uint64_t>(back_desc.texture.width) * back_desc.texture.height;
+        if (bb_area != 0)
+            obs += static_cast<uint32_t>((std::min(area, bb_area) * 200) / bb_area);
+    }
+
+    depth_candidate_slot *slot = nullptr;
+    depth_candidate_slot *weakest = nullptr;
+    for (uint32_t i = 0; i < k_depth_candidate_slots; ++i)
+    {
+        depth_candidate_slot &c = g_depth_candidates[i];
+        if (c.res.handle == depth_res.handle)
+        {
+            slot = &c;
+            break;
+        }
+        if (c.res.handle == 0)
+        {
+            if (weakest == nullptr || weakest->res.handle != 0)
+                weakest = &c;
+            continue;
+        }
+        // Never evict the incumbent.
+        if (c.res.handle == g_runtime_depth_resource.handle)
+            continue;
+        if (weakest == nullptr || (weakest->res.handle != 0 && c.mean < weakest->mean))
+            weakest = &c;
+    }
+    if (slot == nullptr)
+    {
+        if (weakest == nullptr)
+            return;
+        *weakest = {};
+        weakest->res = depth_res;
+        slot = weakest;
+    }
+
+    const uint32_t pass_in_frame = static_cast<uint32_t>(
+        g_beginpass_counter.load(std::memory_order_relaxed) - g_frame_beginpass_start.load(std::memory_order_relaxed));
+    slot->dsv = dsv;
+    slot->w = res_desc.texture.width;
+    slot->h = res_desc.texture.height;
+    slot->samples = res_desc.texture.samples;
+    slot->fmt = g_device->get_resource_view_desc(dsv).format;
+    if (slot->frame_hits == 0 || pass_in_frame < slot->frame_first_pass)
+        slot->frame_first_pass = pass_in_frame;
+    slot->frame_obs = std::max(slot->frame_obs, obs);
+    slot->frame_paired = slot->frame_paired || score_hint >= 600;
+    ++slot->frame_hits;
+    ++slot->total_hits;
+}
+
+// Fold this frame's observations into the running statistics. Unseen slots decay towards zero.
+static void update_depth_candidate_table()
+{
+    const uint32_t epoch = g_phase_epoch.load(std::memory_order_relaxed);
+    if (epoch != g_depth_candidate_epoch)
+    {
+        clear_depth_candidate_table(g_runtime_depth_resource);
+        g_depth_candidate_epoch = epoch;
+    }
+
+    for (uint32_t i = 0; i < k_depth_candidate_slots; ++i)
+    {
+        depth_candidate_slot &c = g_depth_candidates[i];
+        if (c.res.handle == 0)
+            continue;
+
+        const float x = static_cast<float>(c.frame_obs);
+        if (c.frames_seen == 0 && c.frame_hits != 0)
+        {
+            c.mean = x;
+            c.var = 0.0f;
+        }
+        else
+        {
+            const float diff = x - c.mean;
+            c.mean += k_depth_candidate_alpha * diff;
+            c.var = (1.0f - k_depth_candidate_alpha) * (c.var + k_depth_candidate_alpha * diff * diff);
+        }
+        if (c.frame_hits != 0)
+        {
+            ++c.frames_seen;
+            c.last_first_pass = c.frame_first_pass;
+            if (c.frame_paired)
+                ++c.paired_frames;
+        }
+        c.frame_obs = 0;
+        c.frame_hits = 0;
+        c.frame_first_pass = 0;
+        c.frame_paired = false;
+
+        // Long gone: free the slot (keep the incumbent so its statistics survive short absences).
+        if (c.frames_seen != 0 && c.mean < 1.0f && c.res.handle != g_runtime_depth_resource.handle)
+            c = {};
+    }
 }
 
 static void bind_vulkan_candidate_if_good()
@@ -322,9 +501,65 @@ static void bind_vulkan_candidate_if_good()
         return;
     if (!g_enable_vulkan_depth_bind.load())
         return;
-    if (g_vulkan_depth_candidate_dsv.handle == 0 || g_vulkan_depth_candidate_res.handle == 0)
+
+    // What the single-frame rule would have done: switch to the frame-best unless 150 below the last bound score.
+    // Compared in table units (RT score + area bonus), the same units g_vulkan_depth_last_score is kept in.
+    uint32_t frame_best_obs = 0;
+    for (uint32_t i = 0; i < k_depth_candidate_slots; ++i)
+    {
+        if (g_depth_candidates[i].res.handle != 0 && g_depth_candidates[i].res.handle == g_vulkan_depth_candidate_res.handle)
+            frame_best_obs = g_depth_candidates[i].frame_obs;
+    }
+    const bool legacy_would_switch =
+        g_vulkan_depth_candidate_res.handle != 0 &&
+        g_vulkan_depth_candidate_res.handle != g_runtime_depth_resource.handle &&
+        !(g_runtime_depth_resource.handle != 0 && frame_best_obs + 150 < g_vulkan_depth_last_score);
+    // Next frame's frame-best starts from scratch.
+    reset_vulkan_depth_candidate();
+
+    update_depth_candidate_table();
+
+    const depth_candidate_slot *challenger = nullptr;
+    const depth_candidate_slot *incumbent = nullptr;
+    for (uint32_t i = 0; i < k_depth_candidate_slots; ++i)
+    {
+        const depth_candidate_slot &c = g_depth_candidates[i];
+        if (c.res.handle == 0)
+            continue;
+        if (c.res.handle == g_runtime_depth_resource.handle)
+            incumbent = &c;
+        if (c.frames_seen < k_depth_candidate_min_frames || c.dsv.handle == 0)
+            continue;
+        if (challenger == nullptr || c.mean > challenger->mean ||
+            (c.mean == challenger->mean && c.paired_frames > challenger->paired_frames))
+            challenger = &c;
+    }
+    if (challenger == nullptr)
         return;
 
+    g_depth_candidate_pick = *challenger;
+
+    // Multisampled depth is published through the pre-HUD resolve (resolve_prehud_depth) instead of a direct SRV.
+    const bool is_msaa = challenger->samples > 1 && g_enable_vulkan_msaa_resolve.load(std::memory_order_relaxed);
+    if (g_runtime_depth_resource.handle == challenger->res.handle && (g_runtime_depth_srv.handle != 0 || is_msaa))
+    {
+        g_vulkan_depth_last_score = static_cast<uint32_t>(challenger->mean);
+        return;
+    }
+
+    // Hysteresis: switch away from a bound depth only on a statistically meaningful lead.
+    if (g_runtime_depth_resource.handle != 0 && incumbent != nullptr)
+    {
+        const float lead = challenger->mean - incumbent->mean;
+        const float noise = std::sqrt(std::max(0.0f, challenger->var + incumbent->var));
+        if (lead <= k_depth_switch_sigma * noise + k_depth_switch_margin)
+        {
+            if (legacy_would_switch)
+                g_depth_rebinds_avoided.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
     const resource back = g_runtime->get_current_back_buffer();
     const resource_desc back_desc = g_device->get_resource_desc(back);
     const uint32_t bb_w = back_desc.texture.width;
@@ -335,75 +570,56 @@ static void bind_vulkan_candidate_if_good()
         if (g_require_vulkan_backbuffer_match.load())
         {
             // Require exact match to avoid binding UI/partial-res depth buffers (fixes "only upper part shown").
-            if (g_vulkan_depth_candidate_w != bb_w || g_vulkan_depth_candidate_h != bb_h)
+            if (challenger->w != bb_w || challenger->h != bb_h)
                 return;
         }
     }
 
-    // Hysteresis: avoid switching to a lower-confidence camera (helps with "wrong camera" flicker).
-    // Only allow switching if the new score is significantly better than the last bound one.
-    if (g_runtime_depth_resource.handle != 0 && g_vulkan_depth_candidate_score + 150 < g_vulkan_depth_last_score)
-        return;
-
-    // MSAA resolve path is disabled to avoid unintended AA-like behavior when game AA is off.
-    const bool is_msaa = false;
-    if (!is_msaa && g_runtime_depth_srv.handle != 0 && g_runtime_depth_resource.handle == g_vulkan_depth_candidate_res.handle)
-        return;
-
-    if (g_runtime_depth_srv.handle != 0)
+    if (is_msaa)
     {
-        g_device->destroy_resource_view(g_runtime_depth_srv);
+        // Keep the previous binding until the first resolve of the new source lands at pre-HUD.
         g_runtime_depth_srv = { 0 };
-    }
-
-    if (is_msaa && g_vulkan_depth_resolved_srv.handle != 0 &&
-        g_vulkan_depth_resolved_w == bb_w && g_vulkan_depth_resolved_h == bb_h &&
-        g_vulkan_depth_resolved_format == g_vulkan_depth_candidate_format)
-    {
-        bind_runtime_depth_view(g_vulkan_depth_resolved_srv);
-        log_info("NFSTweakBridge: Bound RESOLVED Vulkan depth buffer as NFSTWEAK_DEPTH.\n");
-        g_vulkan_depth_last_score = g_vulkan_depth_candidate_score;
-
-        g_vulkan_depth_candidate_dsv = { 0 };
-        g_vulkan_depth_candidate_res = { 0 };
-        g_vulkan_depth_candidate_w = 0;
-        g_vulkan_depth_candidate_h = 0;
-        g_vulkan_depth_candidate_samples = 1;
-        g_vulkan_depth_candidate_format = format::unknown;
-        g_vulkan_depth_candidate_score = 0;
+        g_runtime_depth_resource = challenger->res;
+        g_vulkan_depth_last_score = static_cast<uint32_t>(challenger->mean);
+        g_depth_rebinds.fetch_add(1, std::memory_order_relaxed);
+        log_info("NFSTweakBridge: Selected multisampled Vulkan depth; publishing resolved copy as NFSTWEAK_DEPTH.\n");
         return;
     }
 
-    const resource_view_desc dsv_desc = g_device->get_resource_view_desc(g_vulkan_depth_candidate_dsv);
+    const resource_view_desc dsv_desc = g_device->get_resource_view_desc(challenger->dsv);
     resource_view_desc srv_desc = dsv_desc; // preserve view type + layer/level range
 
-    resource_view srv = { 0 };
-    if (!g_device->create_resource_view(g_vulkan_depth_candidate_res, resource_usage::shader_resource, srv_desc, &srv))
+    // Views are owned by the view cache; switching back to a known depth only costs a binding update.
+    const resource_view srv = depth_view_cache_acquire(g_device, challenger->res, srv_desc, g_runtime_depth_srv);
+    if (srv.handle == 0)
     {
         char msg[256] = {};
         sprintf_s(msg, "NFSTweakBridge: Failed to create SRV for candidate depth (fmt=%u, w=%u, h=%u, samples=%u)\n",
-            (unsigned)dsv_desc.format, g_vulkan_depth_candidate_w, g_vulkan_depth_candidate_h, g_vulkan_depth_candidate_samples);
+            (unsigned)dsv_desc.format, challenger->w, challenger->h, challenger->samples);
         log_info(msg);
         return;
     }
 
     g_runtime_depth_srv = srv;
-    g_runtime_depth_resource = g_vulkan_depth_candidate_res;
-    bind_runtime_depth_view(g_runtime_depth_srv);
-    log_info("NFSTweakBridge: Bound Vulkan depth buffer as NFSTWEAK_DEPTH.\n");
-    g_vulkan_depth_last_score = g_vulkan_depth_candidate_score;
-
-    // Reset candidate each frame so we don't stick to a stale/mismatched camera depth buffer.
-    g_vulkan_depth_candidate_dsv = { 0 };
-    g_vulkan_depth_candidate_res = { 0 };
-    g_vulkan_depth_candidate_w = 0;
-    g_vulkan_depth_candidate_h = 0;
-    g_vulkan_depth_candidate_samples = 1;
-    g_vulkan_depth_candidate_format = format::unknown;
-    g_vulkan_depth_candidate_score = 0;
+    g_runtime_depth_resource = challenger->res;
+    g_msaa_resolve_bound_srv = { 0 };
+    if (!depth_snapshot_active())
+        bind_runtime_depth_view(g_runtime_depth_srv);
+    g_vulkan_depth_last_score = static_cast<uint32_t>(challenger->mean);
+    const uint64_t n = g_depth_rebinds.fetch_add(1, std::memory_order_relaxed) + 1;
+    static log_rate_limit s_rebind_log(8, 1000);
+    if (log_rate_allow(s_rebind_log))
+    {
+        log_infof("NFSTweakBridge: Bound Vulkan depth buffer as NFSTWEAK_DEPTH (rebind=%llu res=%llu mean=%.0f sd=%.0f %ux%u).\n",
+            static_cast<unsigned long long>(n),
+            static_cast<unsigned long long>(challenger->res.handle),
+            challenger->mean,
+            std::sqrt(challenger->var),
+            challenger->w, challenger->h);
+    }
 }
 
-static void on_begin_render_pass(command_list *cmd_list, uint32_t count, const render_pass_render_target_desc *rts, const render_pass_depth_stencil_desc *ds)
+static void handle_begin_render_pass(command_list *cmd_list, uint32_t count, const render_pass_render_target_desc *rts, const render_pass_depth_stencil_desc *ds)
 {
     if (!g_runtime_alive.load(std::memory_order_relaxed))
         return;
@@ -440,6 +656,14 @@ static void on_begin_render_pass(command_list *cmd_list, uint32_t count, const r
         }
     }
 
+    if (ds->view.handle != 0)
+    {
+        bool has_color = false;
+        for (uint32_t i = 0; i < count && rts != nullptr && !has_color; ++i)
+            has_color = rts[i].view.handle != 0;
+        depth_class_observe(ds->view, has_color, score >= 600, false);
+    }
+
     const bool beginpass_enabled = g_enable_vulkan_beginpass_prehud.load(std::memory_order_relaxed);
     const uint64_t frame = g_frame_index.load(std::memory_order_relaxed);
     const uint64_t bind_cb_count = g_bind_rt_ds_event_count.load(std::memory_order_relaxed);
@@ -723,7 +947,7 @@ static void on_begin_render_pass(command_list *cmd_list, uint32_t count, const r
         }
     }
     const uint32_t min_score_beginpass =
-        locked_pair_pass ? 0u : (exact_backbuffer_pass ? 1000u : 600u);
+        locked_pair_pass ? 0u : (exact_backbuffer_pass ? 1000u : k_prehud_min_unlocked_score);
 
     if (allow_beginpass_render &&
         g_enable_manual_prehud_render.load(std::memory_order_relaxed) &&
@@ -758,28 +982,41 @@ static void on_begin_render_pass(command_list *cmd_list, uint32_t count, const r
             return;
         }
 
+        timeline_mark_pass(token);
         bool render_ok = true;
+        bool timer_open = false;
+        trace_span_begin(k_span_render_effects);
         __try
         {
             g_manual_effects_cmdlist.store(reinterpret_cast<uintptr_t>(cmd_list), std::memory_order_relaxed);
             g_manual_effects_frame.store(frame, std::memory_order_relaxed);
             g_manual_effects_budget.store(1, std::memory_order_relaxed);
+            prepare_prehud_depth(cmd_list, prehud_rtv, frame, true);
+            timer_begin(cmd_list, k_timer_prehud_effects, frame);
+            timer_open = true;
             g_runtime->render_effects(cmd_list, prehud_rtv, prehud_rtv);
+            timer_open = false;
+            timer_end(cmd_list, k_timer_prehud_effects, frame);
             g_manual_effects_budget.store(0, std::memory_order_relaxed);
         }
         __except (EXCEPTION_EXECUTE_HANDLER)
         {
             render_ok = false;
+            if (timer_open)
+                timer_end(cmd_list, k_timer_prehud_effects, frame);
             g_manual_effects_budget.store(0, std::memory_order_relaxed);
             g_disable_beginpass_after_fault.store(true, std::memory_order_relaxed);
             log_info("NFSTweakBridge: render_effects fault in begin_render_pass; disabling beginpass path.\n");
+            trace_note_fault();
         }
+        trace_span_end(k_span_render_effects);
         if (!render_ok)
         {
             g_running_manual_effects.store(false);
             g_request_pre_hud_effects.store(false);
             return;
         }
+        timeline_mark_render();
         const uint64_t rc = g_render_counter.fetch_add(1, std::memory_order_relaxed) + 1;
         g_last_manual_render_beginpass.store(bp, std::memory_order_relaxed);
         g_running_manual_effects.store(false);
@@ -798,6 +1035,7 @@ static void on_begin_render_pass(command_list *cmd_list, uint32_t count, const r
             static_cast<uint64_t>(prehud_rtv_resource.handle),
             static_cast<uint64_t>(prehud_dsv_resource.handle),
             score, token, 0);
+        prehud_check_render_invariants(false, frame, bp, token, prehud_rtv_resource, prehud_dsv_resource, score);
         g_scene_window_rendered_token.store(token, std::memory_order_relaxed);
         g_scene_window_open.store(false, std::memory_order_relaxed);
         g_scene_window_close_pending.store(false, std::memory_order_relaxed);
@@ -822,10 +1060,10 @@ static void on_begin_render_pass(command_list *cmd_list, uint32_t count, const r
             // Freeze runtime depth source selection to this stable phase.
             g_lock_vulkan_depth.store(true, std::memory_order_relaxed);
         }
-        if (rc <= 3 || (rc % 600) == 0)
+        static log_rate_limit s_render_log(3, 5000);
+        if (log_rate_allow(s_render_log))
         {
-            char msg[320] = {};
-            sprintf_s(msg,
+            log_infof(
                 "NFSTweakBridge: Rendered effects at pre-HUD (rc=%llu frame=%llu bp=%llu rtv=%llu dsv=%llu score=%u)\n",
                 static_cast<unsigned long long>(rc),
                 static_cast<unsigned long long>(frame),
@@ -833,7 +1071,6 @@ static void on_begin_render_pass(command_list *cmd_list, uint32_t count, const r
                 static_cast<unsigned long long>(prehud_rtv_resource.handle),
                 static_cast<unsigned long long>(prehud_dsv_resource.handle),
                 score);
-            log_info(msg);
         }
     }
     else if (wants_prehud)
@@ -889,35 +1126,32 @@ static void on_begin_render_pass(command_list *cmd_list, uint32_t count, const r
 
         // Auto trace dumping is disabled in runtime builds: too expensive during transitions.
 
-        static uint64_t s_skip_diag_counter = 0;
-        const uint64_t c = ++s_skip_diag_counter;
-        if (c <= 4 || (c % 2400) == 0)
+        static log_rate_limit s_skip_log(4, 20000);
+        uint64_t skips_suppressed = 0;
+        if (log_rate_allow(s_skip_log, &skips_suppressed))
         {
-            char msg[320] = {};
-            sprintf_s(msg,
-                "NFSTweakBridge: PreHUD skip reason=0x%02X frame=%llu bp=%llu score=%u token=%u rtv=%llu dsv=%llu\n",
+            log_infof(
+                "NFSTweakBridge: PreHUD skip reason=0x%02X frame=%llu bp=%llu score=%u token=%u rtv=%llu dsv=%llu (suppressed=%llu)\n",
                 reason,
                 static_cast<unsigned long long>(frame),
                 static_cast<unsigned long long>(bp),
                 score,
                 token,
                 static_cast<unsigned long long>(prehud_rtv_resource.handle),
-                static_cast<unsigned long long>(prehud_dsv_resource.handle));
-            log_info(msg);
+                static_cast<unsigned long long>(prehud_dsv_resource.handle),
+                static_cast<unsigned long long>(skips_suppressed));
         }
         static uint64_t s_last_rt = 0;
         static uint64_t s_last_ds = 0;
         const uint64_t cur_rt = prehud_rtv_resource.handle;
         const uint64_t cur_ds = prehud_dsv_resource.handle;
-        static uint64_t s_switch_log_counter = 0;
+        static log_rate_limit s_switch_log(4, 20000);
         if (s_last_rt != 0 && s_last_ds != 0 && cur_rt != 0 && cur_ds != 0 &&
             (s_last_rt != cur_rt || s_last_ds != cur_ds))
         {
-            const uint64_t n = ++s_switch_log_counter;
-            if (n <= 4 || (n % 2400) == 0)
+            if (log_rate_allow(s_switch_log))
             {
-                char msg[320] = {};
-                sprintf_s(msg,
+                log_infof(
                     "NFSTweakBridge: Pre-HUD RT/DS switched (frame=%llu bp=%llu old_rtv=%llu old_dsv=%llu new_rtv=%llu new_dsv=%llu)\n",
                     static_cast<unsigned long long>(frame),
                     static_cast<unsigned long long>(bp),
@@ -925,7 +1159,6 @@ static void on_begin_render_pass(command_list *cmd_list, uint32_t count, const r
                     static_cast<unsigned long long>(s_last_ds),
                     static_cast<unsigned long long>(cur_rt),
                     static_cast<unsigned long long>(cur_ds));
-                log_info(msg);
             }
         }
         s_last_rt = cur_rt;
@@ -943,70 +1176,29 @@ static void on_begin_render_pass(command_list *cmd_list, uint32_t count, const r
     {
         try_bind_vulkan_depth(ds->view, score);
     }
+}
 
-    // MSAA resolve path intentionally disabled.
-    if (false && g_enable_vulkan_msaa_resolve.load() && g_vulkan_depth_candidate_samples > 1 && g_vulkan_depth_candidate_res.handle != 0)
-    {
-        if (!g_device->check_capability(device_caps::resolve_depth_stencil))
-            return;
-
-        // Backbuffer dims already computed above.
-        if (bb_w == 0 || bb_h == 0)
-            return;
-
-        if (g_require_vulkan_backbuffer_match.load() && (g_vulkan_depth_candidate_w != bb_w || g_vulkan_depth_candidate_h != bb_h))
-            return;
-
-        // (Re)create resolve target if needed
-        if (g_vulkan_depth_resolved.handle == 0 || g_vulkan_depth_resolved_w != bb_w || g_vulkan_depth_resolved_h != bb_h || g_vulkan_depth_resolved_format != g_vulkan_depth_candidate_format)
-        {
-            if (g_vulkan_depth_resolved_srv.handle != 0)
-            {
-                g_device->destroy_resource_view(g_vulkan_depth_resolved_srv);
-                g_vulkan_depth_resolved_srv = { 0 };
-            }
-            if (g_vulkan_depth_resolved.handle != 0)
-            {
-                g_device->destroy_resource(g_vulkan_depth_resolved);
-                g_vulkan_depth_resolved = { 0 };
-            }
-
-            resource_desc desc = {};
-            desc.type = resource_type::texture_2d;
-            desc.texture.width = bb_w;
-            desc.texture.height = bb_h;
-            desc.texture.depth_or_layers = 1;
-            desc.texture.levels = 1;
-            desc.texture.format = g_vulkan_depth_candidate_format;
-            desc.texture.samples = 1;
-            desc.usage = resource_usage::resolve_dest | resource_usage::shader_resource;
-
-            if (!g_device->create_resource(desc, nullptr, resource_usage::resolve_dest, &g_vulkan_depth_resolved))
-                return;
-
-            resource_view_desc srv_desc = resource_view_desc(resource_view_type::texture_2d, g_vulkan_depth_candidate_format, 0, 1, 0, 1);
-            if (!g_device->create_resource_view(g_vulkan_depth_resolved, resource_usage::shader_resource, srv_desc, &g_vulkan_depth_resolved_srv))
-            {
-                g_device->destroy_resource(g_vulkan_depth_resolved);
-                g_vulkan_depth_resolved = { 0 };
-                return;
-            }
-
-            g_vulkan_depth_resolved_w = bb_w;
-            g_vulkan_depth_resolved_h = bb_h;
-            g_vulkan_depth_resolved_format = g_vulkan_depth_candidate_format;
-            log_info("NFSTweakBridge: Created resolved depth target.\n");
-        }
-
-        // Insert resolve into command list
-        const resource src = g_vulkan_depth_candidate_res;
-        const resource dst = g_vulkan_depth_resolved;
+static void on_begin_render_pass(command_list *cmd_list, uint32_t count, const render_pass_render_target_desc *rts, const render_pass_depth_stencil_desc *ds)
+{
+    const uint64_t begin = qpc_now();
+    handle_begin_render_pass(cmd_list, count, rts, ds);
+    perf_add(k_perf_begin_render_pass, begin);
+}
 
-        // Best-effort transitions (exact prior state may differ across engines).
-        cmd_list->barrier(src, resource_usage::depth_stencil_write, resource_usage::resolve_source);
-        cmd_list->barrier(dst, resource_usage::resolve_dest, resource_usage::resolve_dest);
-        cmd_list->resolve_texture_region(src, 0, nullptr, dst, 0, 0, 0, 0, g_vulkan_depth_candidate_format);
-        cmd_list->barrier(src, resource_usage::resolve_source, resource_usage::depth_stencil_write);
+static void on_destroy_resource(device *device, resource res)
+{
+    if (device != g_device || res.handle == 0)
+        return;
+    remove_depth_candidate(res);
+    depth_class_on_destroy_resource(res);
+    if (depth_view_cache_evict_resource(device, res))
+        unbind_retired_runtime_depth_view();
+    // Bound depth went away: drop it so the next candidate binds without waiting for hysteresis.
+    if (g_runtime_depth_resource.handle == res.handle)
+    {
+        g_runtime_depth_srv = { 0 };
+        g_runtime_depth_resource = { 0 };
+        g_vulkan_depth_last_score = 0;
     }
 }
 
@@ -1017,6 +1209,7 @@ static bool on_clear_depth_stencil_view(command_list *, resource_view dsv, const
     if (g_runtime == nullptr || g_device == nullptr)
         return false;
     g_clear_counter.fetch_add(1, std::memory_order_relaxed);
+    depth_class_observe(dsv, false, false, true);
     // Low score: without RT context we may capture non-main-camera depth (mirror/reflection/shadow).
     try_bind_vulkan_depth(dsv, 0);
     return false; // do not block clear
@@ -1026,6 +1219,10 @@ static void on_reshade_reloaded_effects(effect_runtime *runtime)
 {
     if (runtime != g_runtime)
         return;
+    trace_span_scope span(k_span_reloaded_effects);
+    // Technique/texture/uniform handles are invalid after any reload, including debounced ones below.
+    invalidate_fx_products();
+    invalidate_camera_uniforms();
     const uint64_t frame = g_frame_index.load(std::memory_order_relaxed);
     const uint64_t last_manual = g_last_manual_prehud_frame.load(std::memory_order_relaxed);
     if (last_manual != 0 && frame > last_manual && (frame - last_manual) < 600)
@@ -1156,6 +1353,7 @@ void NFSTweak_PushDepthBufferR32F(const void* data, unsigned int width, unsigned
 // ---------- Process pending depth during present (ReShade thread/context) ----------
 static void ProcessPendingDepth()
 {
+    perf_scope_timer perf(k_perf_process_depth);
     // Called from present() where g_runtime and device are valid
     if (!g_runtime || !g_device) return;
     if (!g_enabled_for_runtime) return;
@@ -1164,14 +1362,14 @@ static void ProcessPendingDepth()
 
     // Throttle CPU readback to avoid hard stalls if the producer pushes every frame.
     // This is intentionally conservative: it keeps the game responsive while debugging.
-    LARGE_INTEGER freq = {}, now = {};
-    if (QueryPerformanceFrequency(&freq) && QueryPerformanceCounter(&now) && freq.QuadPart != 0)
+    const uint64_t freq = qpc_frequency();
+    if (freq != 0)
     {
-        const uint64_t now_qpc = static_cast<uint64_t>(now.QuadPart);
+        const uint64_t now_qpc = qpc_now();
         if (g_last_process_qpc != 0)
         {
             // 15 Hz max processing rate
-            const uint64_t min_delta = static_cast<uint64_t>(freq.QuadPart / 15);
+            const uint64_t min_delta = freq / 15;
             if (now_qpc - g_last_process_qpc < min_delta)
                 return;
         }
@@ -1224,6 +1422,7 @@ static void ProcessPendingDepth()
         sub_data.slice_pitch = static_cast<uint32_t>(g_last_width * g_last_height * sizeof(float));
 
         g_device->update_texture_region(sub_data, g_custom_depth, 0, nullptr);
+        g_depth_upload_bytes.fetch_add(sub_data.slice_pitch, std::memory_order_relaxed);
 
         // Consume
         g_has_depth_cpu = false;
@@ -1408,6 +1607,7 @@ static void ProcessPendingDepth()
         0,      // subresource
         nullptr // entire subresource
     );
+    g_depth_upload_bytes.fetch_add(sub_data.slice_pitch, std::memory_order_relaxed);
 
     // Release D3D9 device and surface
     d3d9_device->Release();
@@ -1427,6 +1627,7 @@ static void on_overlay_ui(effect_runtime *runtime)
 {
     if (!g_show_bridge_menu.load(std::memory_order_relaxed))
         return;
+    trace_span_scope span(k_span_overlay);
 
     if (!ImGui::Begin("NFSTweakBridge")) {
         ImGui::End();
@@ -1438,7 +1639,7 @@ static void on_overlay_ui(effect_runtime *runtime)
 
     const bool depth_incoming =
         (g_device_api == device_api::vulkan)
-        ? (g_runtime_depth_srv.handle != 0 || g_vulkan_depth_candidate_res.handle != 0)
+        ? (g_runtime_depth_srv.handle != 0 || g_depth_candidate_pick.res.handle != 0)
         : g_pending_depth.load();
     ImGui::Text("Depth incoming: %s", depth_incoming ? "Yes" : "No");
     ImGui::Text("PreHUD requests: %u", g_prehud_request_count.load());
@@ -1478,12 +1679,55 @@ static void on_overlay_ui(effect_runtime *runtime)
             g_lock_vulkan_depth.store(vk_lock);
 
         ImGui::Text("Vulkan candidate: %ux%u (samples=%u score=%u)",
-            g_vulkan_depth_candidate_w, g_vulkan_depth_candidate_h, g_vulkan_depth_candidate_samples, g_vulkan_depth_candidate_score);
+            g_depth_candidate_pick.w, g_depth_candidate_pick.h, g_depth_candidate_pick.samples, static_cast<uint32_t>(g_depth_candidate_pick.mean));
         ImGui::Text("Vulkan last score: %u", g_vulkan_depth_last_score);
+        ImGui::Text("Depth rebinds: %llu (avoided vs single-frame rule: %llu)",
+            static_cast<unsigned long long>(g_depth_rebinds.load(std::memory_order_relaxed)),
+            static_cast<unsigned long long>(g_depth_rebinds_avoided.load(std::memory_order_relaxed)));
+        for (uint32_t i = 0; i < k_depth_candidate_slots; ++i)
+        {
+            const depth_candidate_slot &c = g_depth_candidates[i];
+            if (c.res.handle == 0)
+                continue;
+            ImGui::Text("  %c res=%llu %ux%u mean=%.0f sd=%.0f frames=%u paired=%u pass=%u hits=%llu",
+                c.res.handle == g_runtime_depth_resource.handle ? '*' : ' ',
+                static_cast<unsigned long long>(c.res.handle), c.w, c.h, c.mean, std::sqrt(c.var),
+                c.frames_seen, c.paired_frames, c.last_first_pass, static_cast<unsigned long long>(c.total_hits));
+        }
+        bool depth_classes = g_enable_depth_classes.load();
+        if (ImGui::Checkbox("Vulkan: Classify/Publish Secondary Depths", &depth_classes))
+            g_enable_depth_classes.store(depth_classes);
+        ImGui::Text("Depth classes (epoch %u, binding updates %llu):", g_depth_class_epoch,
+            static_cast<unsigned long long>(g_depth_class_binding_updates.load(std::memory_order_relaxed)));
+        for (uint32_t i = 0; i < k_depth_class_slots; ++i)
+        {
+            const depth_class_slot &s = g_depth_class_table[i];
+            if (s.res.handle == 0)
+                continue;
+            const uint32_t c = static_cast<uint32_t>(s.cls);
+            ImGui::Text("  %c res=%llu %ux%u fmt=%u %-7s frames=%u color=%u depth_only=%u bb=%u clear_only=%u",
+                (s.res.handle == (s.cls == depth_class::main ? g_runtime_depth_resource : g_depth_class_bound_res[c]).handle) ? '*' : ' ',
+                static_cast<unsigned long long>(s.res.handle), s.w, s.h, static_cast<unsigned>(s.fmt),
+                s.decided ? k_depth_class_names[c] : "?",
+                s.frames_seen, s.color_frames, s.depth_only_frames, s.bb_frames, s.clear_only_frames);
+        }
+        ImGui::Text("Depth view cache: hits=%llu misses=%llu evicted=%llu destroyed=%llu",
+            static_cast<unsigned long long>(g_depth_view_cache_hits.load(std::memory_order_relaxed)),
+            static_cast<unsigned long long>(g_depth_view_cache_misses.load(std::memory_order_relaxed)),
+            static_cast<unsigned long long>(g_depth_view_cache_evictions.load(std::memory_order_relaxed)),
+            static_cast<unsigned long long>(g_depth_view_cache_destroy_evictions.load(std::memory_order_relaxed)));
+        ImGui::Text("Depth binding updates: %llu (skipped unchanged: %llu)",
+            static_cast<unsigned long long>(g_depth_binding_updates.load(std::memory_order_relaxed)),
+            static_cast<unsigned long long>(g_depth_binding_skips.load(std::memory_order_relaxed)));
         ImGui::Text("PreHUD skip frames after reload: %d", g_skip_manual_prehud_frames.load());
         ImGui::Text("PreHUD runtime state: %d", g_prehud_runtime_state.load());
         ImGui::Text("PreHUD settle frames: %d", g_transition_settle_frames.load());
         ImGui::Text("PreHUD signature streak: %d/%d", g_scene_signature_streak, k_prehud_streak_required);
+        ImGui::Text("PreHUD invariants: checks=%llu double_frame=%llu double_token=%llu unlocked_pair=%llu",
+            static_cast<unsigned long long>(g_prehud_invariant_checks.load(std::memory_order_relaxed)),
+            static_cast<unsigned long long>(g_prehud_invariant_double_frame.load(std::memory_order_relaxed)),
+            static_cast<unsigned long long>(g_prehud_invariant_double_token.load(std::memory_order_relaxed)),
+            static_cast<unsigned long long>(g_prehud_invariant_unlocked_pair.load(std::memory_order_relaxed)));
         if (g_runtime && g_device)
         {
             const resource back = g_runtime->get_current_back_buffer();
@@ -1498,6 +1742,79 @@ static void on_overlay_ui(effect_runtime *runtime)
         bool vk_resolve = g_enable_vulkan_msaa_resolve.load();
         if (ImGui::Checkbox("Vulkan: Enable MSAA Depth Resolve", &vk_resolve))
             g_enable_vulkan_msaa_resolve.store(vk_resolve);
+        ImGui::Text("MSAA depth resolve: %s (resolves=%llu unsupported=%llu)",
+            g_msaa_resolve_supported ? "supported" : "unsupported by device",
+            static_cast<unsigned long long>(g_msaa_resolve_count.load(std::memory_order_relaxed)),
+            static_cast<unsigned long long>(g_msaa_resolve_unsupported.load(std::memory_order_relaxed)));
+
+        bool vk_snapshot = g_enable_depth_snapshot.load();
+        if (ImGui::Checkbox("Vulkan: Snapshot Depth At Pre-HUD", &vk_snapshot))
+        {
+            g_enable_depth_snapshot.store(vk_snapshot);
+            if (!vk_snapshot)
+            {
+                // Hand NFSTWEAK_DEPTH back to the live/resolved view before releasing the copies.
+                bind_runtime_depth_view(g_runtime_depth_srv);
+                g_runtime->update_texture_bindings(k_runtime_depth_prev_semantic, resource_view { 0 }, resource_view { 0 });
+                destroy_depth_snapshot();
+            }
+        }
+        ImGui::Text("Depth snapshot: %ux%u (copies=%llu)", g_depth_snapshot_w, g_depth_snapshot_h,
+            static_cast<unsigned long long>(g_depth_snapshot_count.load(std::memory_order_relaxed)));
+        for (uint32_t scope = 0; scope < k_timer_scope_count; ++scope)
+            ImGui::Text("  %-16s cpu %.3f ms  gpu %.3f ms", k_timer_scope_names[scope], g_cpu_timer_ms[scope], g_gpu_timer_ms[scope]);
+        if (g_gpu_timer_heap.handle == 0)
+            ImGui::TextUnformatted("  (GPU timestamps unavailable)");
+
+        {
+            std::lock_guard<std::mutex> lock(g_timeline_mutex);
+            ImGui::Text("Frame timeline: frames=%llu bridge events=%llu last bridge frame=%u",
+                static_cast<unsigned long long>(g_timeline_frames),
+                static_cast<unsigned long long>(g_timeline_bridge_events.load(std::memory_order_relaxed)),
+                g_timeline_last_bridge_frame.load(std::memory_order_relaxed));
+            for (uint32_t stage = 0; stage < k_stage_count; ++stage)
+            {
+                const timeline_histogram &h = g_timeline_hist[stage];
+                ImGui::Text("  %-22s n=%u last %.2f  p50 %.2f  p95 %.2f  max %.2f ms", k_timeline_stage_names[stage], h.count,
+                    h.last_us / 1000.0f, timeline_percentile_us(h, 50) / 1000.0f, timeline_percentile_us(h, 95) / 1000.0f, h.max_us / 1000.0f);
+            }
+        }
+        if (ImGui::Button("Reset Frame Timeline"))
+            reset_timeline();
+        if (ImGui::Button("Export Chrome Trace (Ctrl+F11)"))
+            g_trace_export_requested.store(true, std::memory_order_relaxed);
+        ImGui::SameLine();
+        ImGui::Text("%s exports=%llu dropped records=%llu",
+            g_trace_export_busy.load(std::memory_order_relaxed) ? "writing..." : "idle",
+            static_cast<unsigned long long>(g_trace_exports.load(std::memory_order_relaxed)),
+            static_cast<unsigned long long>(g_trace_dropped.load(std::memory_order_relaxed)));
+        ImGui::Text("Log sink: %s queued=%llu written=%llu dropped=%llu rate-limited=%llu",
+            g_log_sink_running.load(std::memory_order_relaxed) ? "async" : "sync",
+            static_cast<unsigned long long>(g_log_lines_queued.load(std::memory_order_relaxed)),
+            static_cast<unsigned long long>(g_log_lines_written.load(std::memory_order_relaxed)),
+            static_cast<unsigned long long>(g_log_lines_dropped.load(std::memory_order_relaxed)),
+            static_cast<unsigned long long>(g_log_lines_rate_limited.load(std::memory_order_relaxed)));
+
+        {
+            std::lock_guard<std::mutex> lock(g_camera_mutex);
+            ImGui::Text("Camera feed: pushes=%llu rejected=%llu frame=%u flags=0x%x near=%.2f far=%.1f fov=%.1f deg consumers=%u",
+                static_cast<unsigned long long>(g_camera_push_count.load(std::memory_order_relaxed)),
+                static_cast<unsigned long long>(g_camera_push_rejected.load(std::memory_order_relaxed)),
+                g_camera_state.frame, g_camera_state.flags, g_camera_state.near_plane, g_camera_state.far_plane,
+                g_camera_state.fov_y * 57.29578f, static_cast<unsigned>(g_camera_uniforms.size()));
+        }
+        for (uint32_t i = 0; i < k_fx_product_count; ++i)
+        {
+            const fx_product &p = g_fx_products[i];
+            char label[96] = {};
+            sprintf_s(label, "Vulkan: Publish %s (%s)", p.semantic, p.effect_file);
+            bool enabled = p.enabled->load();
+            if (ImGui::Checkbox(label, &enabled))
+                p.enabled->store(enabled);
+            ImGui::Text("  %-20s %s %ux%u runs=%llu", p.semantic,
+                p.tech.handle != 0 ? "loaded" : (p.resolved ? "missing" : "pending"),
+                p.out_w, p.out_h, static_cast<unsigned long long>(p.runs));
+        }
 
         ImGui::TextUnformatted("Pre-HUD pass runs from RT/DSV bind callback (Vulkan-safe path).");
     }
@@ -1505,6 +1822,33 @@ static void on_overlay_ui(effect_runtime *runtime)
     if (g_width && g_height)
         ImGui::Text("Current Depth Size: %u x %u", g_width, g_height);
 
+    if (ImGui::CollapsingHeader("Add-on Cost"))
+    {
+        ImGui::Text("Callback CPU time over the last %u frames:", g_perf_hist[k_perf_present].count);
+        for (uint32_t scope = 0; scope < k_perf_scope_count; ++scope)
+        {
+            const perf_window_histogram &h = g_perf_hist[scope];
+            ImGui::Text("  %-20s p50 %.3f  p99 %.3f  last %.3f ms  calls/frame %u", k_perf_scope_names[scope],
+                perf_percentile_us(h, 50) / 1000.0f, perf_percentile_us(h, 99) / 1000.0f, h.last_us / 1000.0f, g_perf_last_calls[scope]);
+        }
+        const float last_frame_ms = g_perf_frame_ms[(g_perf_window_pos + k_perf_window - 1) % k_perf_window];
+        char overlay[32] = {};
+        sprintf_s(overlay, "%.2f ms", last_frame_ms);
+        ImGui::PlotLines("Frame time", g_perf_frame_ms, static_cast<int>(k_perf_window), static_cast<int>(g_perf_window_pos),
+            overlay, 0.0f, 50.0f, ImVec2(0.0f, 60.0f));
+        if (g_gpu_timer_heap.handle != 0)
+            ImGui::Text("Pre-HUD effects: gpu %.3f ms  cpu %.3f ms",
+                g_gpu_timer_ms[k_timer_prehud_effects], g_cpu_timer_ms[k_timer_prehud_effects]);
+        else
+            ImGui::Text("Pre-HUD effects: cpu %.3f ms (GPU timestamps unavailable)", g_cpu_timer_ms[k_timer_prehud_effects]);
+        ImGui::Text("Depth uploads: %.1f KB/s  view creations: %.1f/s  binding updates: %.1f/s",
+            g_perf_rate_per_s[k_rate_depth_upload_bytes] / 1024.0,
+            g_perf_rate_per_s[k_rate_view_creations],
+            g_perf_rate_per_s[k_rate_binding_updates]);
+        if (ImGui::Button("Reset Add-on Cost"))
+            reset_perf_dashboard();
+    }
+
     if (ImGui::Button("ProcessPendingDepth"))
         ProcessPendingDepth();
 
@@ -1513,8 +1857,10 @@ static void on_overlay_ui(effect_runtime *runtime)
 
 static void on_reshade_begin_effects(effect_runtime *runtime, command_list *cmd_list, resource_view, resource_view)
 {
+    perf_scope_timer perf(k_perf_begin_effects);
     if (!g_runtime_alive.load(std::memory_order_relaxed))
         return;
+    trace_span_begin(k_span_reshade_effects);
 
     if (runtime != g_runtime)
         return;
@@ -1545,13 +1891,12 @@ static void on_reshade_begin_effects(effect_runtime *runtime, command_list *cmd_
         if (manual)
         {
             ++s_manual_begin;
-            if (s_manual_begin <= 2 || (s_manual_begin % 1200) == 0)
+            static log_rate_limit s_manual_begin_log(2, 10000);
+            if (log_rate_allow(s_manual_begin_log))
             {
-                char msg[192] = {};
-                sprintf_s(msg, "NFSTweakBridge: begin_effects manual=%llu frame=%llu\n",
+                log_infof("NFSTweakBridge: begin_effects manual=%llu frame=%llu\n",
                     static_cast<unsigned long long>(s_manual_begin),
                     static_cast<unsigned long long>(frame));
-                log_info(msg);
             }
         }
         else
@@ -1560,15 +1905,14 @@ static void on_reshade_begin_effects(effect_runtime *runtime, command_list *cmd_
             if (g_block_current_reshade_effects_pass.load(std::memory_order_relaxed))
                 g_diag_nonmanual_blocked_this_frame.fetch_add(1, std::memory_order_relaxed);
             ++s_nonmanual_begin;
-            if (s_nonmanual_begin <= 4 || (s_nonmanual_begin % 2400) == 0)
+            static log_rate_limit s_nonmanual_begin_log(4, 20000);
+            if (log_rate_allow(s_nonmanual_begin_log))
             {
-                char msg[224] = {};
-                sprintf_s(msg, "NFSTweakBridge: begin_effects non-manual=%llu blocked=%d fallback=%d frame=%llu\n",
+                log_infof("NFSTweakBridge: begin_effects non-manual=%llu blocked=%d fallback=%d frame=%llu\n",
                     static_cast<unsigned long long>(s_nonmanual_begin),
                     g_block_current_reshade_effects_pass.load(std::memory_order_relaxed) ? 1 : 0,
                     allow_fallback_this_begin ? 1 : 0,
                     static_cast<unsigned long long>(frame));
-                log_info(msg);
             }
         }
     }
@@ -1577,6 +1921,8 @@ static void on_reshade_begin_effects(effect_runtime *runtime, command_list *cmd_
 static void on_reshade_finish_effects(effect_runtime *, command_list *, resource_view, resource_view)
 {
     g_block_current_reshade_effects_pass.store(false, std::memory_order_relaxed);
+    if (g_runtime_alive.load(std::memory_order_relaxed))
+        trace_span_end(k_span_reshade_effects);
 }
 
 static bool on_draw_block_effects(command_list *, uint32_t, uint32_t, uint32_t, uint32_t)
@@ -1610,6 +1956,8 @@ static void on_init_effect_runtime(effect_runtime *runtime)
     g_device_api = g_device ? g_device->get_api() : device_api::d3d9;
     g_seen_reload_settle.store(false, std::memory_order_relaxed);
     g_disable_beginpass_after_fault.store(false, std::memory_order_relaxed);
+    start_log_sink();
+    reset_perf_dashboard();
     log_info("NFSTweakBridge: init_effect_runtime\n");
 
     // Vulkan/DXVK: Do not create any placeholder resources here (this has been observed to hang on some setups).
@@ -1626,7 +1974,8 @@ static void on_init_effect_runtime(effect_runtime *runtime)
         g_require_vulkan_backbuffer_rt.store(false);
         g_lock_vulkan_depth.store(false);
         g_require_vulkan_backbuffer_match.store(false);
-        g_enable_vulkan_msaa_resolve.store(false);
+        g_msaa_resolve_supported = g_device->check_capability(device_caps::resolve_depth_stencil);
+        init_gpu_timers(runtime);
         g_enable_vulkan_beginpass_prehud.store(false);
         reset_prehud_transition("NFSTweakBridge: Initial runtime settle before pre-HUD activation.\n", 60);
         log_info("NFSTweakBridge: Vulkan runtime detected (DXVK). Using Vulkan bind hook.\n");
@@ -1660,13 +2009,20 @@ static void on_destroy_effect_runtime(effect_runtime *runtime)
     g_manual_effects_frame.store(0, std::memory_order_relaxed);
     g_block_current_reshade_effects_pass.store(false, std::memory_order_relaxed);
 
-    // Destroy any Vulkan-bound SRV (resource belongs to app/runtime, view belongs to us).
-    if (g_runtime_depth_srv.handle != 0 && g_device)
-    {
-        g_device->destroy_resource_view(g_runtime_depth_srv);
-        g_runtime_depth_srv = { 0 };
-        g_runtime_depth_resource = { 0 };
-    }
+    // Destroy cached Vulkan depth SRVs (resources belong to app/runtime, views belong to us).
+    depth_view_cache_clear(g_device);
+    g_runtime_depth_srv = { 0 };
+    g_runtime_depth_resource = { 0 };
+    clear_depth_candidate_table(resource { 0 });
+    reset_vulkan_depth_candidate();
+    g_depth_candidate_pick = {};
+    reset_depth_classes();
+    destroy_fx_products();
+    invalidate_camera_uniforms();
+    destroy_depth_snapshot();
+    destroy_msaa_resolve_pool();
+    destroy_gpu_timers();
+    reset_timeline();
 
     // destroy resource views + resource
     if (g_custom_depth_view.handle) g_device->destroy_resource_view(g_custom_depth_view);
@@ -1707,6 +2063,10 @@ static void on_destroy_effect_runtime(effect_runtime *runtime)
     g_scene_window_close_frame.store(0, std::memory_order_relaxed);
     g_last_precip_signal_value.store(0xFFFFFFFFu, std::memory_order_relaxed);
     g_last_precip_signal_frame.store(0, std::memory_order_relaxed);
+
+    wait_trace_export();
+    // Last: flushes whatever the teardown above logged.
+    stop_log_sink();
 }
 
 // Present hook: run ProcessPendingDepth early in frame so ReShade effects can use it
@@ -1715,7 +2075,26 @@ static void on_present(command_queue*, swapchain*, const rect*, const rect*, uin
     if (!g_runtime_alive.load(std::memory_order_relaxed))
         return;
 
+    perf_scope_timer perf(k_perf_present);
     const uint64_t frame = g_frame_index.fetch_add(1, std::memory_order_relaxed) + 1;
+    trace_span_scope span(k_span_present);
+    const uint64_t perf_counters[k_rate_count] = {
+        g_depth_upload_bytes.load(std::memory_order_relaxed),
+        g_depth_view_cache_misses.load(std::memory_order_relaxed),
+        g_depth_binding_updates.load(std::memory_order_relaxed) + g_depth_class_binding_updates.load(std::memory_order_relaxed),
+    };
+    perf_end_frame(perf_counters);
+    collect_gpu_timers(frame);
+    publish_camera_uniforms();
+    timeline_frame_result timeline = {};
+    if (timeline_complete_frame(timeline))
+    {
+        // kind=5: stage latencies in us, two per 64-bit field (see prehud_trace_dump).
+        prehud_trace_push(5, frame, timeline.bridge_frame,
+            (static_cast<uint64_t>(timeline.stage_us[k_stage_predisplay_token]) << 32) | timeline.stage_us[k_stage_token_pass],
+            (static_cast<uint64_t>(timeline.stage_us[k_stage_pass_render]) << 32) | timeline.stage_us[k_stage_render_present],
+            timeline.stage_us[k_stage_total], timeline.token, timeline.stage_mask);
+    }
     g_frame_beginpass_start.store(g_beginpass_counter.load(std::memory_order_relaxed), std::memory_order_relaxed);
     const bool manual_rendered_prev = g_pre_hud_effects_issued_this_frame.load(std::memory_order_relaxed);
     const uint32_t nonmanual_begin_prev = g_diag_nonmanual_begin_this_frame.load(std::memory_order_relaxed);
@@ -1803,6 +2182,15 @@ static void on_present(command_queue*, swapchain*, const rect*, const rect*, uin
     }
     prev_f10_down = f10_down;
 
+    static bool prev_f11_down = false;
+    const bool f11_down = (GetAsyncKeyState(VK_F11) & 0x8000) != 0;
+    if ((f11_down && !prev_f11_down && ctrl_down) || g_trace_export_requested.exchange(false, std::memory_order_relaxed))
+    {
+        log_info("NFSTweakBridge: Ctrl+F11 -> exporting Chrome trace.\n");
+        prehud_trace_export_chrome();
+    }
+    prev_f11_down = f11_down;
+
     // Vulkan path: choose/bind once per frame (reduces flicker and avoids partial binds).
     if (g_device_api == device_api::vulkan)
     {
@@ -1867,7 +2255,6 @@ static void on_present(command_queue*, swapchain*, const rect*, const rect*, uin
             }
         }
 
-        g_enable_vulkan_msaa_resolve.store(false, std::memory_order_relaxed);
         const prehud_runtime_state state = static_cast<prehud_runtime_state>(g_prehud_runtime_state.load(std::memory_order_relaxed));
         if (state == prehud_runtime_state::stabilizing)
         {
@@ -1913,6 +2300,7 @@ static void on_present(command_queue*, swapchain*, const rect*, const rect*, uin
         // Strict lock mode: keep locked signature across temporary pass misses.
         // Do not auto-release lock here; resets happen on explicit reload/runtime re-init paths.
         bind_vulkan_candidate_if_good();
+        update_depth_classes();
         return;
     }
 
@@ -0,0 +1,226 @@
+// ---------- Cross-module frame timeline ----------
+// The bridge stamps PreDisplay_Render and token emission (QPC + bridge frame) through NFSTweak_MarkTimelineEvent;
+// the add-on stamps the qualifying pass, the end of render_effects and present. QPC is process-wide, so stamps
+// from both modules are directly comparable. Stage latencies of every rendered frame go into log2-microsecond
+// histograms (overlay) and one kind=5 trace entry. Bridge hook spans and the stamped window/precipitation/phase
+// notifications arrive through the same export but only go to the trace rings.
+
+enum timeline_stage : uint32_t
+{
+    k_stage_predisplay_token = 0, // PreDisplay_Render(0) -> token emitted
+    k_stage_token_pass,           // token emitted -> qualifying pass reached
+    k_stage_pass_render,          // qualifying pass -> render_effects returned
+    k_stage_render_present,       // render_effects returned -> present
+    k_stage_total,                // PreDisplay_Render(0) -> present
+    k_stage_count
+};
+static const char *const k_timeline_stage_names[k_stage_count] = {
+    "predisplay -> token",
+    "token -> pass",
+    "pass -> render",
+    "render -> present",
+    "predisplay -> present",
+};
+
+struct timeline_slot
+{
+    uint32_t bridge_frame;
+    uint32_t token;
+    uint64_t predisplay_qpc;
+    uint64_t token_qpc;
+    uint64_t pass_qpc;
+    uint64_t render_qpc;
+};
+
+// Bucket b holds [2^b, 2^(b+1)) us (bucket 0 also holds 0); the last bucket is open-ended (> ~0.5 s).
+static constexpr uint32_t k_timeline_buckets = 20;
+struct timeline_histogram
+{
+    uint32_t buckets[k_timeline_buckets];
+    uint32_t count;
+    uint32_t last_us;
+    uint32_t max_us;
+};
+
+// A handful of bridge frames in flight: the DXVK CS thread can lag the game thread by a frame or two.
+static constexpr uint32_t k_timeline_slots = 8;
+static std::mutex g_timeline_mutex;
+static timeline_slot g_timeline_slots[k_timeline_slots] = {};
+static int32_t g_timeline_pending_slot = -1; // slot rendered this frame, completed at present
+static timeline_histogram g_timeline_hist[k_stage_count] = {};
+static uint64_t g_timeline_frames = 0;
+static std::atomic_uint64_t g_timeline_bridge_events(0);
+static std::atomic_uint32_t g_timeline_last_bridge_frame(0);
+
+static void trace_span_mark(bool begin, uint32_t span, uint32_t detail, uint32_t frame, uint64_t qpc);
+static void trace_bridge_event(uint32_t event, uint32_t value, uint32_t frame, uint64_t qpc);
+
+struct timeline_frame_result
+{
+    uint32_t bridge_frame;
+    uint32_t token;
+    uint32_t stage_us[k_stage_count];
+    uint32_t stage_mask; // bit per timeline_stage that had both stamps
+};
+
+static uint32_t timeline_ticks_to_us(uint64_t from_qpc, uint64_t to_qpc)
+{
+    const uint64_t freq = qpc_frequency();
+    if (freq == 0 || to_qpc < from_qpc)
+        return 0;
+    const uint64_t us = ((to_qpc - from_qpc) * 1000000ull) / freq;
+    return us > 0xFFFFFFFFull ? 0xFFFFFFFFu : static_cast<uint32_t>(us);
+}
+
+static void timeline_histogram_add(timeline_histogram &h, uint32_t us)
+{
+    uint32_t bucket = 0;
+    while (bucket + 1 < k_timeline_buckets && (us >> (bucket + 1)) != 0)
+        ++bucket;
+    ++h.buckets[bucket];
+    ++h.count;
+    h.last_us = us;
+    h.max_us = std::max(h.max_us, us);
+}
+
+// Upper bound of the bucket holding the pct-th percentile, clamped to the observed max.
+static uint32_t timeline_percentile_us(const timeline_histogram &h, uint32_t pct)
+{
+    if (h.count == 0)
+        return 0;
+    const uint64_t target = (static_cast<uint64_t>(h.count) * pct + 99) / 100;
+    uint64_t seen = 0;
+    for (uint32_t b = 0; b < k_timeline_buckets; ++b)
+    {
+        seen += h.buckets[b];
+        if (seen >= target)
+            return std::min(h.max_us, (2u << b) - 1u);
+    }
+    return h.max_us;
+}
+
+static timeline_slot &timeline_slot_for_bridge_frame(uint32_t bridge_frame)
+{
+    timeline_slot &slot = g_timeline_slots[bridge_frame % k_timeline_slots];
+    if (slot.bridge_frame != bridge_frame)
+    {
+        slot = {};
+        slot.bridge_frame = bridge_frame;
+    }
+    return slot;
+}
+
+extern "C" __declspec(dllexport)
+void NFSTweak_MarkTimelineEvent(unsigned int event, unsigned int bridge_frame, unsigned int value, unsigned long long qpc)
+{
+    if (event == NFSTWEAK_TIMELINE_SPAN_BEGIN || event == NFSTWEAK_TIMELINE_SPAN_END)
+    {
+        // Recorded on the calling (game) thread's ring, whether or not an effect runtime exists.
+        trace_span_mark(event == NFSTWEAK_TIMELINE_SPAN_BEGIN, value & 0xFFu, value >> 8, bridge_frame, qpc);
+        return;
+    }
+    if (event >= NFSTWEAK_TIMELINE_WINDOW_BEGIN && event <= NFSTWEAK_TIMELINE_PHASE_INVALIDATE)
+    {
+        // Window, precipitation and phase notifications: instant events on the game thread's ring.
+        trace_bridge_event(event, value, bridge_frame, qpc);
+        g_timeline_bridge_events.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (!g_runtime_alive.load(std::memory_order_relaxed) || bridge_frame == 0)
+        return;
+    if (qpc == 0)
+        qpc = qpc_now();
+
+    std::lock_guard<std::mutex> lock(g_timeline_mutex);
+    timeline_slot &slot = timeline_slot_for_bridge_frame(bridge_frame);
+    switch (event)
+    {
+    case NFSTWEAK_TIMELINE_PREDISPLAY:
+        slot.predisplay_qpc = qpc;
+        break;
+    case NFSTWEAK_TIMELINE_TOKEN:
+        // Keep the first emit of the frame (FE overlays can emit more than once).
+        if (slot.token_qpc == 0)
+        {
+            slot.token_qpc = qpc;
+            slot.token = value;
+        }
+        break;
+    default:
+        return;
+    }
+    g_timeline_bridge_events.fetch_add(1, std::memory_order_relaxed);
+    g_timeline_last_bridge_frame.store(bridge_frame, std::memory_order_relaxed);
+}
+
+// Qualifying pass reached for `token`: attach to the newest bridge frame that emitted it.
+static void timeline_mark_pass(uint32_t token)
+{
+    const uint64_t now = qpc_now();
+    std::lock_guard<std::mutex> lock(g_timeline_mutex);
+    int32_t best = -1;
+    for (uint32_t i = 0; i < k_timeline_slots; ++i)
+    {
+        const timeline_slot &slot = g_timeline_slots[i];
+        if (slot.bridge_frame == 0 || slot.pass_qpc != 0)
+            continue;
+        if (token != 0 && slot.token != token)
+            continue;
+        if (best < 0 || slot.bridge_frame > g_timeline_slots[best].bridge_frame)
+            best = static_cast<int32_t>(i);
+    }
+    g_timeline_pending_slot = best;
+    if (best >= 0)
+        g_timeline_slots[best].pass_qpc = now;
+}
+
+static void timeline_mark_render()
+{
+    const uint64_t now = qpc_now();
+    std::lock_guard<std::mutex> lock(g_timeline_mutex);
+    if (g_timeline_pending_slot >= 0)
+        g_timeline_slots[g_timeline_pending_slot].render_qpc = now;
+}
+
+// Called at present: closes the frame rendered since the last present. Returns false when nothing was rendered.
+static bool timeline_complete_frame(timeline_frame_result &out)
+{
+    const uint64_t now = qpc_now();
+    std::lock_guard<std::mutex> lock(g_timeline_mutex);
+    if (g_timeline_pending_slot < 0)
+        return false;
+    const timeline_slot slot = g_timeline_slots[g_timeline_pending_slot];
+    g_timeline_pending_slot = -1;
+    if (slot.render_qpc == 0)
+        return false;
+
+    const uint64_t stamps[k_stage_count][2] = {
+        { slot.predisplay_qpc, slot.token_qpc },
+        { slot.token_qpc, slot.pass_qpc },
+        { slot.pass_qpc, slot.render_qpc },
+        { slot.render_qpc, now },
+        { slot.predisplay_qpc, now },
+    };
+    out = {};
+    out.bridge_frame = slot.bridge_frame;
+    out.token = slot.token;
+    for (uint32_t s = 0; s < k_stage_count; ++s)
+    {
+        if (stamps[s][0] == 0 || stamps[s][1] < stamps[s][0])
+            continue;
+        out.stage_us[s] = timeline_ticks_to_us(stamps[s][0], stamps[s][1]);
+        out.stage_mask |= 1u << s;
+        timeline_histogram_add(g_timeline_hist[s], out.stage_us[s]);
+    }
+    ++g_timeline_frames;
+    return true;
+}
+
+static void reset_timeline()
+{
+    std::lock_guard<std::mutex> lock(g_timeline_mutex);
+    memset(g_timeline_slots, 0, sizeof(g_timeline_slots));
+    memset(g_timeline_hist, 0, sizeof(g_timeline_hist));
+    g_timeline_pending_slot = -1;
+    g_timeline_frames = 0;
+}
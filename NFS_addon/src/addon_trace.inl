@@ -0,0 +1,783 @@
+// ---------- Pre-HUD trace rings ----------
+// Every thread that traces gets its own byte ring: one writer, no contention, records published with a release store of
+// the ring head. Records are variable length (trailing zero payload words are dropped), sequence-stamped per ring and
+// QPC-stamped, so the dump can merge all rings by time. RT/DS handle pairs are interned into 32-bit signature ids.
+// A reader copies [tail, head) and then re-reads tail (seqlock style): the writer advances tail, with a release fence,
+// before it overwrites old records, so anything below the re-read tail may be torn and is discarded.
+// Besides the pass records, the rings carry begin/end pairs for bridge hooks (sent through NFSTweak_MarkTimelineEvent)
+// and add-on callbacks; Ctrl+F11 exports everything as Chrome trace-event JSON (chrome://tracing, ui.perfetto.dev).
+// Rings and signatures live in one trace_store, which DllMain maps onto NFSTweakBridge_FlightRecorder.bin (layout in
+// NFSTweakTraceFile.h): the OS keeps the pages after a crash and tools/nfs_trace_decode.cpp reads them back.
+// A ring belongs to its thread until DLL_THREAD_DETACH; an exited thread's records stay readable until a new thread
+// takes the ring over, and only when every ring belongs to a live thread are further threads' records dropped.
+
+static constexpr bool k_enable_prehud_trace = true;
+static constexpr bool k_sample_render_trace = false;
+
+// Pass records (render..invariant) carry: frame, bp, signature id, token, score, reason.
+enum prehud_trace_kind : uint8_t
+{
+    k_trace_wrap = NFSTWEAK_TRACE_KIND_WRAP,
+    k_trace_render = NFSTWEAK_TRACE_KIND_RENDER,
+    k_trace_skip = NFSTWEAK_TRACE_KIND_SKIP,
+    k_trace_transition = NFSTWEAK_TRACE_KIND_TRANSITION,
+    k_trace_invariant = NFSTWEAK_TRACE_KIND_INVARIANT,
+    k_trace_timeline = NFSTWEAK_TRACE_KIND_TIMELINE,     // payload: frame, bridge frame, token, total us, stage mask, 4 stage us
+    k_trace_span_begin = NFSTWEAK_TRACE_KIND_SPAN_BEGIN, // payload: span id, detail, frame
+    k_trace_span_end = NFSTWEAK_TRACE_KIND_SPAN_END,
+    k_trace_bridge_event = NFSTWEAK_TRACE_KIND_BRIDGE_EVENT, // payload: NFSTWEAK_TIMELINE_* event, value, bridge frame
+};
+
+// Span ids below k_span_addon_first are the bridge's NFSTWEAK_SPAN_* values.
+enum trace_span_id : uint32_t
+{
+    k_span_addon_first = 16,
+    k_span_present = k_span_addon_first,
+    k_span_render_effects,      // manual pre-HUD render_effects call
+    k_span_reshade_effects,     // reshade_begin_effects -> reshade_finish_effects
+    k_span_reloaded_effects,
+    k_span_overlay,
+};
+
+static const char *trace_span_name(uint32_t span)
+{
+    switch (span)
+    {
+    case NFSTWEAK_SPAN_PREDISPLAY_RENDER: return "PreDisplay_Render";
+    case NFSTWEAK_SPAN_SUB_516F70: return "sub_516F70";
+    case NFSTWEAK_SPAN_FEMANAGER_RENDER: return "FEManager_Render";
+    case k_span_present: return "present";
+    case k_span_render_effects: return "render_effects (pre-HUD)";
+    case k_span_reshade_effects: return "ReShade effects";
+    case k_span_reloaded_effects: return "reshade_reloaded_effects";
+    case k_span_overlay: return "reshade_overlay";
+    default: return "span";
+    }
+}
+
+using trace_record_header = NFSTweakTraceRecordHeader;
+static_assert(sizeof(trace_record_header) == 12, "trace record header must stay packed");
+
+// ~70 KB in total. A pass record is 28-32 bytes, so each ring keeps ~550 of them: one ring alone holds more than the
+// 512 slots (28 KB) the old trace array shared between all threads. Tracing threads are the game's render thread plus
+// a few short-lived ReShade/loader threads, which rings are recycled for.
+static constexpr uint32_t k_trace_ring_bytes = 16 * 1024;
+static constexpr uint32_t k_trace_ring_count = 4;
+static constexpr uint32_t k_trace_max_words = 12;
+
+struct trace_ring
+{
+    std::atomic_uint64_t head;  // bytes ever written (next record position)
+    std::atomic_uint64_t tail;  // position of the oldest intact record
+    std::atomic_uint32_t thread_id;
+    uint32_t seq;               // writer-only
+    uint8_t data[k_trace_ring_bytes];
+};
+
+// RT/DS pair -> id (slot + 1). Insert-only open addressing; a slot is claimed by CAS and published once its keys are set.
+// A frame binds a few dozen distinct pairs; when the table is full, new pairs are recorded without a signature (id 0).
+static constexpr uint32_t k_trace_signature_slots = 256;
+struct trace_signature_slot
+{
+    std::atomic_uint32_t state; // 0 = empty, 1 = being written, 2 = ready
+    std::atomic_uint64_t rtv;
+    std::atomic_uint64_t dsv;
+};
+
+// Everything the flight recorder file holds, in file order. All-zero is a valid empty store.
+struct trace_store
+{
+    NFSTweakTraceFileHeader header;
+    trace_signature_slot signatures[k_trace_signature_slots];
+    trace_ring rings[k_trace_ring_count];
+};
+static_assert(sizeof(trace_signature_slot) == sizeof(NFSTweakTraceFileSignature) &&
+    offsetof(trace_signature_slot, rtv) == offsetof(NFSTweakTraceFileSignature, rtv), "signature slot must match the file layout");
+static_assert(offsetof(trace_ring, tail) == offsetof(NFSTweakTraceFileRing, tail) &&
+    offsetof(trace_ring, thread_id) == offsetof(NFSTweakTraceFileRing, thread_id) &&
+    offsetof(trace_ring, data) == sizeof(NFSTweakTraceFileRing), "trace ring must match the file layout");
+
+static trace_store g_trace_memory_store;                  // used when the file can't be mapped
+static trace_store *g_trace_store = &g_trace_memory_store; // switched before anything traces (DllMain)
+// Ring ownership, outside the file: free (never used), owned by a live thread, or released by an exited one.
+enum trace_ring_state : uint32_t
+{
+    k_trace_ring_free,
+    k_trace_ring_owned,
+    k_trace_ring_released,
+};
+static std::atomic_uint32_t g_trace_ring_state[k_trace_ring_count];
+static std::atomic_uint64_t g_trace_ring_released_at[k_trace_ring_count]; // release order, for reusing the oldest first
+static std::atomic_uint64_t g_trace_ring_releases(0);
+static std::atomic_uint64_t g_trace_dropped(0);
+static std::atomic_uint32_t g_trace_rings_recycled(0);
+static std::atomic_uint32_t g_trace_signature_count(0);
+static thread_local trace_ring *t_trace_ring = nullptr;
+
+static uint32_t trace_intern_signature(uint64_t rtv, uint64_t dsv)
+{
+    if (rtv == 0 && dsv == 0)
+        return 0;
+    uint64_t h = (rtv * 0x9E3779B97F4A7C15ull) ^ (dsv + 0x632BE59BD9B4E019ull + (rtv << 6));
+    h ^= h >> 29;
+    for (uint32_t probe = 0; probe < k_trace_signature_slots; ++probe)
+    {
+        const uint32_t index = static_cast<uint32_t>(h + probe) & (k_trace_signature_slots - 1);
+        trace_signature_slot &slot = g_trace_store->signatures[index];
+        uint32_t state = slot.state.load(std::memory_order_acquire);
+        if (state == 0)
+        {
+            if (slot.state.compare_exchange_strong(state, 1, std::memory_order_acq_rel))
+            {
+                slot.rtv.store(rtv, std::memory_order_relaxed);
+                slot.dsv.store(dsv, std::memory_order_relaxed);
+                slot.state.store(2, std::memory_order_release);
+                g_trace_signature_count.fetch_add(1, std::memory_order_relaxed);
+                return index + 1;
+            }
+        }
+        while (state == 1) // another thread is publishing this slot: two stores away
+            state = slot.state.load(std::memory_order_acquire);
+        if (slot.rtv.load(std::memory_order_relaxed) == rtv && slot.dsv.load(std::memory_order_relaxed) == dsv)
+            return index + 1;
+    }
+    return 0; // table full
+}
+
+static bool trace_signature_lookup(uint32_t id, uint64_t &rtv, uint64_t &dsv)
+{
+    if (id == 0 || id > k_trace_signature_slots)
+        return false;
+    const trace_signature_slot &slot = g_trace_store->signatures[id - 1];
+    if (slot.state.load(std::memory_order_acquire) != 2)
+        return false;
+    rtv = slot.rtv.load(std::memory_order_relaxed);
+    dsv = slot.dsv.load(std::memory_order_relaxed);
+    return true;
+}
+
+static trace_ring *trace_claim_ring(uint32_t index, bool recycled)
+{
+    trace_ring *const ring = &g_trace_store->rings[index];
+    if (recycled)
+    {
+        // Retire the previous thread's records before any record is attributed to this thread.
+        ring->tail.store(ring->head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        g_trace_rings_recycled.fetch_add(1, std::memory_order_relaxed);
+    }
+    ring->thread_id.store(GetCurrentThreadId(), std::memory_order_release);
+    t_trace_ring = ring;
+    return ring;
+}
+
+// Unused rings first, then the ring released longest ago, so the most recent records of exited threads survive.
+static trace_ring *trace_thread_ring()
+{
+    if (t_trace_ring != nullptr)
+        return t_trace_ring;
+    for (uint32_t i = 0; i < k_trace_ring_count; ++i)
+    {
+        uint32_t expected = k_trace_ring_free;
+        if (g_trace_ring_state[i].compare_exchange_strong(expected, k_trace_ring_owned, std::memory_order_acquire))
+            return trace_claim_ring(i, false);
+    }
+    for (;;)
+    {
+        uint32_t oldest = k_trace_ring_count;
+        uint64_t oldest_release = UINT64_MAX;
+        for (uint32_t i = 0; i < k_trace_ring_count; ++i)
+        {
+            if (g_trace_ring_state[i].load(std::memory_order_relaxed) != k_trace_ring_released)
+                continue;
+            const uint64_t released_at = g_trace_ring_released_at[i].load(std::memory_order_relaxed);
+            if (released_at < oldest_release)
+            {
+                oldest = i;
+                oldest_release = released_at;
+            }
+        }
+        if (oldest == k_trace_ring_count)
+            return nullptr; // every ring belongs to a live thread
+        uint32_t expected = k_trace_ring_released;
+        if (g_trace_ring_state[oldest].compare_exchange_strong(expected, k_trace_ring_owned, std::memory_order_acquire))
+            return trace_claim_ring(oldest, true);
+    }
+}
+
+// DllMain thread detach, on the exiting thread.
+static void trace_release_thread_ring()
+{
+    if (t_trace_ring == nullptr)
+        return;
+    const uint32_t index = static_cast<uint32_t>(t_trace_ring - g_trace_store->rings);
+    t_trace_ring = nullptr;
+    if (index < k_trace_ring_count)
+    {
+        g_trace_ring_released_at[index].store(g_trace_ring_releases.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+        g_trace_ring_state[index].store(k_trace_ring_released, std::memory_order_release);
+    }
+}
+
+// Size of the record starting at ring position `pos`, or the distance to the wrap point for a filler.
+static uint32_t trace_record_span(const trace_ring &ring, uint64_t pos)
+{
+    const uint32_t offset = static_cast<uint32_t>(pos % k_trace_ring_bytes);
+    const uint8_t kind = ring.data[offset];
+    if (kind == k_trace_wrap)
+        return k_trace_ring_bytes - offset;
+    return static_cast<uint32_t>(sizeof(trace_record_header)) + 4u * ring.data[offset + 1];
+}
+
+// `qpc` must not go backwards on a thread: the exporter relies on per-ring order for begin/end nesting.
+static void trace_write_at(uint8_t kind, uint64_t qpc, const uint32_t *words, uint32_t count)
+{
+    trace_ring *const ring = trace_thread_ring();
+    if (ring == nullptr)
+    {
+        g_trace_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    while (count > 0 && words[count - 1] == 0)
+        --count;
+    count = std::min(count, k_trace_max_words);
+
+    const uint32_t size = static_cast<uint32_t>(sizeof(trace_record_header)) + 4u * count;
+    uint64_t pos = ring->head.load(std::memory_order_relaxed);
+    const uint32_t offset = static_cast<uint32_t>(pos % k_trace_ring_bytes);
+    const uint32_t filler = (offset + size > k_trace_ring_bytes) ? (k_trace_ring_bytes - offset) : 0u;
+
+    // Retire the oldest records this write will overwrite, and publish that before touching their bytes.
+    uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+    const uint64_t end = pos + filler + size;
+    if (end - tail > k_trace_ring_bytes)
+    {
+        while (end - tail > k_trace_ring_bytes)
+            tail += trace_record_span(*ring, tail);
+        ring->tail.store(tail, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    if (filler != 0)
+    {
+        ring->data[offset] = k_trace_wrap; // records are 4-byte aligned, so a filler always has room for its kind byte
+        pos += filler;
+    }
+    trace_record_header header = {};
+    header.kind = kind;
+    header.words = static_cast<uint8_t>(count);
+    header.seq = static_cast<uint16_t>(ring->seq++);
+    header.qpc = qpc;
+    uint8_t *const dst = ring->data + (pos % k_trace_ring_bytes);
+    memcpy(dst, &header, sizeof(header));
+    memcpy(dst + sizeof(header), words, 4u * count);
+    ring->head.store(pos + size, std::memory_order_release);
+}
+
+static void trace_write(uint8_t kind, const uint32_t *words, uint32_t count)
+{
+    trace_write_at(kind, qpc_now(), words, count);
+}
+
+static void trace_span_mark(bool begin, uint32_t span, uint32_t detail, uint32_t frame, uint64_t qpc)
+{
+    if (!k_enable_prehud_trace)
+        return;
+    const uint32_t words[] = { span, detail, frame };
+    trace_write_at(begin ? k_trace_span_begin : k_trace_span_end, qpc != 0 ? qpc : qpc_now(), words, static_cast<uint32_t>(std::size(words)));
+}
+
+static void trace_bridge_event(uint32_t event, uint32_t value, uint32_t frame, uint64_t qpc)
+{
+    if (!k_enable_prehud_trace)
+        return;
+    const uint32_t words[] = { event, value, frame };
+    trace_write_at(k_trace_bridge_event, qpc != 0 ? qpc : qpc_now(), words, static_cast<uint32_t>(std::size(words)));
+}
+
+static const char *bridge_event_name(uint32_t event)
+{
+    switch (event)
+    {
+    case NFSTWEAK_TIMELINE_WINDOW_BEGIN: return "BeginPreHudWindow";
+    case NFSTWEAK_TIMELINE_WINDOW_END: return "EndPreHudWindow";
+    case NFSTWEAK_TIMELINE_PRECIPITATION: return "NotifyPrecipitationChanged";
+    case NFSTWEAK_TIMELINE_PHASE_INVALIDATE: return "NotifyPhaseInvalidate";
+    default: return "bridge event";
+    }
+}
+
+static void trace_span_begin(uint32_t span)
+{
+    trace_span_mark(true, span, 0, static_cast<uint32_t>(g_frame_index.load(std::memory_order_relaxed)), 0);
+}
+
+static void trace_span_end(uint32_t span)
+{
+    trace_span_mark(false, span, 0, static_cast<uint32_t>(g_frame_index.load(std::memory_order_relaxed)), 0);
+}
+
+// Spans a whole callback. Not usable in functions with __try (no unwinding objects there): call begin/end directly.
+struct trace_span_scope
+{
+    explicit trace_span_scope(uint32_t span) : span(span) { trace_span_begin(span); }
+    ~trace_span_scope() { trace_span_end(span); }
+    trace_span_scope(const trace_span_scope &) = delete;
+    trace_span_scope &operator=(const trace_span_scope &) = delete;
+    const uint32_t span;
+};
+
+static void prehud_trace_push(uint32_t kind, uint64_t frame, uint64_t bp, uint64_t rtv, uint64_t dsv, uint32_t score, uint32_t token, uint32_t reason)
+{
+    if (!k_enable_prehud_trace)
+        return;
+    // Optional sampling for high-frequency render events.
+    // Diagnostics build can disable this to capture every preHUD render.
+    if (k_sample_render_trace && kind == k_trace_render && (frame % 4) != 0)
+        return;
+    if (kind == k_trace_timeline)
+    {
+        // rtv/dsv carry two packed us values each (see on_present).
+        const uint32_t words[] = { static_cast<uint32_t>(frame), static_cast<uint32_t>(bp), token, score, reason,
+            static_cast<uint32_t>(rtv >> 32), static_cast<uint32_t>(rtv), static_cast<uint32_t>(dsv >> 32), static_cast<uint32_t>(dsv) };
+        trace_write(k_trace_timeline, words, static_cast<uint32_t>(std::size(words)));
+        return;
+    }
+    const uint32_t words[] = { static_cast<uint32_t>(frame), static_cast<uint32_t>(bp), trace_intern_signature(rtv, dsv), token, score, reason };
+    trace_write(static_cast<uint8_t>(kind), words, static_cast<uint32_t>(std::size(words)));
+}
+
+struct trace_dump_record
+{
+    trace_record_header header;
+    uint32_t thread_id;
+    uint32_t words[k_trace_max_words];
+};
+
+// Snapshot of one ring: every record that stayed intact for the whole copy.
+static void trace_collect_ring(const trace_ring &ring, std::vector<trace_dump_record> &out)
+{
+    static uint8_t s_copy[k_trace_ring_bytes]; // dump and export collect on one thread (present-time hotkeys)
+    const uint32_t thread_id = ring.thread_id.load(std::memory_order_acquire);
+    if (thread_id == 0)
+        return;
+    const uint64_t head = ring.head.load(std::memory_order_acquire);
+    const uint64_t tail = ring.tail.load(std::memory_order_acquire);
+    if (head <= tail || head - tail > k_trace_ring_bytes)
+        return;
+    const uint32_t begin = static_cast<uint32_t>(tail % k_trace_ring_bytes);
+    const uint32_t length = static_cast<uint32_t>(head - tail);
+    const uint32_t first = std::min(length, k_trace_ring_bytes - begin);
+    memcpy(s_copy + begin, ring.data + begin, first);
+    memcpy(s_copy, ring.data, length - first);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    // Tail only ever moves to record boundaries, so parsing can start at the re-read tail.
+    const uint64_t valid_from = std::max(tail, ring.tail.load(std::memory_order_relaxed));
+    // A new thread took the ring over during the copy: its records must not carry the old thread id.
+    if (ring.thread_id.load(std::memory_order_relaxed) != thread_id)
+        return;
+
+    for (uint64_t pos = valid_from; pos < head;)
+    {
+        const uint32_t offset = static_cast<uint32_t>(pos % k_trace_ring_bytes);
+        if (s_copy[offset] == k_trace_wrap)
+        {
+            pos += k_trace_ring_bytes - offset;
+            continue;
+        }
+        trace_dump_record rec = {};
+        memcpy(&rec.header, s_copy + offset, sizeof(rec.header));
+        if (rec.header.words > k_trace_max_words)
+            break;
+        memcpy(rec.words, s_copy + offset + sizeof(rec.header), 4u * rec.header.words);
+        rec.thread_id = thread_id;
+        out.push_back(rec);
+        pos += sizeof(rec.header) + 4u * rec.header.words;
+    }
+}
+
+// All rings merged by QPC (stable, so records of one thread keep their ring order). Returns the number of rings in use.
+static uint32_t trace_collect_all(std::vector<trace_dump_record> &records)
+{
+    uint32_t rings = 0;
+    for (uint32_t i = 0; i < k_trace_ring_count; ++i)
+    {
+        if (g_trace_ring_state[i].load(std::memory_order_acquire) == k_trace_ring_free)
+            continue;
+        trace_collect_ring(g_trace_store->rings[i], records);
+        ++rings;
+    }
+    std::stable_sort(records.begin(), records.end(), [](const trace_dump_record &a, const trace_dump_record &b) {
+        return a.header.qpc < b.header.qpc;
+    });
+    return rings;
+}
+
+// `file_name` next to the game executable (working directory if that fails).
+static std::string trace_output_path(const char *file_name)
+{
+    char exe_path[MAX_PATH] = {};
+    const DWORD n = GetModuleFileNameA(nullptr, exe_path, MAX_PATH);
+    if (n > 0 && n < MAX_PATH)
+    {
+        std::string exe(exe_path, n);
+        const size_t slash = exe.find_last_of("\\/");
+        if (slash != std::string::npos)
+            return exe.substr(0, slash + 1) + file_name;
+    }
+    return file_name;
+}
+
+static void prehud_trace_dump(uint32_t max_entries)
+{
+    if (!k_enable_prehud_trace)
+        return;
+
+    std::vector<trace_dump_record> records;
+    const uint32_t rings = trace_collect_all(records);
+    // Spans only go to the Chrome export.
+    records.erase(std::remove_if(records.begin(), records.end(), [](const trace_dump_record &r) {
+        return r.header.kind == k_trace_span_begin || r.header.kind == k_trace_span_end;
+    }), records.end());
+    const uint32_t available = static_cast<uint32_t>(records.size());
+    const uint32_t count = (max_entries < available) ? max_entries : available;
+    const std::string dump_path = trace_output_path("NFSTweakBridge_TraceDump.log");
+
+    std::ofstream out(dump_path.c_str(), std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+    {
+        char msg[320] = {};
+        sprintf_s(msg, "NFSTweakBridge: TRACE DUMP failed to open '%s' (err=%lu)\n", dump_path.c_str(), GetLastError());
+        log_info(msg);
+        return;
+    }
+
+    out << "NFSTweakBridge TRACE DUMP begin (entries=" << count << ", available=" << available
+        << ", rings=" << rings << ", signatures=" << g_trace_signature_count.load(std::memory_order_relaxed)
+        << ", recycled=" << g_trace_rings_recycled.load(std::memory_order_relaxed)
+        << ", dropped=" << static_cast<unsigned long long>(g_trace_dropped.load(std::memory_order_relaxed)) << ")\n";
+    if (count == 0)
+    {
+        out << "NFSTweakBridge TRACE DUMP empty\n";
+    }
+    else
+    {
+        const uint64_t base_qpc = records[available - count].header.qpc;
+        for (uint32_t i = available - count; i < available; ++i)
+        {
+            const trace_dump_record &r = records[i];
+            const uint32_t *const w = r.words; // trimmed words read back as zero
+            char stamp[96] = {};
+            sprintf_s(stamp, "t=%.3fms tid=%u seq=%u", qpc_to_ms(r.header.qpc - base_qpc), r.thread_id, static_cast<uint32_t>(r.header.seq));
+            if (r.header.kind == k_trace_timeline)
+            {
+                out << "NFSTimeline: " << stamp
+                    << " frame=" << w[0]
+                    << " bridge_frame=" << w[1]
+                    << " token=" << w[2]
+                    << " predisplay_token_us=" << w[5]
+                    << " token_pass_us=" << w[6]
+                    << " pass_render_us=" << w[7]
+                    << " render_present_us=" << w[8]
+                    << " total_us=" << w[3]
+                    << " stages=0x" << std::hex << std::uppercase << w[4] << std::dec << "\n";
+                continue;
+            }
+            if (r.header.kind == k_trace_bridge_event)
+            {
+                out << "NFSBridge: " << stamp
+                    << " event=" << bridge_event_name(w[0])
+                    << " bridge_frame=" << w[2]
+                    << " value=" << w[1] << "\n";
+                continue;
+            }
+            uint64_t rtv = 0, dsv = 0;
+            trace_signature_lookup(w[2], rtv, dsv);
+            out << "NFSTrace: " << stamp
+                << " kind=" << static_cast<uint32_t>(r.header.kind)
+                << " frame=" << w[0]
+                << " bp=" << w[1]
+                << " token=" << w[3]
+                << " sig=" << w[2]
+                << " rtv=" << static_cast<unsigned long long>(rtv)
+                << " dsv=" << static_cast<unsigned long long>(dsv)
+                << " score=" << w[4]
+                << " reason=0x" << std::hex << std::uppercase << w[5] << std::dec << "\n";
+        }
+    }
+    out << "NFSTweakBridge TRACE DUMP end\n";
+    out.flush();
+    out.close();
+
+    char ok_msg[320] = {};
+    sprintf_s(ok_msg, "NFSTweakBridge: TRACE DUMP wrote '%s' (entries=%u)\n", dump_path.c_str(), count);
+    log_info(ok_msg);
+}
+
+// ---------- Chrome trace-event export ----------
+// Tracks: pid 1 = bridge hooks (on the game threads that called them), pid 2 = add-on callback spans and pass records
+// (instant events), pid 2 / tid 1 = frame stages rebuilt from kind=5 records. Rings are collected on the caller (a few
+// memcpys); formatting and file I/O run on a worker thread.
+
+static constexpr uint32_t k_chrome_pid_bridge = 1;
+static constexpr uint32_t k_chrome_pid_addon = 2;
+static constexpr uint32_t k_chrome_tid_stages = 1; // Windows thread ids are multiples of 4
+
+struct trace_export_job
+{
+    std::vector<trace_dump_record> records;
+    std::string path;
+    uint32_t rings;
+};
+static std::atomic_bool g_trace_export_busy(false);
+static std::atomic_bool g_trace_export_requested(false); // overlay button; handled with the hotkeys
+static std::atomic_uint64_t g_trace_exports(0);
+static HANDLE g_trace_export_thread = nullptr;
+
+static const char *trace_kind_name(uint8_t kind)
+{
+    switch (kind)
+    {
+    case k_trace_render: return "render";
+    case k_trace_skip: return "skip";
+    case k_trace_transition: return "transition";
+    case k_trace_invariant: return "invariant";
+    default: return "record";
+    }
+}
+
+static void trace_write_chrome_json(const trace_export_job &job)
+{
+    std::ofstream out(job.path.c_str(), std::ios::out | std::ios::trunc);
+    if (!out.is_open())
+    {
+        log_infof("NFSTweakBridge: TRACE EXPORT failed to open '%s' (err=%lu)\n", job.path.c_str(), GetLastError());
+        return;
+    }
+
+    const std::vector<trace_dump_record> &records = job.records;
+    const uint64_t base_qpc = records.empty() ? 0 : records.front().header.qpc;
+    const uint64_t freq = qpc_frequency();
+    const auto ts_us = [&](uint64_t qpc) {
+        return freq != 0 ? static_cast<double>(static_cast<int64_t>(qpc - base_qpc)) * 1000000.0 / static_cast<double>(freq) : 0.0;
+    };
+
+    char line[512];
+    bool first = true;
+    const auto emit = [&]() {
+        out << (first ? "\n" : ",\n") << line;
+        first = false;
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    sprintf_s(line, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":0,\"args\":{\"name\":\"NFS bridge hooks\"}}", k_chrome_pid_bridge);
+    emit();
+    sprintf_s(line, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":0,\"args\":{\"name\":\"NFSTweak add-on\"}}", k_chrome_pid_addon);
+    emit();
+    sprintf_s(line, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"frame stages\"}}", k_chrome_pid_addon, k_chrome_tid_stages);
+    emit();
+
+    // Open span depth per track. An end whose begin was overwritten (ring wrapped in between) is dropped so viewers
+    // don't close an unrelated span.
+    struct track_depth
+    {
+        uint32_t pid;
+        uint32_t tid;
+        uint32_t depth;
+    };
+    std::vector<track_depth> tracks;
+    const auto depth_of = [&](uint32_t pid, uint32_t tid) -> uint32_t & {
+        for (track_depth &t : tracks)
+            if (t.pid == pid && t.tid == tid)
+                return t.depth;
+        tracks.push_back({ pid, tid, 0 });
+        return tracks.back().depth;
+    };
+
+    uint32_t events = 0;
+    for (const trace_dump_record &r : records)
+    {
+        const uint32_t *const w = r.words;
+        const double ts = ts_us(r.header.qpc);
+        switch (r.header.kind)
+        {
+        case k_trace_span_begin:
+        case k_trace_span_end:
+        {
+            const bool begin = r.header.kind == k_trace_span_begin;
+            const uint32_t pid = w[0] < k_span_addon_first ? k_chrome_pid_bridge : k_chrome_pid_addon;
+            uint32_t &depth = depth_of(pid, r.thread_id);
+            if (!begin && depth == 0)
+                continue;
+            if (begin)
+                ++depth;
+            else
+                --depth;
+            sprintf_s(line, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"args\":{\"frame\":%u,\"detail\":%u}}",
+                trace_span_name(w[0]), pid == k_chrome_pid_bridge ? "bridge" : "addon", begin ? 'B' : 'E', pid, r.thread_id, ts, w[2], w[1]);
+            break;
+        }
+        case k_trace_bridge_event:
+            sprintf_s(line, "{\"name\":\"%s\",\"cat\":\"bridge\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"args\":{\"frame\":%u,\"value\":%u}}",
+                bridge_event_name(w[0]), k_chrome_pid_bridge, r.thread_id, ts, w[2], w[1]);
+            break;
+        case k_trace_timeline:
+        {
+            // Stages end at the record (written at present); walk back from render -> present while stages are contiguous.
+            double end = ts;
+            for (int32_t stage = k_stage_render_present; stage >= 0; --stage)
+            {
+                if ((w[4] & (1u << stage)) == 0)
+                    break;
+                const double dur = static_cast<double>(w[5 + stage]);
+                sprintf_s(line, "{\"name\":\"%s\",\"cat\":\"timeline\",\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%u,\"bridge_frame\":%u,\"token\":%u}}",
+                    k_timeline_stage_names[stage], k_chrome_pid_addon, k_chrome_tid_stages, end - dur, dur, w[0], w[1], w[2]);
+                emit();
+                ++events;
+                end -= dur;
+            }
+            continue;
+        }
+        default:
+        {
+            uint64_t rtv = 0, dsv = 0;
+            trace_signature_lookup(w[2], rtv, dsv);
+            sprintf_s(line, "{\"name\":\"%s\",\"cat\":\"prehud\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f,"
+                "\"args\":{\"frame\":%u,\"bp\":%u,\"token\":%u,\"sig\":%u,\"rtv\":%llu,\"dsv\":%llu,\"score\":%u,\"reason\":%u}}",
+                trace_kind_name(r.header.kind), k_chrome_pid_addon, r.thread_id, ts,
+                w[0], w[1], w[3], w[2], static_cast<unsigned long long>(rtv), static_cast<unsigned long long>(dsv), w[4], w[5]);
+            break;
+        }
+        }
+        emit();
+        ++events;
+    }
+    out << "\n]}\n";
+    out.close();
+
+    g_trace_exports.fetch_add(1, std::memory_order_relaxed);
+    log_infof("NFSTweakBridge: TRACE EXPORT wrote '%s' (records=%u events=%u rings=%u)\n",
+        job.path.c_str(), static_cast<uint32_t>(records.size()), events, job.rings);
+}
+
+static DWORD WINAPI trace_export_thread(LPVOID param)
+{
+    trace_export_job *const job = static_cast<trace_export_job *>(param);
+    trace_write_chrome_json(*job);
+    delete job;
+    g_trace_export_busy.store(false, std::memory_order_release);
+    return 0;
+}
+
+// Joins the last export worker; called before a new export and from destroy_effect_runtime.
+static void wait_trace_export()
+{
+    if (g_trace_export_thread == nullptr)
+        return;
+    WaitForSingleObject(g_trace_export_thread, INFINITE);
+    CloseHandle(g_trace_export_thread);
+    g_trace_export_thread = nullptr;
+}
+
+static void prehud_trace_export_chrome()
+{
+    if (!k_enable_prehud_trace)
+        return;
+    if (g_trace_export_busy.exchange(true, std::memory_order_acq_rel))
+    {
+        log_info("NFSTweakBridge: TRACE EXPORT already running.\n");
+        return;
+    }
+    wait_trace_export(); // busy was clear, so this only reaps the finished worker
+
+    trace_export_job *const job = new trace_export_job();
+    job->rings = trace_collect_all(job->records);
+    job->path = trace_output_path("NFSTweakBridge_Trace.json");
+    g_trace_export_thread = CreateThread(nullptr, 0, trace_export_thread, job, 0, nullptr);
+    if (g_trace_export_thread == nullptr)
+    {
+        trace_export_thread(job); // no worker: write inline
+        return;
+    }
+    SetThreadPriority(g_trace_export_thread, THREAD_PRIORITY_BELOW_NORMAL);
+}
+
+// ---------- Flight recorder file ----------
+// The store is a shared file mapping, so every record write is already in the file's pages; a crashed or killed
+// process leaves them for the OS to write back. The previous session's file is kept as *.prev.bin.
+
+static HANDLE g_trace_file = INVALID_HANDLE_VALUE;
+static HANDLE g_trace_mapping = nullptr;
+
+// DllMain attach, before any callback or export can trace: kernel32 file calls only.
+static void open_trace_flight_recorder()
+{
+    if (!k_enable_prehud_trace || g_trace_store != &g_trace_memory_store)
+        return;
+    const std::string path = trace_output_path("NFSTweakBridge_FlightRecorder.bin");
+    MoveFileExA(path.c_str(), trace_output_path("NFSTweakBridge_FlightRecorder.prev.bin").c_str(), MOVEFILE_REPLACE_EXISTING);
+
+    // No write sharing: a second game instance falls back to the in-memory store instead of clobbering this file.
+    const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    const HANDLE mapping = (file != INVALID_HANDLE_VALUE) ? CreateFileMappingA(file, nullptr, PAGE_READWRITE, 0, sizeof(trace_store), nullptr) : nullptr;
+    void *const view = (mapping != nullptr) ? MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, sizeof(trace_store)) : nullptr;
+    if (view == nullptr)
+    {
+        const DWORD error = GetLastError();
+        if (mapping != nullptr)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+        log_infof("NFSTweakBridge: Flight recorder unavailable (err=%lu); trace stays in memory.\n", error);
+        return;
+    }
+
+    trace_store *const store = new (view) trace_store();
+    NFSTweakTraceFileHeader &h = store->header;
+    memcpy(h.magic, NFSTWEAK_TRACE_FILE_MAGIC, sizeof(h.magic));
+    h.version = NFSTWEAK_TRACE_FILE_VERSION;
+    h.header_size = sizeof(NFSTweakTraceFileHeader);
+    h.signatures_offset = static_cast<uint32_t>(offsetof(trace_store, signatures));
+    h.signature_count = k_trace_signature_slots;
+    h.signature_stride = sizeof(trace_signature_slot);
+    h.rings_offset = static_cast<uint32_t>(offsetof(trace_store, rings));
+    h.ring_count = k_trace_ring_count;
+    h.ring_stride = sizeof(trace_ring);
+    h.ring_data_offset = static_cast<uint32_t>(offsetof(trace_ring, data));
+    h.ring_data_bytes = k_trace_ring_bytes;
+    h.qpc_frequency = qpc_frequency();
+    h.open_qpc = qpc_now();
+    h.process_id = GetCurrentProcessId();
+    std::atomic_ref<uint32_t>(h.state).store(NFSTWEAK_TRACE_STATE_OPEN, std::memory_order_release);
+
+    g_trace_file = file;
+    g_trace_mapping = mapping;
+    g_trace_store = store;
+    log_infof("NFSTweakBridge: Flight recorder mapped '%s' (%u bytes).\n", path.c_str(), static_cast<uint32_t>(sizeof(trace_store)));
+}
+
+// DllMain detach. On process exit other threads may still be frozen mid-write, so the view stays mapped; on FreeLibrary
+// nothing of ours runs anymore and the mapping is released.
+static void close_trace_flight_recorder(bool process_exit)
+{
+    if (g_trace_store == &g_trace_memory_store)
+        return;
+    std::atomic_ref<uint32_t>(g_trace_store->header.state).store(NFSTWEAK_TRACE_STATE_CLOSED, std::memory_order_release);
+    FlushViewOfFile(g_trace_store, 0);
+    if (process_exit)
+        return;
+    UnmapViewOfFile(g_trace_store);
+    CloseHandle(g_trace_mapping);
+    CloseHandle(g_trace_file);
+    g_trace_store = &g_trace_memory_store;
+    g_trace_mapping = nullptr;
+    g_trace_file = INVALID_HANDLE_VALUE;
+}
+
+// From the render_effects __except handlers: the decoder reports the count and when the last one fired.
+static void trace_note_fault()
+{
+    NFSTweakTraceFileHeader &h = g_trace_store->header;
+    std::atomic_ref<uint64_t>(h.last_fault_qpc).store(qpc_now(), std::memory_order_relaxed);
+    std::atomic_ref<uint32_t>(h.faults).fetch_add(1, std::memory_order_release);
+}
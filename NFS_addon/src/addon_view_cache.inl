@@ -0,0 +1,176 @@
+// ---------- Depth SRV view cache ----------
+// Small LRU of shader resource views over app-owned depth resources.
+// Candidate switches (rain/mirror passes) then only cost a binding update instead of a view create/destroy.
+// Entries are dropped when the app destroys the underlying resource (destroy_resource event).
+
+struct depth_view_cache_entry
+{
+    resource res;
+    resource_view view;
+    resource_view_type type;
+    format fmt;
+    uint32_t first_level;
+    uint32_t level_count;
+    uint32_t first_layer;
+    uint32_t layer_count;
+    uint64_t last_use;
+    uint32_t pins; // bitmask of extra semantics publishing this view (see addon_depth_classes.inl)
+};
+static constexpr uint32_t k_depth_view_cache_capacity = 8;
+static depth_view_cache_entry g_depth_view_cache[k_depth_view_cache_capacity] = {};
+static uint32_t g_depth_view_cache_count = 0;
+static uint64_t g_depth_view_cache_clock = 0;
+static std::mutex g_depth_view_cache_mutex;
+static std::atomic_uint64_t g_depth_view_cache_hits(0);
+static std::atomic_uint64_t g_depth_view_cache_misses(0);
+static std::atomic_uint64_t g_depth_view_cache_evictions(0);
+static std::atomic_uint64_t g_depth_view_cache_destroy_evictions(0);
+
+// Last view published under the runtime depth semantic(s); used to skip redundant binding updates.
+static resource_view g_bound_runtime_depth_view = { 0 };
+static bool g_bound_runtime_depth_mirror = false;
+// View evicted while still bound: effects may reference it until the next binding update, so destroy it then.
+static resource_view g_retired_runtime_depth_view = { 0 };
+static std::atomic_uint64_t g_depth_binding_updates(0);
+static std::atomic_uint64_t g_depth_binding_skips(0);
+
+static bool depth_view_cache_key_equal(const depth_view_cache_entry &e, resource res, const resource_view_desc &desc)
+{
+    return e.res.handle == res.handle &&
+        e.type == desc.type &&
+        e.fmt == desc.format &&
+        e.first_level == desc.texture.first_level &&
+        e.level_count == desc.texture.level_count &&
+        e.first_layer == desc.texture.first_layer &&
+        e.layer_count == desc.texture.layer_count;
+}
+
+// Returns a cached SRV for (resource, format, subresource range), creating it on miss.
+// 'keep_view' is never evicted (the currently bound view).
+static resource_view depth_view_cache_acquire(device *dev, resource res, const resource_view_desc &desc, resource_view keep_view)
+{
+    if (dev == nullptr || res.handle == 0)
+        return { 0 };
+
+    std::lock_guard<std::mutex> lock(g_depth_view_cache_mutex);
+    const uint64_t now = ++g_depth_view_cache_clock;
+    for (uint32_t i = 0; i < g_depth_view_cache_count; ++i)
+    {
+        depth_view_cache_entry &e = g_depth_view_cache[i];
+        if (depth_view_cache_key_equal(e, res, desc))
+        {
+            e.last_use = now;
+            g_depth_view_cache_hits.fetch_add(1, std::memory_order_relaxed);
+            return e.view;
+        }
+    }
+
+    resource_view view = { 0 };
+    if (!dev->create_resource_view(res, resource_usage::shader_resource, desc, &view))
+        return { 0 };
+    g_depth_view_cache_misses.fetch_add(1, std::memory_order_relaxed);
+
+    uint32_t slot = g_depth_view_cache_count;
+    if (slot == k_depth_view_cache_capacity)
+    {
+        // Evict least recently used entry that is neither the bound view nor pinned by another semantic.
+        slot = k_depth_view_cache_capacity;
+        for (uint32_t i = 0; i < k_depth_view_cache_capacity; ++i)
+        {
+            if (g_depth_view_cache[i].view.handle == keep_view.handle || g_depth_view_cache[i].pins != 0)
+                continue;
+            if (slot == k_depth_view_cache_capacity || g_depth_view_cache[i].last_use < g_depth_view_cache[slot].last_use)
+                slot = i;
+        }
+        if (slot == k_depth_view_cache_capacity)
+        {
+            dev->destroy_resource_view(view);
+            return { 0 };
+        }
+        dev->destroy_resource_view(g_depth_view_cache[slot].view);
+        g_depth_view_cache_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        ++g_depth_view_cache_count;
+    }
+
+    depth_view_cache_entry &e = g_depth_view_cache[slot];
+    e.res = res;
+    e.view = view;
+    e.type = desc.type;
+    e.fmt = desc.format;
+    e.first_level = desc.texture.first_level;
+    e.level_count = desc.texture.level_count;
+    e.first_layer = desc.texture.first_layer;
+    e.layer_count = desc.texture.layer_count;
+    e.last_use = now;
+    e.pins = 0;
+    return view;
+}
+
+// Marks/unmarks a cached view as published under an extra semantic so LRU eviction leaves it alone.
+static void depth_view_cache_set_pin(resource_view view, uint32_t pin_bit, bool pinned)
+{
+    if (view.handle == 0)
+        return;
+    std::lock_guard<std::mutex> lock(g_depth_view_cache_mutex);
+    for (uint32_t i = 0; i < g_depth_view_cache_count; ++i)
+    {
+        depth_view_cache_entry &e = g_depth_view_cache[i];
+        if (e.view.handle != view.handle)
+            continue;
+        e.pins = pinned ? (e.pins | pin_bit) : (e.pins & ~pin_bit);
+        return;
+    }
+}
+
+// Drops every cached view over 'res'. Returns true if any entry was removed.
+static bool depth_view_cache_evict_resource(device *dev, resource res)
+{
+    if (res.handle == 0)
+        return false;
+
+    std::lock_guard<std::mutex> lock(g_depth_view_cache_mutex);
+    bool removed = false;
+    for (uint32_t i = 0; i < g_depth_view_cache_count;)
+    {
+        if (g_depth_view_cache[i].res.handle != res.handle)
+        {
+            ++i;
+            continue;
+        }
+        if (g_depth_view_cache[i].view.handle == g_bound_runtime_depth_view.handle)
+        {
+            if (dev != nullptr && g_retired_runtime_depth_view.handle != 0)
+                dev->destroy_resource_view(g_retired_runtime_depth_view);
+            g_retired_runtime_depth_view = g_depth_view_cache[i].view;
+        }
+        else if (dev != nullptr)
+        {
+            dev->destroy_resource_view(g_depth_view_cache[i].view);
+        }
+        g_depth_view_cache[i] = g_depth_view_cache[--g_depth_view_cache_count];
+        g_depth_view_cache[g_depth_view_cache_count] = {};
+        g_depth_view_cache_destroy_evictions.fetch_add(1, std::memory_order_relaxed);
+        removed = true;
+    }
+    return removed;
+}
+
+static void depth_view_cache_clear(device *dev)
+{
+    std::lock_guard<std::mutex> lock(g_depth_view_cache_mutex);
+    for (uint32_t i = 0; i < g_depth_view_cache_count; ++i)
+    {
+        if (dev != nullptr && g_depth_view_cache[i].view.handle != 0)
+            dev->destroy_resource_view(g_depth_view_cache[i].view);
+        g_depth_view_cache[i] = {};
+    }
+    g_depth_view_cache_count = 0;
+    if (dev != nullptr && g_retired_runtime_depth_view.handle != 0)
+        dev->destroy_resource_view(g_retired_runtime_depth_view);
+    g_retired_runtime_depth_view = { 0 };
+    g_bound_runtime_depth_view = { 0 };
+    g_bound_runtime_depth_mirror = false;
+}
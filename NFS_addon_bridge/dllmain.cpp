@@ -4,12 +4,14 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cmath>
 #include <cstdio>
 #include <cstdint>
 #include <mutex>
 #include <vector>
 
 #include <injector.hpp>
+#include <transaction.hpp>
 
 // Used to get this DLL module handle without depending on DllMain parameter plumbing.
 extern "C" IMAGE_DOS_HEADER __ImageBase;
@@ -17,31 +19,25 @@ extern "C" IMAGE_DOS_HEADER __ImageBase;
 #if GAME_MW
 #include "../includes/NFSMW_PreFEngHook.h"
 #endif
+#include "../includes/NFSTweakBridgeAPI.h"
 
 // The bridge is the "producer":
 // It captures depth (best-effort) and forwards it to the ReShade add-on ("consumer") via exported functions.
 
-using PFN_NFSTweak_PushDepthSurface = void(__cdecl *)(void *d3d9_surface, unsigned int width, unsigned int height);
-using PFN_NFSTweak_PushDepthBufferR32F = void(__cdecl *)(const void *data, unsigned int width, unsigned int height, unsigned int row_pitch_bytes);
-using PFN_NFSTweak_RequestPreHudEffects = void(__cdecl *)();
-using PFN_NFSTweak_BeginPreHudWindow = void(__cdecl *)(unsigned int token);
-using PFN_NFSTweak_EndPreHudWindow = void(__cdecl *)(unsigned int token);
-using PFN_NFSTweak_BeginPreHudWindowEx = void(__cdecl *)(unsigned int token, unsigned int epoch);
-using PFN_NFSTweak_EndPreHudWindowEx = void(__cdecl *)(unsigned int token, unsigned int epoch);
-using PFN_NFSTweak_NotifyPrecipitationChanged = void(__cdecl *)(unsigned int value);
-using PFN_NFSTweak_NotifyPhaseInvalidate = void(__cdecl *)(unsigned int reason);
-using PFN_NFSTweak_NotifyPhaseInvalidateEx = void(__cdecl *)(unsigned int reason, unsigned int epoch);
-
-static PFN_NFSTweak_PushDepthSurface g_pfnPushDepthSurface = nullptr;
-static PFN_NFSTweak_PushDepthBufferR32F g_pfnPushDepthBufferR32F = nullptr;
-static PFN_NFSTweak_RequestPreHudEffects g_pfnRequestPreHudEffects = nullptr;
-static PFN_NFSTweak_BeginPreHudWindow g_pfnBeginPreHudWindow = nullptr;
-static PFN_NFSTweak_EndPreHudWindow g_pfnEndPreHudWindow = nullptr;
-static PFN_NFSTweak_BeginPreHudWindowEx g_pfnBeginPreHudWindowEx = nullptr;
-static PFN_NFSTweak_EndPreHudWindowEx g_pfnEndPreHudWindowEx = nullptr;
-static PFN_NFSTweak_NotifyPrecipitationChanged g_pfnNotifyPrecipitationChanged = nullptr;
-static PFN_NFSTweak_NotifyPhaseInvalidate g_pfnNotifyPhaseInvalidate = nullptr;
-static PFN_NFSTweak_NotifyPhaseInvalidateEx g_pfnNotifyPhaseInvalidateEx = nullptr;
+// Resolved add-on entry points. The loader-notification callback clears them from another thread, so call sites
+// load each pointer once and call through the local copy.
+static std::atomic<PFN_NFSTweak_PushDepthSurface> g_pfnPushDepthSurface{nullptr};
+static std::atomic<PFN_NFSTweak_PushDepthBufferR32F> g_pfnPushDepthBufferR32F{nullptr};
+static std::atomic<PFN_NFSTweak_RequestPreHudEffects> g_pfnRequestPreHudEffects{nullptr};
+static std::atomic<PFN_NFSTweak_BeginPreHudWindow> g_pfnBeginPreHudWindow{nullptr};
+static std::atomic<PFN_NFSTweak_EndPreHudWindow> g_pfnEndPreHudWindow{nullptr};
+static std::atomic<PFN_NFSTweak_BeginPreHudWindowEx> g_pfnBeginPreHudWindowEx{nullptr};
+static std::atomic<PFN_NFSTweak_EndPreHudWindowEx> g_pfnEndPreHudWindowEx{nullptr};
+static std::atomic<PFN_NFSTweak_NotifyPrecipitationChanged> g_pfnNotifyPrecipitationChanged{nullptr};
+static std::atomic<PFN_NFSTweak_NotifyPhaseInvalidate> g_pfnNotifyPhaseInvalidate{nullptr};
+static std::atomic<PFN_NFSTweak_NotifyPhaseInvalidateEx> g_pfnNotifyPhaseInvalidateEx{nullptr};
+static std::atomic<PFN_NFSTweak_PushCameraState> g_pfnPushCameraState{nullptr};
+static std::atomic<PFN_NFSTweak_MarkTimelineEvent> g_pfnMarkTimelineEvent{nullptr};
 
 static std::atomic_uint64_t g_last_capture_qpc{0};
 static std::atomic_uint64_t g_predisplay_call_count{0};
@@ -61,6 +57,10 @@ static std::atomic_uint32_t g_overlay_state_last{0};
 static std::atomic_uint64_t g_scene_pair_skip_count{0};
 static std::atomic_uint64_t g_prehud_token_emit_count{0};
 static std::atomic_uint64_t g_last_token_emit_qpc{0};
+static std::atomic_uint32_t g_bridge_frame{0}; // PreDisplay_Render(0) counter; stamps camera samples and timeline events
+static std::atomic_uint64_t g_attach_qpc{0};
+static std::atomic_uint64_t g_hooks_installed_qpc{0};
+static NFSTweakCameraState g_camera_last = {};
 static std::mutex g_capture_mutex;
 static std::atomic_bool g_enable_capture{false};
 
@@ -68,6 +68,42 @@ static IDirect3DSurface9 *g_sysmem_surface = nullptr;
 static D3DFORMAT g_sysmem_format = D3DFMT_UNKNOWN;
 static unsigned int g_sysmem_w = 0, g_sysmem_h = 0;
 
+static uint64_t bridge_qpc_frequency()
+{
+	// Fixed at boot; query once.
+	static const uint64_t s_freq = []() {
+		LARGE_INTEGER freq = {};
+		return QueryPerformanceFrequency(&freq) ? static_cast<uint64_t>(freq.QuadPart) : 0ull;
+	}();
+	return s_freq;
+}
+
+static uint64_t bridge_qpc_now()
+{
+	LARGE_INTEGER now = {};
+	QueryPerformanceCounter(&now);
+	return static_cast<uint64_t>(now.QuadPart);
+}
+
+static double bridge_qpc_to_ms(uint64_t ticks)
+{
+	const uint64_t freq = bridge_qpc_frequency();
+	return freq != 0 ? (static_cast<double>(ticks) * 1000.0) / static_cast<double>(freq) : 0.0;
+}
+
+static void mark_timeline_event(unsigned int event, unsigned int value, uint64_t qpc)
+{
+	if (const PFN_NFSTweak_MarkTimelineEvent mark = g_pfnMarkTimelineEvent.load(std::memory_order_relaxed))
+		mark(event, g_bridge_frame.load(std::memory_order_relaxed), value, qpc);
+}
+
+// Hook duration spans for the add-on's trace export (NFSTWEAK_TIMELINE_SPAN_*). No-op until the exports resolve.
+static void mark_hook_span(unsigned int event, unsigned int span, unsigned int detail = 0)
+{
+	if (const PFN_NFSTweak_MarkTimelineEvent mark = g_pfnMarkTimelineEvent.load(std::memory_order_relaxed))
+		mark(event, g_bridge_frame.load(std::memory_order_relaxed), span | (detail << 8), bridge_qpc_now());
+}
+
 static uint32_t read_overlay_state_flag()
 {
 #if GAME_MW
@@ -137,12 +173,12 @@ static bool emit_prehud_token_window(const char *origin_tag, bool require_canoni
 
 	// Dedupe burst emits from the same frame/phase path (can happen around FE transitions).
 	// Keep nominal 60-144 FPS unaffected while blocking sub-millisecond duplicates.
-	LARGE_INTEGER freq = {}, now = {};
-	if (QueryPerformanceFrequency(&freq) && QueryPerformanceCounter(&now) && freq.QuadPart > 0)
+	const uint64_t freq = bridge_qpc_frequency();
+	const uint64_t now_qpc = bridge_qpc_now();
+	if (freq > 0)
 	{
-		const uint64_t now_qpc = static_cast<uint64_t>(now.QuadPart);
 		const uint64_t prev_qpc = g_last_token_emit_qpc.load(std::memory_order_relaxed);
-		const uint64_t min_delta = static_cast<uint64_t>(freq.QuadPart / 220); // ~4.5ms
+		const uint64_t min_delta = freq / 220; // ~4.5ms
 		if (prev_qpc != 0 && now_qpc > prev_qpc && (now_qpc - prev_qpc) < min_delta)
 			return false;
 		g_last_token_emit_qpc.store(now_qpc, std::memory_order_relaxed);
@@ -164,21 +200,32 @@ static bool emit_prehud_token_window(const char *origin_tag, bool require_canoni
 	const uint32_t token = g_scene_token_counter.fetch_add(1, std::memory_order_relaxed) + 1;
 	const uint32_t epoch = g_bridge_phase_epoch.load(std::memory_order_relaxed);
 	g_scene_token_active.store(token, std::memory_order_relaxed);
-	if (g_pfnBeginPreHudWindowEx)
-		g_pfnBeginPreHudWindowEx(token, epoch);
-	else if (g_pfnBeginPreHudWindow)
-		g_pfnBeginPreHudWindow(token);
-	if (g_pfnRequestPreHudEffects)
+	mark_timeline_event(NFSTWEAK_TIMELINE_TOKEN, token, now_qpc);
+	mark_timeline_event(NFSTWEAK_TIMELINE_WINDOW_BEGIN, token, bridge_qpc_now());
+	if (const PFN_NFSTweak_BeginPreHudWindowEx begin_ex = g_pfnBeginPreHudWindowEx.load(std::memory_order_relaxed))
+		begin_ex(token, epoch);
+	else if (const PFN_NFSTweak_BeginPreHudWindow begin = g_pfnBeginPreHudWindow.load(std::memory_order_relaxed))
+		begin(token);
+	if (const PFN_NFSTweak_RequestPreHudEffects request = g_pfnRequestPreHudEffects.load(std::memory_order_relaxed))
 	{
-		g_pfnRequestPreHudEffects();
+		request();
 		g_predisplay_request_count.fetch_add(1, std::memory_order_relaxed);
 	}
-	if (g_pfnEndPreHudWindowEx)
-		g_pfnEndPreHudWindowEx(token, epoch);
-	else if (g_pfnEndPreHudWindow)
-		g_pfnEndPreHudWindow(token);
+	mark_timeline_event(NFSTWEAK_TIMELINE_WINDOW_END, token, bridge_qpc_now());
+	if (const PFN_NFSTweak_EndPreHudWindowEx end_ex = g_pfnEndPreHudWindowEx.load(std::memory_order_relaxed))
+		end_ex(token, epoch);
+	else if (const PFN_NFSTweak_EndPreHudWindow end = g_pfnEndPreHudWindow.load(std::memory_order_relaxed))
+		end(token);
 	g_scene_token_active.store(0, std::memory_order_relaxed);
 	const uint64_t emits = g_prehud_token_emit_count.fetch_add(1, std::memory_order_relaxed) + 1;
+	if (emits == 1)
+	{
+		char msg[160] = {};
+		sprintf_s(msg, "NFS_Addon_Bridge: First pre-HUD token %.1f ms after attach (%.1f ms after hooks).\n",
+			bridge_qpc_to_ms(now_qpc - g_attach_qpc.load(std::memory_order_relaxed)),
+			bridge_qpc_to_ms(now_qpc - g_hooks_installed_qpc.load(std::memory_order_relaxed)));
+		OutputDebugStringA(msg);
+	}
 	if (emits <= 5 || (emits % 120) == 0)
 	{
 		char msg[192] = {};
@@ -189,84 +236,226 @@ static bool emit_prehud_token_window(const char *origin_tag, bool require_canoni
 	return true;
 }
 
+// Export resolution. The add-on can load after the bridge (ReShade loads add-ons lazily) and may be renamed, so
+// lookups are retried only when the loader reports a new module (g_exports_dirty); steady-state frames just test
+// g_exports_resolved. NFSTweak_GetInterface hands over every entry point at once; per-symbol lookup covers older add-ons.
+static std::atomic_bool g_exports_resolved{false};
+static std::atomic_bool g_exports_dirty{true};
+static std::atomic<HMODULE> g_exports_module{nullptr};
+static std::atomic_uint32_t g_exports_poll_calls{0};
+static std::atomic_uint32_t g_exports_lookup_count{0};
+static PVOID g_dll_notification_cookie = nullptr;
+// Wakes the init thread early when a module loads or the DLL detaches. Created and closed by the init thread;
+// everyone else only signals it through wake_init_thread(), under the mutex, so it is never used after the close.
+static std::mutex g_init_wake_mutex;
+static HANDLE g_init_wake_event = nullptr;
+static std::atomic_bool g_init_cancelled{false};
+
+static void wake_init_thread()
+{
+	std::lock_guard<std::mutex> lock(g_init_wake_mutex);
+	if (g_init_wake_event != nullptr)
+		SetEvent(g_init_wake_event);
+}
+
+static void clear_resolved_exports()
+{
+	g_pfnPushDepthBufferR32F.store(nullptr, std::memory_order_relaxed);
+	g_pfnPushDepthSurface.store(nullptr, std::memory_order_relaxed);
+	g_pfnRequestPreHudEffects.store(nullptr, std::memory_order_relaxed);
+	g_pfnBeginPreHudWindow.store(nullptr, std::memory_order_relaxed);
+	g_pfnEndPreHudWindow.store(nullptr, std::memory_order_relaxed);
+	g_pfnBeginPreHudWindowEx.store(nullptr, std::memory_order_relaxed);
+	g_pfnEndPreHudWindowEx.store(nullptr, std::memory_order_relaxed);
+	g_pfnNotifyPrecipitationChanged.store(nullptr, std::memory_order_relaxed);
+	g_pfnNotifyPhaseInvalidate.store(nullptr, std::memory_order_relaxed);
+	g_pfnNotifyPhaseInvalidateEx.store(nullptr, std::memory_order_relaxed);
+	g_pfnPushCameraState.store(nullptr, std::memory_order_relaxed);
+	g_pfnMarkTimelineEvent.store(nullptr, std::memory_order_relaxed);
+}
+
+static bool resolve_exports_from_interface(HMODULE h)
+{
+	const PFN_NFSTweak_GetInterface get_interface = reinterpret_cast<PFN_NFSTweak_GetInterface>(GetProcAddress(h, "NFSTweak_GetInterface"));
+	if (get_interface == nullptr)
+		return false;
+	const NFSTweakInterfaceV1 *const iface = get_interface(NFSTWEAK_INTERFACE_VERSION);
+	if (iface == nullptr || iface->size < sizeof(NFSTweakInterfaceV1))
+		return false;
+
+	g_pfnPushDepthBufferR32F.store(iface->PushDepthBufferR32F, std::memory_order_relaxed);
+	g_pfnPushDepthSurface.store(iface->PushDepthSurface, std::memory_order_relaxed);
+	g_pfnRequestPreHudEffects.store(iface->RequestPreHudEffects, std::memory_order_relaxed);
+	g_pfnBeginPreHudWindow.store(iface->BeginPreHudWindow, std::memory_order_relaxed);
+	g_pfnEndPreHudWindow.store(iface->EndPreHudWindow, std::memory_order_relaxed);
+	g_pfnBeginPreHudWindowEx.store(iface->BeginPreHudWindowEx, std::memory_order_relaxed);
+	g_pfnEndPreHudWindowEx.store(iface->EndPreHudWindowEx, std::memory_order_relaxed);
+	g_pfnNotifyPrecipitationChanged.store(iface->NotifyPrecipitationChanged, std::memory_order_relaxed);
+	g_pfnNotifyPhaseInvalidate.store(iface->NotifyPhaseInvalidate, std::memory_order_relaxed);
+	g_pfnNotifyPhaseInvalidateEx.store(iface->NotifyPhaseInvalidateEx, std::memory_order_relaxed);
+	g_pfnPushCameraState.store(iface->PushCameraState, std::memory_order_relaxed);
+	g_pfnMarkTimelineEvent.store(iface->MarkTimelineEvent, std::memory_order_relaxed);
+	return true;
+}
+
+static bool resolve_exports_per_symbol(HMODULE h)
+{
+	g_pfnPushDepthBufferR32F.store(reinterpret_cast<PFN_NFSTweak_PushDepthBufferR32F>(GetProcAddress(h, "NFSTweak_PushDepthBufferR32F")), std::memory_order_relaxed);
+	g_pfnPushDepthSurface.store(reinterpret_cast<PFN_NFSTweak_PushDepthSurface>(GetProcAddress(h, "NFSTweak_PushDepthSurface")), std::memory_order_relaxed);
+	g_pfnRequestPreHudEffects.store(reinterpret_cast<PFN_NFSTweak_RequestPreHudEffects>(GetProcAddress(h, "NFSTweak_RequestPreHudEffects")), std::memory_order_relaxed);
+	g_pfnBeginPreHudWindow.store(reinterpret_cast<PFN_NFSTweak_BeginPreHudWindow>(GetProcAddress(h, "NFSTweak_BeginPreHudWindow")), std::memory_order_relaxed);
+	g_pfnEndPreHudWindow.store(reinterpret_cast<PFN_NFSTweak_EndPreHudWindow>(GetProcAddress(h, "NFSTweak_EndPreHudWindow")), std::memory_order_relaxed);
+	g_pfnBeginPreHudWindowEx.store(reinterpret_cast<PFN_NFSTweak_BeginPreHudWindowEx>(GetProcAddress(h, "NFSTweak_BeginPreHudWindowEx")), std::memory_order_relaxed);
+	g_pfnEndPreHudWindowEx.store(reinterpret_cast<PFN_NFSTweak_EndPreHudWindowEx>(GetProcAddress(h, "NFSTweak_EndPreHudWindowEx")), std::memory_order_relaxed);
+	g_pfnNotifyPrecipitationChanged.store(reinterpret_cast<PFN_NFSTweak_NotifyPrecipitationChanged>(GetProcAddress(h, "NFSTweak_NotifyPrecipitationChanged")), std::memory_order_relaxed);
+	g_pfnNotifyPhaseInvalidate.store(reinterpret_cast<PFN_NFSTweak_NotifyPhaseInvalidate>(GetProcAddress(h, "NFSTweak_NotifyPhaseInvalidate")), std::memory_order_relaxed);
+	g_pfnNotifyPhaseInvalidateEx.store(reinterpret_cast<PFN_NFSTweak_NotifyPhaseInvalidateEx>(GetProcAddress(h, "NFSTweak_NotifyPhaseInvalidateEx")), std::memory_order_relaxed);
+	g_pfnPushCameraState.store(reinterpret_cast<PFN_NFSTweak_PushCameraState>(GetProcAddress(h, "NFSTweak_PushCameraState")), std::memory_order_relaxed);
+	g_pfnMarkTimelineEvent.store(reinterpret_cast<PFN_NFSTweak_MarkTimelineEvent>(GetProcAddress(h, "NFSTweak_MarkTimelineEvent")), std::memory_order_relaxed);
+	return (g_pfnPushDepthBufferR32F.load(std::memory_order_relaxed) != nullptr ||
+		g_pfnPushDepthSurface.load(std::memory_order_relaxed) != nullptr ||
+		g_pfnRequestPreHudEffects.load(std::memory_order_relaxed) != nullptr ||
+		g_pfnBeginPreHudWindow.load(std::memory_order_relaxed) != nullptr ||
+		g_pfnEndPreHudWindow.load(std::memory_order_relaxed) != nullptr ||
+		g_pfnBeginPreHudWindowEx.load(std::memory_order_relaxed) != nullptr ||
+		g_pfnEndPreHudWindowEx.load(std::memory_order_relaxed) != nullptr ||
+		g_pfnNotifyPrecipitationChanged.load(std::memory_order_relaxed) != nullptr ||
+		g_pfnNotifyPhaseInvalidate.load(std::memory_order_relaxed) != nullptr ||
+		g_pfnNotifyPhaseInvalidateEx.load(std::memory_order_relaxed) != nullptr ||
+		g_pfnPushCameraState.load(std::memory_order_relaxed) != nullptr);
+}
+
+static bool resolve_exports_from_module(HMODULE h)
+{
+	if (resolve_exports_from_interface(h) || resolve_exports_per_symbol(h))
+	{
+		g_exports_module.store(h, std::memory_order_relaxed);
+		return true;
+	}
+	clear_resolved_exports();
+	return false;
+}
+
 static bool try_resolve_exports()
 {
-	if (g_pfnPushDepthBufferR32F || g_pfnPushDepthSurface)
+	if (g_exports_resolved.load(std::memory_order_acquire))
 		return true;
+	// Without loader notifications, fall back to a sparse poll.
+	if (g_dll_notification_cookie == nullptr && (g_exports_poll_calls.fetch_add(1, std::memory_order_relaxed) % 120) == 0)
+		g_exports_dirty.store(true, std::memory_order_relaxed);
+	if (!g_exports_dirty.exchange(false, std::memory_order_acq_rel))
+		return false;
+	g_exports_lookup_count.fetch_add(1, std::memory_order_relaxed);
 
 	// Prefer the add-on module name. If users rename it, fall back to scanning all modules.
+	bool resolved = false;
 	HMODULE h = GetModuleHandleA("nfs_addon.addon32");
 	if (h)
-	{
-		g_pfnPushDepthBufferR32F = reinterpret_cast<PFN_NFSTweak_PushDepthBufferR32F>(GetProcAddress(h, "NFSTweak_PushDepthBufferR32F"));
-		g_pfnPushDepthSurface = reinterpret_cast<PFN_NFSTweak_PushDepthSurface>(GetProcAddress(h, "NFSTweak_PushDepthSurface"));
-		g_pfnRequestPreHudEffects = reinterpret_cast<PFN_NFSTweak_RequestPreHudEffects>(GetProcAddress(h, "NFSTweak_RequestPreHudEffects"));
-		g_pfnBeginPreHudWindow = reinterpret_cast<PFN_NFSTweak_BeginPreHudWindow>(GetProcAddress(h, "NFSTweak_BeginPreHudWindow"));
-		g_pfnEndPreHudWindow = reinterpret_cast<PFN_NFSTweak_EndPreHudWindow>(GetProcAddress(h, "NFSTweak_EndPreHudWindow"));
-		g_pfnBeginPreHudWindowEx = reinterpret_cast<PFN_NFSTweak_BeginPreHudWindowEx>(GetProcAddress(h, "NFSTweak_BeginPreHudWindowEx"));
-		g_pfnEndPreHudWindowEx = reinterpret_cast<PFN_NFSTweak_EndPreHudWindowEx>(GetProcAddress(h, "NFSTweak_EndPreHudWindowEx"));
-		g_pfnNotifyPrecipitationChanged = reinterpret_cast<PFN_NFSTweak_NotifyPrecipitationChanged>(GetProcAddress(h, "NFSTweak_NotifyPrecipitationChanged"));
-		g_pfnNotifyPhaseInvalidate = reinterpret_cast<PFN_NFSTweak_NotifyPhaseInvalidate>(GetProcAddress(h, "NFSTweak_NotifyPhaseInvalidate"));
-		g_pfnNotifyPhaseInvalidateEx = reinterpret_cast<PFN_NFSTweak_NotifyPhaseInvalidateEx>(GetProcAddress(h, "NFSTweak_NotifyPhaseInvalidateEx"));
-		return (g_pfnPushDepthBufferR32F || g_pfnPushDepthSurface || g_pfnRequestPreHudEffects || g_pfnBeginPreHudWindow || g_pfnEndPreHudWindow || g_pfnBeginPreHudWindowEx || g_pfnEndPreHudWindowEx || g_pfnNotifyPrecipitationChanged || g_pfnNotifyPhaseInvalidate || g_pfnNotifyPhaseInvalidateEx);
-	}
+		resolved = resolve_exports_from_module(h);
 
-	// Scan modules (robust against renamed addon file)
 	HMODULE modules[1024];
 	DWORD bytes = 0;
-	if (!K32EnumProcessModules(GetCurrentProcess(), modules, sizeof(modules), &bytes))
-		return false;
+	if (!resolved && K32EnumProcessModules(GetCurrentProcess(), modules, sizeof(modules), &bytes))
+	{
+		const DWORD count = std::min<DWORD>(bytes / sizeof(HMODULE), ARRAYSIZE(modules));
+		for (DWORD i = 0; i < count && !resolved; ++i)
+		{
+			// One probe per module: current add-ons export the interface, older ones the depth push entry points.
+			if (GetProcAddress(modules[i], "NFSTweak_GetInterface") == nullptr &&
+				GetProcAddress(modules[i], "NFSTweak_PushDepthBufferR32F") == nullptr &&
+				GetProcAddress(modules[i], "NFSTweak_PushDepthSurface") == nullptr)
+				continue;
+			resolved = resolve_exports_from_module(modules[i]);
+		}
+	}
 
-	const DWORD count = std::min<DWORD>(bytes / sizeof(HMODULE), ARRAYSIZE(modules));
-	for (DWORD i = 0; i < count; ++i)
-	{
-		FARPROC p = GetProcAddress(modules[i], "NFSTweak_PushDepthBufferR32F");
-		if (!p)
-			p = GetProcAddress(modules[i], "NFSTweak_PushDepthSurface");
-		if (!p)
-			p = GetProcAddress(modules[i], "NFSTweak_RequestPreHudEffects");
-		if (!p)
-			p = GetProcAddress(modules[i], "NFSTweak_BeginPreHudWindow");
-		if (!p)
-			p = GetProcAddress(modules[i], "NFSTweak_EndPreHudWindow");
-		if (!p)
-			p = GetProcAddress(modules[i], "NFSTweak_NotifyPrecipitationChanged");
-		if (!p)
-			p = GetProcAddress(modules[i], "NFSTweak_NotifyPhaseInvalidate");
-		if (!p)
-			p = GetProcAddress(modules[i], "NFSTweak_BeginPreHudWindowEx");
-		if (!p)
-			p = GetProcAddress(modules[i], "NFSTweak_EndPreHudWindowEx");
-		if (!p)
-			p = GetProcAddress(modules[i], "NFSTweak_NotifyPhaseInvalidateEx");
-		if (!p)
-			continue;
+	if (resolved)
+	{
+		g_exports_resolved.store(true, std::memory_order_release);
+		char msg[160] = {};
+		sprintf_s(msg, "NFS_Addon_Bridge: Add-on exports resolved (interface=%d lookups=%u).\n",
+			GetProcAddress(g_exports_module.load(std::memory_order_relaxed), "NFSTweak_GetInterface") != nullptr ? 1 : 0,
+			g_exports_lookup_count.load(std::memory_order_relaxed));
+		OutputDebugStringA(msg);
+	}
+	return resolved;
+}
 
-		g_pfnPushDepthBufferR32F = reinterpret_cast<PFN_NFSTweak_PushDepthBufferR32F>(GetProcAddress(modules[i], "NFSTweak_PushDepthBufferR32F"));
-		g_pfnPushDepthSurface = reinterpret_cast<PFN_NFSTweak_PushDepthSurface>(GetProcAddress(modules[i], "NFSTweak_PushDepthSurface"));
-		g_pfnRequestPreHudEffects = reinterpret_cast<PFN_NFSTweak_RequestPreHudEffects>(GetProcAddress(modules[i], "NFSTweak_RequestPreHudEffects"));
-		g_pfnBeginPreHudWindow = reinterpret_cast<PFN_NFSTweak_BeginPreHudWindow>(GetProcAddress(modules[i], "NFSTweak_BeginPreHudWindow"));
-		g_pfnEndPreHudWindow = reinterpret_cast<PFN_NFSTweak_EndPreHudWindow>(GetProcAddress(modules[i], "NFSTweak_EndPreHudWindow"));
-		g_pfnBeginPreHudWindowEx = reinterpret_cast<PFN_NFSTweak_BeginPreHudWindowEx>(GetProcAddress(modules[i], "NFSTweak_BeginPreHudWindowEx"));
-		g_pfnEndPreHudWindowEx = reinterpret_cast<PFN_NFSTweak_EndPreHudWindowEx>(GetProcAddress(modules[i], "NFSTweak_EndPreHudWindowEx"));
-		g_pfnNotifyPrecipitationChanged = reinterpret_cast<PFN_NFSTweak_NotifyPrecipitationChanged>(GetProcAddress(modules[i], "NFSTweak_NotifyPrecipitationChanged"));
-		g_pfnNotifyPhaseInvalidate = reinterpret_cast<PFN_NFSTweak_NotifyPhaseInvalidate>(GetProcAddress(modules[i], "NFSTweak_NotifyPhaseInvalidate"));
-		g_pfnNotifyPhaseInvalidateEx = reinterpret_cast<PFN_NFSTweak_NotifyPhaseInvalidateEx>(GetProcAddress(modules[i], "NFSTweak_NotifyPhaseInvalidateEx"));
-		return true;
+// Loader notification: a new module may be the add-on; the add-on unloading invalidates every pointer.
+// Runs under the loader lock, so only flags and pointer stores here.
+struct bridge_unicode_string
+{
+	USHORT Length;
+	USHORT MaximumLength;
+	PWSTR Buffer;
+};
+struct bridge_dll_notification_data
+{
+	ULONG Flags;
+	const bridge_unicode_string *FullDllName;
+	const bridge_unicode_string *BaseDllName;
+	PVOID DllBase;
+	ULONG SizeOfImage;
+};
+using PFN_LdrDllNotification = VOID(CALLBACK *)(ULONG reason, const bridge_dll_notification_data *data, PVOID context);
+using PFN_LdrRegisterDllNotification = LONG(NTAPI *)(ULONG flags, PFN_LdrDllNotification callback, PVOID context, PVOID *cookie);
+using PFN_LdrUnregisterDllNotification = LONG(NTAPI *)(PVOID cookie);
+static constexpr ULONG k_ldr_dll_notification_loaded = 1;
+static constexpr ULONG k_ldr_dll_notification_unloaded = 2;
+
+static VOID CALLBACK on_dll_notification(ULONG reason, const bridge_dll_notification_data *data, PVOID)
+{
+	if (reason == k_ldr_dll_notification_loaded)
+	{
+		if (!g_exports_resolved.load(std::memory_order_relaxed))
+			g_exports_dirty.store(true, std::memory_order_release);
+		wake_init_thread();
+	}
+	else if (reason == k_ldr_dll_notification_unloaded && data != nullptr &&
+		data->DllBase == reinterpret_cast<PVOID>(g_exports_module.load(std::memory_order_relaxed)))
+	{
+		g_exports_resolved.store(false, std::memory_order_relaxed);
+		clear_resolved_exports();
+		g_exports_module.store(nullptr, std::memory_order_relaxed);
+		g_exports_dirty.store(true, std::memory_order_release);
 	}
+}
 
-	return false;
+static void register_dll_notification()
+{
+	HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+	const PFN_LdrRegisterDllNotification reg = ntdll ?
+		reinterpret_cast<PFN_LdrRegisterDllNotification>(GetProcAddress(ntdll, "LdrRegisterDllNotification")) : nullptr;
+	if (reg == nullptr || reg(0, on_dll_notification, nullptr, &g_dll_notification_cookie) < 0)
+	{
+		g_dll_notification_cookie = nullptr;
+		OutputDebugStringA("NFS_Addon_Bridge: LdrRegisterDllNotification unavailable; polling for the add-on instead.\n");
+	}
+	// Modules loaded before registration are covered by the initial dirty flag.
+	g_exports_dirty.store(true, std::memory_order_release);
+}
+
+static void unregister_dll_notification()
+{
+	if (g_dll_notification_cookie == nullptr)
+		return;
+	HMODULE ntdll = GetModuleHandleA("ntdll.dll");
+	const PFN_LdrUnregisterDllNotification unreg = ntdll ?
+		reinterpret_cast<PFN_LdrUnregisterDllNotification>(GetProcAddress(ntdll, "LdrUnregisterDllNotification")) : nullptr;
+	if (unreg)
+		unreg(g_dll_notification_cookie);
+	g_dll_notification_cookie = nullptr;
 }
 
 static bool throttle_capture(uint32_t hz)
 {
-	LARGE_INTEGER freq = {}, now = {};
-	if (!QueryPerformanceFrequency(&freq) || !QueryPerformanceCounter(&now) || freq.QuadPart == 0)
+	const uint64_t freq = bridge_qpc_frequency();
+	if (freq == 0)
 		return true; // if QPC is unavailable, don't block
 
-	const uint64_t now_qpc = static_cast<uint64_t>(now.QuadPart);
+	const uint64_t now_qpc = bridge_qpc_now();
 	const uint64_t prev = g_last_capture_qpc.load(std::memory_order_relaxed);
-	const uint64_t min_delta = static_cast<uint64_t>(freq.QuadPart / hz);
+	const uint64_t min_delta = freq / hz;
 	if (prev != 0 && (now_qpc - prev) < min_delta)
 		return false;
 
@@ -390,11 +579,11 @@ static void capture_and_push_depth(IDirect3DDevice9 *dev)
 
 	g_sysmem_surface->UnlockRect();
 
-	if (g_pfnPushDepthBufferR32F)
+	if (const PFN_NFSTweak_PushDepthBufferR32F push_r32f = g_pfnPushDepthBufferR32F.load(std::memory_order_relaxed))
 	{
-		g_pfnPushDepthBufferR32F(depth.data(), desc.Width, desc.Height, desc.Width * sizeof(float));
+		push_r32f(depth.data(), desc.Width, desc.Height, desc.Width * sizeof(float));
 	}
-	else if (g_pfnPushDepthSurface)
+	else if (g_pfnPushDepthSurface.load(std::memory_order_relaxed) != nullptr)
 	{
 		// Fallback: no CPU-buffer export available, push the surface itself.
 		// This may stall in the add-on under DXVK, but keeps compatibility.
@@ -402,10 +591,19 @@ static void capture_and_push_depth(IDirect3DDevice9 *dev)
 	}
 }
 
+#if GAME_MW
+static void notify_precipitation_changed(uint32_t value)
+{
+	mark_timeline_event(NFSTWEAK_TIMELINE_PRECIPITATION, value, bridge_qpc_now());
+	if (const PFN_NFSTweak_NotifyPrecipitationChanged notify = g_pfnNotifyPrecipitationChanged.load(std::memory_order_relaxed))
+		notify(value);
+}
+#endif
+
 static void pump_precipitation_signal_from_hooks()
 {
 #if GAME_MW
-	if (!try_resolve_exports() || g_pfnNotifyPrecipitationChanged == nullptr)
+	if (!try_resolve_exports() || g_pfnNotifyPrecipitationChanged.load(std::memory_order_relaxed) == nullptr)
 		return;
 
 	const uint32_t cur = (*reinterpret_cast<volatile uint32_t *>(PRECIPITATION_DEBUG_ADDR) != 0) ? 0x02u : 0x00u;
@@ -415,7 +613,7 @@ static void pump_precipitation_signal_from_hooks()
 		g_precip_signature_last.store(cur, std::memory_order_relaxed);
 		g_precip_signature_candidate.store(cur, std::memory_order_relaxed);
 		g_precip_signature_streak.store(0, std::memory_order_relaxed);
-		g_pfnNotifyPrecipitationChanged(cur);
+		notify_precipitation_changed(cur);
 		return;
 	}
 
@@ -446,7 +644,7 @@ static void pump_precipitation_signal_from_hooks()
 	{
 		g_precip_signature_last.store(cur, std::memory_order_relaxed);
 		g_precip_signature_streak.store(0, std::memory_order_relaxed);
-		g_pfnNotifyPrecipitationChanged(cur);
+		notify_precipitation_changed(cur);
 	}
 #endif
 }
@@ -472,10 +670,94 @@ static void pump_overlay_invalidate_signal()
 	g_overlay_state_last.store(cur, std::memory_order_relaxed);
 	// reason: 1=overlay_enter, 2=overlay_exit
 	const uint32_t next_epoch = g_bridge_phase_epoch.fetch_add(1, std::memory_order_relaxed) + 1;
-	if (g_pfnNotifyPhaseInvalidateEx)
-		g_pfnNotifyPhaseInvalidateEx(cur ? 1u : 2u, next_epoch);
-	else if (g_pfnNotifyPhaseInvalidate)
-		g_pfnNotifyPhaseInvalidate(cur ? 1u : 2u);
+	mark_timeline_event(NFSTWEAK_TIMELINE_PHASE_INVALIDATE, (cur ? 1u : 2u) | (next_epoch << 8), bridge_qpc_now());
+	if (const PFN_NFSTweak_NotifyPhaseInvalidateEx notify_ex = g_pfnNotifyPhaseInvalidateEx.load(std::memory_order_relaxed))
+		notify_ex(cur ? 1u : 2u, next_epoch);
+	else if (const PFN_NFSTweak_NotifyPhaseInvalidate notify = g_pfnNotifyPhaseInvalidate.load(std::memory_order_relaxed))
+		notify(cur ? 1u : 2u);
+#endif
+}
+
+#if defined(NFS_CAMERA_VIEW_MATRIX_ADDR) && defined(NFS_CAMERA_PROJ_MATRIX_ADDR)
+static bool read_camera_matrices(float view[16], float proj[16])
+{
+	__try
+	{
+		memcpy(view, reinterpret_cast<const void *>(NFS_CAMERA_VIEW_MATRIX_ADDR), sizeof(float) * 16);
+		memcpy(proj, reinterpret_cast<const void *>(NFS_CAMERA_PROJ_MATRIX_ADDR), sizeof(float) * 16);
+		return true;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		return false;
+	}
+}
+
+// Rejects anything that is not a rigid view transform plus a D3D perspective projection (wrong or stale address).
+static bool camera_matrices_plausible(const float view[16], const float proj[16])
+{
+	for (int r = 0; r < 3; ++r)
+	{
+		const float len2 = view[r * 4 + 0] * view[r * 4 + 0] + view[r * 4 + 1] * view[r * 4 + 1] + view[r * 4 + 2] * view[r * 4 + 2];
+		if (!(fabsf(len2 - 1.0f) < 0.01f) || view[r * 4 + 3] != 0.0f)
+			return false;
+	}
+	if (view[15] != 1.0f)
+		return false;
+	return proj[3] == 0.0f && proj[7] == 0.0f && proj[11] == 1.0f && proj[15] == 0.0f;
+}
+
+// World-space eye of a D3D row-vector view matrix [R 0; t 1]: e = -t * R^T.
+static void camera_eye_position(const float view[16], float eye[3])
+{
+	for (int j = 0; j < 3; ++j)
+		eye[j] = -(view[12] * view[j * 4 + 0] + view[13] * view[j * 4 + 1] + view[14] * view[j * 4 + 2]);
+}
+#endif
+
+// Sends this frame's camera to the add-on. Only active for games whose PreFEngHook header defines the
+// camera matrix addresses; near/far/FOV/aspect are derived from the D3D projection matrix.
+static void pump_camera_state()
+{
+#if defined(NFS_CAMERA_VIEW_MATRIX_ADDR) && defined(NFS_CAMERA_PROJ_MATRIX_ADDR)
+	if (!try_resolve_exports())
+		return;
+	const PFN_NFSTweak_PushCameraState push_camera = g_pfnPushCameraState.load(std::memory_order_relaxed);
+	if (push_camera == nullptr)
+		return;
+
+	NFSTweakCameraState s = {};
+	s.version = NFSTWEAK_CAMERA_STATE_VERSION;
+	s.size = sizeof(NFSTweakCameraState);
+	s.frame = g_bridge_frame.load(std::memory_order_relaxed);
+	if (read_camera_matrices(s.view, s.proj) && camera_matrices_plausible(s.view, s.proj) &&
+		s.proj[0] != 0.0f && s.proj[5] != 0.0f && s.proj[10] != 0.0f && s.proj[10] != 1.0f)
+	{
+		// D3D projection: P11 = 1/tan(fov/2), P00 = P11/aspect, P22 = f/(f-n), P32 = -n*f/(f-n).
+		s.fov_y = 2.0f * atanf(1.0f / s.proj[5]);
+		s.aspect = s.proj[5] / s.proj[0];
+		s.near_plane = -s.proj[14] / s.proj[10];
+		s.far_plane = s.proj[14] / (1.0f - s.proj[10]);
+		s.flags = NFSTWEAK_CAMERA_VALID;
+
+		// Camera cut: no previous sample, or the eye jumped further than any car moves in one frame.
+		if ((g_camera_last.flags & NFSTWEAK_CAMERA_VALID) == 0)
+			s.flags |= NFSTWEAK_CAMERA_CUT;
+		else
+		{
+			// Compare eye positions: view[12..14] is the translation in view space and also moves when the camera turns.
+			float eye[3], last_eye[3];
+			camera_eye_position(s.view, eye);
+			camera_eye_position(g_camera_last.view, last_eye);
+			const float dx = eye[0] - last_eye[0];
+			const float dy = eye[1] - last_eye[1];
+			const float dz = eye[2] - last_eye[2];
+			if (dx * dx + dy * dy + dz * dz > 50.0f * 50.0f)
+				s.flags |= NFSTWEAK_CAMERA_CUT;
+		}
+	}
+	g_camera_last = s;
+	push_camera(&s);
 #endif
 }
 
@@ -488,6 +770,7 @@ int __fastcall MW_Sub516F70_Hook(void *self, void *)
 {
 #if GAME_MW
 	(void)self;
+	mark_hook_span(NFSTWEAK_TIMELINE_SPAN_BEGIN, NFSTWEAK_SPAN_SUB_516F70);
 	__try
 	{
 		// Deterministic pre-HUD request point from IDA:
@@ -498,6 +781,9 @@ int __fastcall MW_Sub516F70_Hook(void *self, void *)
 	{
 		OutputDebugStringA("NFS_Addon_Bridge: MW_Sub516F70_Hook token emit exception suppressed.\n");
 	}
+	const int ret = MW_Sub516F70_orig(self);
+	mark_hook_span(NFSTWEAK_TIMELINE_SPAN_END, NFSTWEAK_SPAN_SUB_516F70);
+	return ret;
 #endif
 	return MW_Sub516F70_orig(self);
 }
@@ -514,20 +800,34 @@ void __stdcall FEManager_Render_Hook()
 	// Always try to resolve exports from the addon at this hook point.
 	// This keeps bridge->addon communication available for depth/capture paths.
 	try_resolve_exports();
+	mark_hook_span(NFSTWEAK_TIMELINE_SPAN_BEGIN, NFSTWEAK_SPAN_FEMANAGER_RENDER);
 
 	IDirect3DDevice9 *dev = *(IDirect3DDevice9 **)NFS_D3D9_DEVICE_ADDRESS;
 	capture_and_push_depth(dev);
 #endif
 
 	FEManager_Render_orig(thisptr);
+#if GAME_MW
+	mark_hook_span(NFSTWEAK_TIMELINE_SPAN_END, NFSTWEAK_SPAN_FEMANAGER_RENDER);
+#endif
 }
 
 int __cdecl PreDisplay_Render_Hook(int a1)
 {
 #if GAME_MW
+	mark_hook_span(NFSTWEAK_TIMELINE_SPAN_BEGIN, NFSTWEAK_SPAN_PREDISPLAY_RENDER, static_cast<unsigned int>(a1));
 	const uint64_t call_now = g_predisplay_call_count.fetch_add(1, std::memory_order_relaxed) + 1;
 	pump_precipitation_signal_from_hooks();
 	pump_overlay_invalidate_signal();
+	// Main scene display phase: open a new bridge frame and send the camera before the pre-HUD point inside it is reached.
+	if (a1 == 0)
+	{
+		const uint64_t predisplay_qpc = bridge_qpc_now();
+		g_bridge_frame.fetch_add(1, std::memory_order_relaxed);
+		if (try_resolve_exports())
+			mark_timeline_event(NFSTWEAK_TIMELINE_PREDISPLAY, 0, predisplay_qpc);
+		pump_camera_state();
+	}
 	const int ret = PreDisplay_Render_orig(a1);
 	// Trigger exactly on sub_6E6E40(0), which is the second display-phase call in eDisplayFrame.
 	// This is a stronger pre-HUD boundary than FEManager::Render helper internals.
@@ -542,6 +842,7 @@ int __cdecl PreDisplay_Render_Hook(int a1)
 		// Deterministic mode: no fallback token emission from non-canonical display phases.
 		// Tokens are emitted only from a1==0 when canonical scene RT/DS is bound.
 	}
+	mark_hook_span(NFSTWEAK_TIMELINE_SPAN_END, NFSTWEAK_SPAN_PREDISPLAY_RENDER, static_cast<unsigned int>(a1));
 	return ret;
 #endif
 	return PreDisplay_Render_orig(a1);
@@ -552,62 +853,242 @@ int __cdecl PreDisplay_Render_Hook(int a1)
 void __stdcall FECareerRecord_AdjustHeatOnEventWin_Hook() {}
 #endif
 
-BOOL APIENTRY DllMain(HMODULE hModule, DWORD reason, LPVOID)
+// Startup readiness. Hooks go in once the executable's code is in place (every checked call site still holds a
+// CALL, i.e. the image is unpacked) and the game has created its D3D9 device. The init thread polls with
+// exponential backoff; loader notifications (d3d9, ReShade, the add-on) wake it early.
+// Only CALL sites can be checked: the code caves (PS, UC) overwrite arbitrary instructions whose original bytes are
+// not recorded here, so games without a checked site keep the fixed startup delay.
+struct hook_site_check
 {
-	switch (reason)
+	uintptr_t site;
+	uintptr_t call_target; // destination of the original E8 rel32; 0 when only the CALL itself is known
+	const char *name;
+};
+static constexpr hook_site_check k_hook_site_checks[] = {
+#if defined(PREDISPLAY_HOOKADDR1) && defined(PREDISPLAY_RENDER_ADDRESS) && !defined(NFS_MULTITHREAD)
+	{ PREDISPLAY_HOOKADDR1, PREDISPLAY_RENDER_ADDRESS, "PreDisplay_Render #1" },
+	{ PREDISPLAY_HOOKADDR2, PREDISPLAY_RENDER_ADDRESS, "PreDisplay_Render #2" },
+#endif
+#if GAME_MW
+	{ FEMANAGER_RENDER_HOOKADDR1, FEMANAGER_RENDER_ADDRESS, "FEManager render" },
+#endif
+#ifdef GAME_CARBON
+	{ INFINITENOS_HOOK, 0, "EasterEggCheck" },
+#endif
+#ifdef GAME_UG2
+	{ SETRAIN_HOOK_ADDR, 0, "SetRainBase" },
+#endif
+#if defined(HAS_COPS) && !defined(GAME_UC) && !defined(GAME_MW) // MW already checks sites with known call targets
+	{ HEATONEVENTWIN_HOOK_ADDR, 0, "AdjustHeatOnEventWin" },
+#endif
+	{ 0, 0, nullptr } // terminator; keeps the array non-empty for games without known sites
+};
+static constexpr size_t k_hook_site_check_count = sizeof(k_hook_site_checks) / sizeof(k_hook_site_checks[0]) - 1;
+
+static constexpr DWORD k_init_backoff_first_ms = 5;
+static constexpr DWORD k_init_backoff_max_ms = 250;
+static constexpr double k_init_deadline_ms = 30000.0;
+static constexpr DWORD k_init_fixed_delay_ms = 2000; // games without checked sites: let the game/DXVK initialize
+
+// 0 = not readable or not a CALL yet, 1 = original call, 2 = call into something else (another patch got there first).
+static int read_hook_site(const hook_site_check &check, uintptr_t &out_target)
+{
+	__try
 	{
-	case DLL_PROCESS_ATTACH:
+		const uint8_t *const code = reinterpret_cast<const uint8_t *>(check.site);
+		if (code[0] != 0xE8)
+			return 0;
+		int32_t rel = 0;
+		memcpy(&rel, code + 1, sizeof(rel));
+		out_target = check.site + 5 + static_cast<uintptr_t>(rel);
+		return (check.call_target == 0 || out_target == check.call_target) ? 1 : 2;
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
 	{
-		DisableThreadLibraryCalls(hModule);
+		return 0;
+	}
+}
 
-		// Do not install hooks from inside DllMain (loader-lock sensitive; can hang with DXVK).
-		// Defer hook installation to a background thread.
-		auto init_thread = [](LPVOID) -> DWORD {
-			Sleep(2000); // let the game/DXVK initialize
+static bool hook_sites_ready()
+{
+	for (const hook_site_check &check : k_hook_site_checks)
+	{
+		if (check.name == nullptr)
+			continue;
+		uintptr_t target = 0;
+		const int state = read_hook_site(check, target);
+		if (state == 0)
+			return false;
+		if (state == 2)
+		{
+			char msg[192] = {};
+			sprintf_s(msg, "NFS_Addon_Bridge: %s site 0x%08X calls 0x%08X (expected 0x%08X); patching over it.\n",
+				check.name, static_cast<unsigned>(check.site), static_cast<unsigned>(target), static_cast<unsigned>(check.call_target));
+			OutputDebugStringA(msg);
+		}
+	}
+	return true;
+}
 
-			__try
-			{
+static IDirect3DDevice9 *read_game_device_safe()
+{
+	__try
+	{
+		return *reinterpret_cast<IDirect3DDevice9 *volatile *>(NFS_D3D9_DEVICE_ADDRESS);
+	}
+	__except (EXCEPTION_EXECUTE_HANDLER)
+	{
+		return nullptr;
+	}
+}
+
+// Returns false when the hook sites never showed their original code (unknown executable or still packed) or the
+// DLL is detaching.
+static bool wait_for_hook_readiness()
+{
+	if (k_hook_site_check_count == 0)
+	{
+		if (g_init_wake_event != nullptr)
+		{
+			// Loader notifications also signal the event, so keep waiting out the full delay
+			const uint64_t start_qpc = bridge_qpc_now();
+			for (double waited_ms = 0.0; waited_ms < k_init_fixed_delay_ms && !g_init_cancelled.load(std::memory_order_relaxed);
+				waited_ms = bridge_qpc_to_ms(bridge_qpc_now() - start_qpc))
+				WaitForSingleObject(g_init_wake_event, k_init_fixed_delay_ms - static_cast<DWORD>(waited_ms));
+		}
+		else
+		{
+			Sleep(k_init_fixed_delay_ms);
+		}
+		return !g_init_cancelled.load(std::memory_order_relaxed);
+	}
+
+	const uint64_t start_qpc = bridge_qpc_now();
+	DWORD backoff_ms = k_init_backoff_first_ms;
+	bool sites_ready = false;
+	for (uint32_t polls = 1;; ++polls)
+	{
+		if (g_init_cancelled.load(std::memory_order_relaxed))
+			return false;
+		sites_ready = sites_ready || hook_sites_ready();
+		const bool device_ready = read_game_device_safe() != nullptr;
+		const double waited_ms = bridge_qpc_to_ms(bridge_qpc_now() - start_qpc);
+		if (sites_ready && device_ready)
+		{
+			char msg[160] = {};
+			sprintf_s(msg, "NFS_Addon_Bridge: Hook sites and D3D9 device ready after %u polls (%.1f ms).\n", polls, waited_ms);
+			OutputDebugStringA(msg);
+			return true;
+		}
+		if (waited_ms >= k_init_deadline_ms)
+		{
+			OutputDebugStringA(sites_ready ?
+				"NFS_Addon_Bridge: D3D9 device still missing at the readiness deadline; installing hooks anyway.\n" :
+				"NFS_Addon_Bridge: Hook sites never showed their original code; bridge disabled.\n");
+			return sites_ready;
+		}
+
+		DWORD wait = WAIT_TIMEOUT;
+		if (g_init_wake_event != nullptr)
+			wait = WaitForSingleObject(g_init_wake_event, backoff_ms);
+		else
+			Sleep(backoff_ms);
+		// A module just loaded: things are moving, so go back to short polls.
+		backoff_ms = (wait == WAIT_OBJECT_0) ? k_init_backoff_first_ms : std::min(backoff_ms * 2, k_init_backoff_max_ms);
+	}
+}
+
+// All startup patches go through one transaction: each code page is unprotected once and the instruction cache is
+// flushed once. A page that cannot be unprotected leaves every patch unapplied.
+static bool install_hooks()
+{
+	injector::transaction patches;
 #ifdef NFS_MULTITHREAD
-				// Left as-is if you rely on these elsewhere.
-				injector::MakeJMP(FEMANAGER_RENDER_HOOKADDR1, ReShade_EntryPoint, true);
-				injector::MakeCALL(MAINSERVICE_HOOK_ADDR, MainService_Hook, true);
+	// Left as-is if you rely on these elsewhere.
+	patches.MakeJMP(FEMANAGER_RENDER_HOOKADDR1, ReShade_EntryPoint);
+	patches.MakeCALL(MAINSERVICE_HOOK_ADDR, MainService_Hook);
 #else
-				injector::MakeCALL(PREDISPLAY_HOOKADDR1, PreDisplay_Render_Hook, true);
-				injector::MakeCALL(PREDISPLAY_HOOKADDR2, PreDisplay_Render_Hook, true);
+	patches.MakeCALL(PREDISPLAY_HOOKADDR1, PreDisplay_Render_Hook);
+	patches.MakeCALL(PREDISPLAY_HOOKADDR2, PreDisplay_Render_Hook);
 #ifdef GAME_MW
-				// End pre-HUD token window exactly at FE/HUD callsite in eDisplayFrame.
-				injector::MakeCALL(0x006E71D0, MW_Sub516F70_Hook, true);
+	// End pre-HUD token window exactly at FE/HUD callsite in eDisplayFrame.
+	patches.MakeCALL(0x006E71D0, MW_Sub516F70_Hook);
 #endif
 #endif
 
 #ifdef GAME_MW
-				injector::MakeNOP(GAMEFLOW_UNLOADTRACK_FIX, 5, true);
+	patches.MakeNOP(GAMEFLOW_UNLOADTRACK_FIX, 5);
 #endif
 #ifdef GAME_CARBON
-				injector::MakeCALL(INFINITENOS_HOOK, EasterEggCheck_Hook, true);
+	patches.MakeCALL(INFINITENOS_HOOK, EasterEggCheck_Hook);
 #endif
 #ifdef GAME_PS
-				injector::MakeJMP(AICONTROL_CAVE_ADDR, ToggleAIControlCave, true);
-				injector::MakeJMP(INFINITENOS_CAVE_ADDR, InfiniteNOSCave, true);
-				injector::MakeJMP(GAMESPEED_CAVE_ADDR, GameSpeedCave, true);
-				injector::MakeJMP(DRAWWORLD_CAVE_ADDR, DrawWorldCave, true);
-				injector::WriteMemory<char>(SKIPFE_PLAYERCAR_DEHARDCODE_PATCH_ADDR, 0xA1, true);
-				injector::WriteMemory<int>(SKIPFE_PLAYERCAR_DEHARDCODE_PATCH_ADDR + 1, SKIPFE_PLAYERCAR_ADDR, true);
+	patches.MakeJMP(AICONTROL_CAVE_ADDR, ToggleAIControlCave);
+	patches.MakeJMP(INFINITENOS_CAVE_ADDR, InfiniteNOSCave);
+	patches.MakeJMP(GAMESPEED_CAVE_ADDR, GameSpeedCave);
+	patches.MakeJMP(DRAWWORLD_CAVE_ADDR, DrawWorldCave);
+	patches.WriteMemory<char>(SKIPFE_PLAYERCAR_DEHARDCODE_PATCH_ADDR, 0xA1);
+	patches.WriteMemory<int>(SKIPFE_PLAYERCAR_DEHARDCODE_PATCH_ADDR + 1, SKIPFE_PLAYERCAR_ADDR);
 #endif
 #ifdef GAME_UC
-				injector::MakeJMP(NFSUC_MOTIONBLUR_HOOK_ADDR, MotionBlur_EntryPoint, true);
-				injector::MakeJMP(INFINITENOS_CAVE_ADDR, InfiniteNOSCave, true);
-				injector::MakeJMP(AICONTROL_CAVE_ADDR, ToggleAIControlCave, true);
+	patches.MakeJMP(NFSUC_MOTIONBLUR_HOOK_ADDR, MotionBlur_EntryPoint);
+	patches.MakeJMP(INFINITENOS_CAVE_ADDR, InfiniteNOSCave);
+	patches.MakeJMP(AICONTROL_CAVE_ADDR, ToggleAIControlCave);
 #endif
 #ifdef GAME_UG2
-				injector::MakeCALL(SETRAIN_HOOK_ADDR, SetRainBase_Custom, true);
+	patches.MakeCALL(SETRAIN_HOOK_ADDR, SetRainBase_Custom);
 #endif
 #ifdef HAS_COPS
 #ifndef GAME_UC
-				injector::MakeCALL(HEATONEVENTWIN_HOOK_ADDR, FECareerRecord_AdjustHeatOnEventWin_Hook, true);
+	patches.MakeCALL(HEATONEVENTWIN_HOOK_ADDR, FECareerRecord_AdjustHeatOnEventWin_Hook);
 #endif
 #endif
-				OutputDebugStringA("NFS_Addon_Bridge: Hooks installed (eDisplayFrame pre-HUD).\n");
+	if (!patches.commit())
+		return false;
+
+	const uint64_t now_qpc = bridge_qpc_now();
+	g_hooks_installed_qpc.store(now_qpc, std::memory_order_relaxed);
+	char msg[160];
+	sprintf_s(msg, "NFS_Addon_Bridge: %u patches applied over %u pages, %.1f ms after attach.\n",
+		static_cast<unsigned>(patches.queued().size()), static_cast<unsigned>(patches.page_count()),
+		bridge_qpc_to_ms(now_qpc - g_attach_qpc.load(std::memory_order_relaxed)));
+	OutputDebugStringA(msg);
+	return true;
+}
+
+BOOL APIENTRY DllMain(HMODULE hModule, DWORD reason, LPVOID)
+{
+	switch (reason)
+	{
+	case DLL_PROCESS_ATTACH:
+	{
+		DisableThreadLibraryCalls(hModule);
+		g_attach_qpc.store(bridge_qpc_now(), std::memory_order_relaxed);
+
+		// Do not install hooks from inside DllMain (loader-lock sensitive; can hang with DXVK).
+		// Defer hook installation to a background thread that waits for the game to be ready.
+		auto init_thread = [](LPVOID) -> DWORD {
+			{
+				std::lock_guard<std::mutex> lock(g_init_wake_mutex);
+				g_init_wake_event = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+			}
+			register_dll_notification();
+			const bool ready = wait_for_hook_readiness();
+			{
+				std::lock_guard<std::mutex> lock(g_init_wake_mutex);
+				if (g_init_wake_event != nullptr)
+					CloseHandle(g_init_wake_event);
+				g_init_wake_event = nullptr;
+			}
+			if (!ready)
+				return 0;
+
+			__try
+			{
+				if (install_hooks())
+					OutputDebugStringA("NFS_Addon_Bridge: Hooks installed (eDisplayFrame pre-HUD).\n");
+				else
+					OutputDebugStringA("NFS_Addon_Bridge: Hook pages could not be unprotected; bridge disabled.\n");
 			}
 			__except (EXCEPTION_EXECUTE_HANDLER)
 			{
@@ -624,6 +1105,10 @@ BOOL APIENTRY DllMain(HMODULE hModule, DWORD reason, LPVOID)
 	}
 
 	case DLL_PROCESS_DETACH:
+		unregister_dll_notification();
+		// The init thread may still be waiting on its event; stop it and leave the handle for it to close
+		g_init_cancelled.store(true, std::memory_order_relaxed);
+		wake_init_thread();
 		if (g_sysmem_surface)
 		{
 			g_sysmem_surface->Release();
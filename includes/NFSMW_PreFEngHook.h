@@ -16,6 +16,11 @@
 
 #define DRAW_FENG_BOOL_ADDR 0x008F374C
 
+// Camera feed (NFSTweak_PushCameraState): define NFS_CAMERA_VIEW_MATRIX_ADDR / NFS_CAMERA_PROJ_MATRIX_ADDR
+// (float[16] each, D3D row-major) once validated for this executable. Left undefined, no camera is sent.
+// The bridge also checks each sample (orthonormal view, D3D perspective projection) before flagging it valid.
+// Not yet validated: the player-1 eViewPlatInfo ViewMatrix / ProjectionMatrix at 0x009195E0 / 0x00919620.
+
 #define SIM_SETSTREAM_ADDR 0x006F1170
 #define WCOLMGR_GETWORLDHEIGHT_ADDR 0x00789870
 #define PLAYER_LISTABLESET_ADDR 0x0092D84C
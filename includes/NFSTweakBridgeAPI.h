@@ -0,0 +1,82 @@
+#pragma once
+// Shared bridge <-> add-on data exchanged through NFSTweak_* exports.
+// Plain C layout: both modules are 32-bit MSVC builds, but keep every field fixed-size and versioned.
+
+#include <stdint.h>
+
+#define NFSTWEAK_CAMERA_STATE_VERSION 1u
+
+// NFSTweakCameraState::flags
+#define NFSTWEAK_CAMERA_VALID      0x1u // matrices were read this frame
+#define NFSTWEAK_CAMERA_CUT        0x2u // discontinuity (reset, teleport, camera switch): do not reproject
+
+// One camera sample per game frame. Matrices are row-major D3D9 style (row vectors, v * M).
+struct NFSTweakCameraState
+{
+	uint32_t version;     // NFSTWEAK_CAMERA_STATE_VERSION
+	uint32_t size;        // sizeof(NFSTweakCameraState)
+	uint32_t frame;       // bridge frame stamp (PreDisplay pass counter), monotonically increasing
+	uint32_t flags;       // NFSTWEAK_CAMERA_*
+	float view[16];
+	float proj[16];
+	float near_plane;
+	float far_plane;
+	float fov_y;          // vertical field of view in radians
+	float aspect;
+};
+
+
+// NFSTweak_MarkTimelineEvent event ids. Every event carries the bridge frame (PreDisplay pass counter, the same
+// stamp as NFSTweakCameraState::frame) and a QueryPerformanceCounter value taken by the caller.
+#define NFSTWEAK_TIMELINE_PREDISPLAY 1u // PreDisplay_Render(0) entered; value unused
+#define NFSTWEAK_TIMELINE_TOKEN      2u // pre-HUD window token emitted; value = token
+#define NFSTWEAK_TIMELINE_SPAN_BEGIN 3u // bridge hook entered; value = NFSTWEAK_SPAN_* | (detail << 8)
+#define NFSTWEAK_TIMELINE_SPAN_END   4u // bridge hook returning; value as for SPAN_BEGIN
+#define NFSTWEAK_TIMELINE_WINDOW_BEGIN     5u // about to call BeginPreHudWindow(Ex); value = token
+#define NFSTWEAK_TIMELINE_WINDOW_END       6u // about to call EndPreHudWindow(Ex); value = token
+#define NFSTWEAK_TIMELINE_PRECIPITATION    7u // about to call NotifyPrecipitationChanged; value = precipitation value
+#define NFSTWEAK_TIMELINE_PHASE_INVALIDATE 8u // about to call NotifyPhaseInvalidate(Ex); value = reason | (epoch << 8)
+
+// Bridge hook span ids (low 8 bits of the SPAN_* value). Spans only feed the add-on's trace export, not the
+// frame timeline; add-ons that predate them ignore the events.
+#define NFSTWEAK_SPAN_PREDISPLAY_RENDER 1u // detail = display phase argument
+#define NFSTWEAK_SPAN_SUB_516F70        2u
+#define NFSTWEAK_SPAN_FEMANAGER_RENDER  3u
+
+typedef void(__cdecl *PFN_NFSTweak_PushDepthSurface)(void *d3d9_surface, unsigned int width, unsigned int height);
+typedef void(__cdecl *PFN_NFSTweak_PushDepthBufferR32F)(const void *data, unsigned int width, unsigned int height, unsigned int row_pitch_bytes);
+typedef void(__cdecl *PFN_NFSTweak_RequestPreHudEffects)();
+typedef void(__cdecl *PFN_NFSTweak_BeginPreHudWindow)(unsigned int token);
+typedef void(__cdecl *PFN_NFSTweak_EndPreHudWindow)(unsigned int token);
+typedef void(__cdecl *PFN_NFSTweak_BeginPreHudWindowEx)(unsigned int token, unsigned int epoch);
+typedef void(__cdecl *PFN_NFSTweak_EndPreHudWindowEx)(unsigned int token, unsigned int epoch);
+typedef void(__cdecl *PFN_NFSTweak_NotifyPrecipitationChanged)(unsigned int value);
+typedef void(__cdecl *PFN_NFSTweak_NotifyPhaseInvalidate)(unsigned int reason);
+typedef void(__cdecl *PFN_NFSTweak_NotifyPhaseInvalidateEx)(unsigned int reason, unsigned int epoch);
+typedef void(__cdecl *PFN_NFSTweak_PushCameraState)(const NFSTweakCameraState *state);
+typedef void(__cdecl *PFN_NFSTweak_MarkTimelineEvent)(unsigned int event, unsigned int bridge_frame, unsigned int value, unsigned long long qpc);
+
+// Whole add-on surface in one lookup: NFSTweak_GetInterface(version) returns a static table, or null when the
+// add-on is older than the requested version. Later versions only append fields; check `size` before reading them.
+// The per-symbol NFSTweak_* exports stay for older bridges.
+#define NFSTWEAK_INTERFACE_VERSION 1u
+
+struct NFSTweakInterfaceV1
+{
+	uint32_t version;     // highest version the add-on implements
+	uint32_t size;        // sizeof the add-on's table
+	PFN_NFSTweak_PushDepthSurface PushDepthSurface;
+	PFN_NFSTweak_PushDepthBufferR32F PushDepthBufferR32F;
+	PFN_NFSTweak_RequestPreHudEffects RequestPreHudEffects;
+	PFN_NFSTweak_BeginPreHudWindow BeginPreHudWindow;
+	PFN_NFSTweak_EndPreHudWindow EndPreHudWindow;
+	PFN_NFSTweak_BeginPreHudWindowEx BeginPreHudWindowEx;
+	PFN_NFSTweak_EndPreHudWindowEx EndPreHudWindowEx;
+	PFN_NFSTweak_NotifyPrecipitationChanged NotifyPrecipitationChanged;
+	PFN_NFSTweak_NotifyPhaseInvalidate NotifyPhaseInvalidate;
+	PFN_NFSTweak_NotifyPhaseInvalidateEx NotifyPhaseInvalidateEx;
+	PFN_NFSTweak_PushCameraState PushCameraState;
+	PFN_NFSTweak_MarkTimelineEvent MarkTimelineEvent;
+};
+
+typedef const NFSTweakInterfaceV1 *(__cdecl *PFN_NFSTweak_GetInterface)(unsigned int version);
@@ -0,0 +1,77 @@
+#pragma once
+// On-disk layout of the add-on's trace flight recorder (NFSTweakBridge_FlightRecorder.bin next to the game executable).
+// The file is the live memory-mapped store of the trace rings, so after a crash it still holds the last records of every
+// traced thread. Plain C layout shared with tools/nfs_trace_decode.cpp; bump the version on any layout change.
+
+#include <stdint.h>
+
+#define NFSTWEAK_TRACE_FILE_MAGIC   "NFSTRACE" // first 8 bytes, no terminator
+#define NFSTWEAK_TRACE_FILE_VERSION 1u
+
+// NFSTweakTraceFileHeader::state
+#define NFSTWEAK_TRACE_STATE_OPEN   1u // writer running, or it died without shutting down
+#define NFSTWEAK_TRACE_STATE_CLOSED 2u // add-on unloaded cleanly
+
+// NFSTweakTraceRecordHeader::kind. Payload words per kind are described in NFS_addon/src/addon_trace.inl.
+#define NFSTWEAK_TRACE_KIND_WRAP       0u // filler: the rest of the ring data up to the wrap point is unused
+#define NFSTWEAK_TRACE_KIND_RENDER     1u
+#define NFSTWEAK_TRACE_KIND_SKIP       2u
+#define NFSTWEAK_TRACE_KIND_TRANSITION 3u
+#define NFSTWEAK_TRACE_KIND_INVARIANT  4u
+#define NFSTWEAK_TRACE_KIND_TIMELINE   5u
+#define NFSTWEAK_TRACE_KIND_SPAN_BEGIN 6u
+#define NFSTWEAK_TRACE_KIND_SPAN_END   7u
+#define NFSTWEAK_TRACE_KIND_BRIDGE_EVENT 8u // payload: NFSTWEAK_TIMELINE_* event, value, bridge frame
+
+#pragma pack(push, 4)
+struct NFSTweakTraceRecordHeader
+{
+	uint8_t kind;         // NFSTWEAK_TRACE_KIND_*
+	uint8_t words;        // uint32_t payload words following the header
+	uint16_t seq;         // per-ring sequence (low bits); gaps mean overwritten or dropped records
+	uint64_t qpc;         // QueryPerformanceCounter
+};
+#pragma pack(pop)
+
+// The header sits at offset 0, followed by the signature table and the rings. Every offset and size is stored, so a
+// reader never depends on the writer's compile-time sizes.
+struct NFSTweakTraceFileHeader
+{
+	char magic[8];              // NFSTWEAK_TRACE_FILE_MAGIC
+	uint32_t version;           // NFSTWEAK_TRACE_FILE_VERSION
+	uint32_t header_size;       // sizeof(NFSTweakTraceFileHeader)
+	uint32_t signatures_offset; // NFSTweakTraceFileSignature[signature_count], signature_stride apart
+	uint32_t signature_count;
+	uint32_t signature_stride;
+	uint32_t rings_offset;      // ring_count rings, ring_stride apart, each starting with NFSTweakTraceFileRing
+	uint32_t ring_count;
+	uint32_t ring_stride;
+	uint32_t ring_data_offset;  // byte ring inside a ring
+	uint32_t ring_data_bytes;
+	uint64_t qpc_frequency;
+	uint64_t open_qpc;          // QPC when the recorder was opened
+	uint32_t process_id;
+	uint32_t state;             // NFSTWEAK_TRACE_STATE_*
+	uint32_t faults;            // render_effects exception handlers that fired
+	uint32_t reserved;
+	uint64_t last_fault_qpc;
+};
+
+// Per-thread ring. `head` is the write cursor (bytes ever written); records in [tail, head) are intact, positions are
+// taken modulo ring_data_bytes.
+struct NFSTweakTraceFileRing
+{
+	uint64_t head;
+	uint64_t tail;
+	uint32_t thread_id;   // 0 = never claimed
+	uint32_t seq;
+};
+
+// Interned RT/DS pair; record signature id N refers to slot N - 1.
+struct NFSTweakTraceFileSignature
+{
+	uint32_t state;       // 2 = ready
+	uint32_t reserved;
+	uint64_t rtv;
+	uint64_t dsv;
+};
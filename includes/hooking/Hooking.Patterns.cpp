@@ -156,6 +156,7 @@ typedef char pchar_t;
 #endif
 
 #include "Hooking.Patterns.h"
+#include <chrono>
 #include <cstdint>
 #include <sstream>
 
@@ -187,6 +188,7 @@ typedef basic_fnv_1<fnv_prime, fnv_offset_basis> fnv_1;
 namespace hook
 {
 static std::multimap<uint64_t, uintptr_t> g_hints;
+static pattern::scan_stats g_scanStats;
 
 static void TransformPattern(const std::string& pattern, std::string& data, std::string& mask)
 {
@@ -232,6 +234,52 @@ static void TransformPattern(const std::string& pattern, std::string& data, std:
 	mask = maskStr.str();
 }
 
+// Rough ranking of byte values in x86 code (higher = more common); anchors prefer the rarest fixed bytes.
+static uint8_t ByteCommonness(uint8_t value)
+{
+	static const auto s_table = []()
+	{
+		static const uint8_t common[] = {
+			0x00, 0xFF, 0x8B, 0xCC, 0x89, 0x24, 0x44, 0x0F, 0xE8, 0x83, 0x85, 0xC0, 0x8D, 0x74, 0x75, 0x48,
+			0x4C, 0x45, 0x01, 0x04, 0x08, 0x10, 0x90, 0xC3, 0x50, 0x51, 0x52, 0x53, 0x55, 0x56, 0x57, 0x5D,
+			0x5E, 0x5F, 0x6A, 0xEB, 0xC7, 0x33, 0x3B, 0x84, 0x0C, 0x14, 0x18, 0x20, 0x46, 0x4E, 0x40, 0x41,
+		};
+
+		std::vector<uint8_t> table(256, 1);
+		uint8_t weight = static_cast<uint8_t>(_countof(common) + 1);
+
+		for (uint8_t byte : common)
+		{
+			table[byte] = weight--;
+		}
+
+		return table;
+	}();
+
+	return s_table[value];
+}
+
+// Offset of the rarest non-wildcard byte (first one on ties), skipping `exclude`; npos if every byte is a wildcard.
+static size_t SelectAnchor(const std::string& bytes, const std::string& mask, size_t exclude = std::string::npos)
+{
+	size_t best = std::string::npos;
+
+	for (size_t i = 0; i < mask.size(); i++)
+	{
+		if (mask[i] == '?' || i == exclude)
+		{
+			continue;
+		}
+
+		if (best == std::string::npos || ByteCommonness(bytes[i]) < ByteCommonness(bytes[best]))
+		{
+			best = i;
+		}
+	}
+
+	return best;
+}
+
 class executable_meta
 {
 private:
@@ -286,12 +334,314 @@ void pattern::Initialize(const char* pattern, size_t length)
 		// if the hints succeeded, we don't need to do anything more
 		if (m_matches.size() > 0)
 		{
+			g_scanStats.hintHits++;
 			m_matched = true;
 			return;
 		}
+
+		g_scanStats.hintMisses++;
+	}
+}
+
+// Vector scan paths. Candidates come from two anchor bytes (the rarest fixed bytes of the pattern) compared
+// 32 or 16 addresses at a time; each candidate is then verified with masked vector compares over the whole pattern.
+#if defined(__GNUC__)
+#define HOOK_TARGET(isa) __attribute__((target(isa)))
+#else
+#define HOOK_TARGET(isa)
+#endif
+
+enum class scan_isa
+{
+	scalar,
+	sse2,
+	avx2,
+};
+
+static uint64_t ReadXcr0()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	uint32_t eax, edx;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+static scan_isa DetectScanIsa()
+{
+	int cpuid[4];
+	__cpuid(cpuid, 0);
+
+	const int maxLeaf = cpuid[0];
+
+	if (maxLeaf < 1)
+	{
+		return scan_isa::scalar;
+	}
+
+	__cpuidex(cpuid, 1, 0);
+
+	const bool sse2 = (cpuid[3] & (1 << 26)) != 0;
+	const bool osxsave = (cpuid[2] & (1 << 27)) != 0;
+	const bool avx = (cpuid[2] & (1 << 28)) != 0;
+
+	// AVX2 needs the CPU bit and the OS saving YMM state (XCR0 bits 1 and 2)
+	if (maxLeaf >= 7 && osxsave && avx && (ReadXcr0() & 6) == 6)
+	{
+		__cpuidex(cpuid, 7, 0);
+
+		if (cpuid[1] & (1 << 5))
+		{
+			return scan_isa::avx2;
+		}
+	}
+
+	return sse2 ? scan_isa::sse2 : scan_isa::scalar;
+}
+
+static scan_isa GetScanIsa()
+{
+	static const scan_isa s_isa = DetectScanIsa();
+	return s_isa;
+}
+
+struct masked_pattern
+{
+	const uint8_t* bytes;
+	std::vector<uint8_t> mask; // 0xFF for fixed bytes, 0x00 for wildcards
+	size_t size;
+	size_t anchor0;
+	size_t anchor1;
+};
+
+static bool VerifyScalar(const masked_pattern& pattern, const uint8_t* ptr)
+{
+	for (size_t i = 0; i < pattern.size; i++)
+	{
+		if ((ptr[i] ^ pattern.bytes[i]) & pattern.mask[i])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Chunks at 0, 16, ... and a final overlapping chunk ending exactly at the pattern end, so nothing past it is read.
+static bool VerifySse2(const masked_pattern& pattern, const uint8_t* ptr)
+{
+	if (pattern.size < 16)
+	{
+		return VerifyScalar(pattern, ptr);
+	}
+
+	const __m128i zero = _mm_setzero_si128();
+
+	for (size_t i = 0; ; i += 16)
+	{
+		if (i + 16 > pattern.size)
+		{
+			i = pattern.size - 16;
+		}
+
+		const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + i));
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.bytes + i));
+		const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.mask.data() + i));
+		const __m128i diff = _mm_and_si128(_mm_xor_si128(value, bytes), mask);
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, zero)) != 0xFFFF)
+		{
+			return false;
+		}
+
+		if (i + 16 >= pattern.size)
+		{
+			return true;
+		}
+	}
+}
+
+HOOK_TARGET("avx2")
+static bool VerifyAvx2(const masked_pattern& pattern, const uint8_t* ptr)
+{
+	if (pattern.size < 32)
+	{
+		return VerifySse2(pattern, ptr);
+	}
+
+	for (size_t i = 0; ; i += 32)
+	{
+		if (i + 32 > pattern.size)
+		{
+			i = pattern.size - 32;
+		}
+
+		const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + i));
+		const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern.bytes + i));
+		const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pattern.mask.data() + i));
+		const __m256i diff = _mm256_and_si256(_mm256_xor_si256(value, bytes), mask);
+
+		if (!_mm256_testz_si256(diff, diff))
+		{
+			return false;
+		}
+
+		if (i + 32 >= pattern.size)
+		{
+			return true;
+		}
+	}
+}
+
+static inline unsigned CountTrailingZeros(uint32_t value)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, value);
+	return index;
+#else
+	return __builtin_ctz(value);
+#endif
+}
+
+// onMatch(address) returns true to stop the scan. Candidates are [begin, end], in ascending order.
+template<typename TMatch>
+static void ScanScalar(const masked_pattern& pattern, uintptr_t begin, uintptr_t end, TMatch&& onMatch)
+{
+	for (uintptr_t i = begin; i <= end; i++)
+	{
+		if (VerifyScalar(pattern, reinterpret_cast<const uint8_t*>(i)) && onMatch(i))
+		{
+			return;
+		}
+	}
+}
+
+template<typename TMatch>
+static void ScanSse2(const masked_pattern& pattern, uintptr_t begin, uintptr_t end, TMatch&& onMatch)
+{
+	const __m128i first = _mm_set1_epi8(static_cast<char>(pattern.bytes[pattern.anchor0]));
+	const __m128i second = _mm_set1_epi8(static_cast<char>(pattern.bytes[pattern.anchor1]));
+
+	uintptr_t i = begin;
+
+	for (; i <= end && end - i >= 15; i += 16)
+	{
+		const __m128i block0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i + pattern.anchor0));
+		const __m128i block1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i + pattern.anchor1));
+		uint32_t candidates = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block0, first), _mm_cmpeq_epi8(block1, second)));
+
+		while (candidates)
+		{
+			const uintptr_t address = i + CountTrailingZeros(candidates);
+			candidates &= candidates - 1;
+
+			if (VerifySse2(pattern, reinterpret_cast<const uint8_t*>(address)) && onMatch(address))
+			{
+				return;
+			}
+		}
+	}
+
+	if (i <= end)
+	{
+		ScanScalar(pattern, i, end, onMatch);
 	}
 }
 
+template<typename TMatch>
+HOOK_TARGET("avx2")
+static void ScanAvx2(const masked_pattern& pattern, uintptr_t begin, uintptr_t end, TMatch&& onMatch)
+{
+	const __m256i first = _mm256_set1_epi8(static_cast<char>(pattern.bytes[pattern.anchor0]));
+	const __m256i second = _mm256_set1_epi8(static_cast<char>(pattern.bytes[pattern.anchor1]));
+
+	uintptr_t i = begin;
+
+	for (; i <= end && end - i >= 31; i += 32)
+	{
+		const __m256i block0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(i + pattern.anchor0));
+		const __m256i block1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(i + pattern.anchor1));
+		uint32_t candidates = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(block0, first), _mm256_cmpeq_epi8(block1, second))));
+
+		while (candidates)
+		{
+			const uintptr_t address = i + CountTrailingZeros(candidates);
+			candidates &= candidates - 1;
+
+			if (VerifyAvx2(pattern, reinterpret_cast<const uint8_t*>(address)) && onMatch(address))
+			{
+				return;
+			}
+		}
+	}
+
+	if (i <= end)
+	{
+		ScanScalar(pattern, i, end, onMatch);
+	}
+}
+
+template<typename TMatch>
+static void ScanRange(const masked_pattern& pattern, uintptr_t begin, uintptr_t end, TMatch&& onMatch)
+{
+	if (pattern.anchor0 == std::string::npos)
+	{
+		// all wildcards: every address matches
+		ScanScalar(pattern, begin, end, onMatch);
+		return;
+	}
+
+	switch (GetScanIsa())
+	{
+	case scan_isa::avx2:
+		ScanAvx2(pattern, begin, end, onMatch);
+		break;
+	case scan_isa::sse2:
+		ScanSse2(pattern, begin, end, onMatch);
+		break;
+	default:
+		ScanScalar(pattern, begin, end, onMatch);
+		break;
+	}
+}
+
+// Large ranges are split across threads spawned for the scan and joined before it returns (no pool outliving
+// the scan, so nothing is left running when the module unloads). Opt-in: a new thread cannot start while its
+// creator holds the loader lock, so a scan from DllMain that waited on one would deadlock.
+static std::atomic<unsigned> g_scanThreads(1);
+static const uintptr_t parallelScanMinimum = 1 << 20;   // below this the thread start-up costs more than it saves
+static const uintptr_t parallelChunkMinimum = 256 << 10;
+
+static unsigned GetScanThreadCount(uintptr_t rangeSize)
+{
+	unsigned threads = g_scanThreads.load(std::memory_order_relaxed);
+
+	if (threads == 1)
+	{
+		return 1;
+	}
+
+	if (threads == 0)
+	{
+		threads = std::min(std::max(std::thread::hardware_concurrency(), 1u), 8u);
+	}
+
+	if (rangeSize < parallelScanMinimum)
+	{
+		return 1;
+	}
+
+	return static_cast<unsigned>(std::min<uintptr_t>(threads, rangeSize / parallelChunkMinimum));
+}
+
+void pattern::set_scan_threads(unsigned count)
+{
+	g_scanThreads.store(count, std::memory_order_relaxed);
+}
+
 void pattern::EnsureMatches(int maxCount)
 {
 	if (m_matched)
@@ -308,83 +658,133 @@ void pattern::EnsureMatches(int maxCount)
 		executable.set_end(range_end);
 	}
 
-	// check if SSE 4.2 is supported
-	int cpuid[4];
-	__cpuid(cpuid, 0);
+	// new hints are persisted by save_hint_cache()
+	auto matchSuccess = [&] (uintptr_t address)
+	{
+		g_hints.insert(std::make_pair(m_hash, address));
 
-	bool sse42 = false;
+		return (m_matches.size() == maxCount);
+	};
+
+	const auto scanStart = std::chrono::steady_clock::now();
 
-	if (m_mask.size() <= 16)
+	auto onMatch = [&] (uintptr_t address)
 	{
-		if (cpuid[0] >= 1)
-		{
-			__cpuidex(cpuid, 1, 0);
+		m_matches.push_back(pattern_match((void*)address));
 
-			sse42 = (cpuid[2] & (1 << 20));
-		}
-	}
+		return matchSuccess(address);
+	};
 
-	auto matchSuccess = [&] (uintptr_t address)
+	masked_pattern compiled;
+	compiled.bytes = reinterpret_cast<const uint8_t*>(m_bytes.c_str());
+	compiled.size = m_size;
+	compiled.mask.resize(m_size);
+
+	for (size_t i = 0; i < m_size; i++)
 	{
-#if 0
-		Citizen_PatternSaveHint(m_hash, address);
-#endif
-		g_hints.insert(std::make_pair(m_hash, address));
+		compiled.mask[i] = (m_mask[i] == '?') ? 0x00 : 0xFF;
+	}
 
-		return (m_matches.size() == maxCount);
-	};
+	compiled.anchor0 = SelectAnchor(m_bytes, m_mask);
+	compiled.anchor1 = SelectAnchor(m_bytes, m_mask, compiled.anchor0);
 
-	LARGE_INTEGER ticks;
-	QueryPerformanceCounter(&ticks);
+	if (compiled.anchor1 == std::string::npos)
+	{
+		compiled.anchor1 = compiled.anchor0;
+	}
 
-	uint64_t startTicksOld = ticks.QuadPart;
+	const uintptr_t begin = executable.begin();
+	const uintptr_t end = executable.end();
+	const unsigned threads = (end > begin) ? GetScanThreadCount(end - begin + 1) : 1;
 
-	if (!sse42)
+	if (threads <= 1)
+	{
+		ScanRange(compiled, begin, end, onMatch);
+	}
+	else
 	{
-		for (uintptr_t i = executable.begin(); i <= executable.end(); i++)
+		// Candidate ranges partition [begin, end]; each chunk still reads up to m_size - 1 bytes past its last
+		// candidate, so neighbouring chunks overlap by the pattern length and no match straddles a boundary.
+		std::vector<std::vector<uintptr_t>> found(threads);
+		std::atomic<unsigned> satisfiedChunk(threads);
+		const uintptr_t chunkSize = (end - begin) / threads + 1;
+
+		auto scanChunk = [&] (unsigned chunk)
 		{
-			if (ConsiderMatch(i))
+			const uintptr_t chunkBegin = begin + chunk * chunkSize;
+			const uintptr_t chunkEnd = (chunk + 1 == threads) ? end : chunkBegin + chunkSize - 1;
+			auto& matches = found[chunk];
+
+			if (chunkBegin > end)
+			{
+				return;
+			}
+
+			ScanRange(compiled, chunkBegin, chunkEnd, [&] (uintptr_t address)
 			{
-				if (matchSuccess(i))
+				// an earlier chunk already holds maxCount matches on its own: nothing found here would be kept
+				if (satisfiedChunk.load(std::memory_order_relaxed) < chunk)
 				{
-					break;
+					return true;
 				}
-			}
-		}
-	}
-	else
-	{
-		__declspec(align(16)) char desiredMask[16] = { 0 };
 
-		for (unsigned int i = 0; i < m_mask.size(); i++)
+				matches.push_back(address);
+
+				if (matches.size() == static_cast<size_t>(maxCount))
+				{
+					unsigned current = satisfiedChunk.load(std::memory_order_relaxed);
+
+					while (chunk < current && !satisfiedChunk.compare_exchange_weak(current, chunk, std::memory_order_relaxed))
+					{
+					}
+
+					return true;
+				}
+
+				return false;
+			});
+		};
+
+		std::vector<std::thread> workers;
+
+		for (unsigned chunk = 1; chunk < threads; chunk++)
 		{
-			desiredMask[i / 8] |= ((m_mask[i] == '?') ? 0 : 1) << (i % 8);
+			try
+			{
+				workers.emplace_back(scanChunk, chunk);
+			}
+			catch (const std::system_error&)
+			{
+				scanChunk(chunk);
+			}
 		}
 
-		__m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(desiredMask));
-		__m128i comparand = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_bytes.c_str()));
+		scanChunk(0);
 
-		for (uintptr_t i = executable.begin(); i <= executable.end(); i++)
+		for (auto& worker : workers)
 		{
-			__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(i));
-			__m128i result = _mm_cmpestrm(value, 16, comparand, m_bytes.size(), _SIDD_CMP_EQUAL_EACH);
+			worker.join();
+		}
 
-			// as the result can match more bits than the mask contains
-			__m128i matches = _mm_and_si128(mask, result);
-			__m128i equivalence = _mm_xor_si128(mask, matches);
+		// merge in address order and stop at maxCount, exactly as the sequential scan would
+		bool done = false;
 
-			if (_mm_test_all_zeros(equivalence, equivalence))
+		for (size_t chunk = 0; chunk < found.size() && !done; chunk++)
+		{
+			for (uintptr_t address : found[chunk])
 			{
-				m_matches.push_back(pattern_match((void*)i));
-
-				if (matchSuccess(i))
+				if (onMatch(address))
 				{
+					done = true;
 					break;
 				}
 			}
 		}
 	}
 
+	g_scanStats.scans++;
+	g_scanStats.scanMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - scanStart).count();
+
 	m_matched = true;
 }
 
@@ -413,6 +813,143 @@ bool pattern::ConsiderMatch(uintptr_t offset)
 	return true;
 }
 
+void pattern_batch::scan()
+{
+	struct pending
+	{
+		pattern* target;
+		int maxCount;
+		size_t anchor;
+		uintptr_t begin;
+		uintptr_t end;
+		bool done;
+	};
+
+	std::vector<pending> work;
+
+	for (auto& entry : m_entries)
+	{
+		pattern* target = entry.target;
+
+		if (target->m_matched)
+		{
+			continue;
+		}
+
+		const size_t anchor = SelectAnchor(target->m_bytes, target->m_mask);
+
+		// nothing to anchor on; an all-wildcard pattern matches everywhere anyway
+		if (anchor == std::string::npos || entry.maxCount <= 0)
+		{
+			target->EnsureMatches(entry.maxCount);
+			continue;
+		}
+
+		executable_meta executable(target->m_module);
+
+		if (target->range_start || target->range_end)
+		{
+			executable.set_begin(target->range_start);
+			executable.set_end(target->range_end);
+		}
+
+		work.push_back({ target, entry.maxCount, anchor, executable.begin(), executable.end(), false });
+	}
+
+	m_entries.clear();
+
+	// one pass per distinct range; patterns of the same module share it
+	std::stable_sort(work.begin(), work.end(), [] (const pending& left, const pending& right)
+	{
+		return (left.begin != right.begin) ? (left.begin < right.begin) : (left.end < right.end);
+	});
+
+	for (size_t groupBegin = 0; groupBegin < work.size(); )
+	{
+		size_t groupEnd = groupBegin + 1;
+
+		while (groupEnd < work.size() && work[groupEnd].begin == work[groupBegin].begin && work[groupEnd].end == work[groupBegin].end)
+		{
+			groupEnd++;
+		}
+
+		const uintptr_t begin = work[groupBegin].begin;
+		const uintptr_t end = work[groupBegin].end;
+
+		// anchor byte value -> patterns anchored on it (counting sort into one flat list)
+		uint32_t first[257] = { 0 };
+		std::vector<uint32_t> byAnchor(groupEnd - groupBegin);
+		size_t maxAnchor = 0;
+
+		for (size_t i = groupBegin; i < groupEnd; i++)
+		{
+			first[static_cast<uint8_t>(work[i].target->m_bytes[work[i].anchor]) + 1]++;
+			maxAnchor = std::max(maxAnchor, work[i].anchor);
+		}
+
+		for (int value = 0; value < 256; value++)
+		{
+			first[value + 1] += first[value];
+		}
+
+		uint32_t fill[256];
+		memcpy(fill, first, sizeof(fill));
+
+		for (size_t i = groupBegin; i < groupEnd; i++)
+		{
+			byAnchor[fill[static_cast<uint8_t>(work[i].target->m_bytes[work[i].anchor])]++] = static_cast<uint32_t>(i);
+		}
+
+		const auto scanStart = std::chrono::steady_clock::now();
+		size_t remaining = groupEnd - groupBegin;
+
+		for (uintptr_t address = begin; remaining > 0 && address <= end + maxAnchor; address++)
+		{
+			const uint8_t value = *reinterpret_cast<const uint8_t*>(address);
+
+			for (uint32_t slot = first[value]; slot < first[value + 1]; slot++)
+			{
+				pending& item = work[byAnchor[slot]];
+
+				if (item.done || address - begin < item.anchor)
+				{
+					continue;
+				}
+
+				const uintptr_t start = address - item.anchor;
+
+				if (start > end)
+				{
+					item.done = true;
+					remaining--;
+					continue;
+				}
+
+				if (item.target->ConsiderMatch(start))
+				{
+					g_hints.insert(std::make_pair(item.target->m_hash, start));
+
+					if (item.target->m_matches.size() == static_cast<size_t>(item.maxCount))
+					{
+						item.done = true;
+						remaining--;
+					}
+				}
+			}
+		}
+
+		for (size_t i = groupBegin; i < groupEnd; i++)
+		{
+			work[i].target->m_matched = true;
+		}
+
+		g_scanStats.scans++;
+		g_scanStats.scanMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - scanStart).count();
+
+		groupBegin = groupEnd;
+	}
+}
+
 void pattern::hint(uint64_t hash, uintptr_t address)
 {
 	auto range = g_hints.equal_range(hash);
@@ -427,4 +964,174 @@ void pattern::hint(uint64_t hash, uintptr_t address)
 
 	g_hints.insert(std::make_pair(hash, address));
 }
+
+// Hint cache file: header followed by (pattern hash, RVA) pairs. Addresses are stored relative to the executable
+// base so the file survives relocation, and only hints inside the image are kept, so a cached hint can always be
+// checked with a plain ConsiderMatch.
+struct hint_cache_header
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t timestamp;
+	uint32_t imageSize;
+	uint64_t sectionHash;
+	uint32_t count;
+	uint32_t reserved;
+};
+
+struct hint_cache_entry
+{
+	uint64_t hash;
+	uint64_t rva;
+};
+
+static const uint32_t hintCacheMagic = 0x43485048; // 'HPHC'
+static const uint32_t hintCacheVersion = 1;
+
+struct executable_identity
+{
+	uintptr_t base;
+	uint32_t imageSize;
+	uint32_t timestamp;
+	uint64_t sectionHash;
+};
+
+static bool GetExecutableIdentity(executable_identity& identity)
+{
+	const uintptr_t base = reinterpret_cast<uintptr_t>(GetModuleHandle(NULL));
+
+	if (!base)
+	{
+		return false;
+	}
+
+	PIMAGE_DOS_HEADER dosHeader = reinterpret_cast<PIMAGE_DOS_HEADER>(base);
+	PIMAGE_NT_HEADERS ntHeader = reinterpret_cast<PIMAGE_NT_HEADERS>(base + dosHeader->e_lfanew);
+
+	identity.base = base;
+	identity.imageSize = ntHeader->OptionalHeader.SizeOfImage;
+	identity.timestamp = ntHeader->FileHeader.TimeDateStamp;
+
+	// name, sizes and offsets of every section: catches patched or repacked executables with a kept timestamp
+	const char* sections = reinterpret_cast<const char*>(IMAGE_FIRST_SECTION(ntHeader));
+	identity.sectionHash = fnv_1()(std::string(sections, ntHeader->FileHeader.NumberOfSections * sizeof(IMAGE_SECTION_HEADER)));
+
+	return true;
+}
+
+bool pattern::load_hint_cache(const char* path)
+{
+	executable_identity identity;
+
+	if (!GetExecutableIdentity(identity))
+	{
+		return false;
+	}
+
+	FILE* file = fopen(path, "rb");
+
+	if (!file)
+	{
+		return false;
+	}
+
+	hint_cache_header header;
+	bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+		header.magic == hintCacheMagic &&
+		header.version == hintCacheVersion &&
+		header.timestamp == identity.timestamp &&
+		header.imageSize == identity.imageSize &&
+		header.sectionHash == identity.sectionHash;
+
+	std::vector<hint_cache_entry> entries;
+
+	if (valid)
+	{
+		// the count comes from the file: never allocate more entries than the rest of the file can hold
+		const long dataStart = ftell(file);
+		valid = dataStart >= 0 && fseek(file, 0, SEEK_END) == 0;
+
+		const long fileEnd = valid ? ftell(file) : -1;
+		valid = valid && fileEnd >= dataStart && fseek(file, dataStart, SEEK_SET) == 0 &&
+			header.count <= static_cast<uint64_t>(fileEnd - dataStart) / sizeof(hint_cache_entry);
+	}
+
+	if (valid)
+	{
+		entries.resize(header.count);
+		valid = header.count == 0 || fread(entries.data(), sizeof(hint_cache_entry), header.count, file) == header.count;
+	}
+
+	fclose(file);
+
+	if (!valid)
+	{
+		return false;
+	}
+
+	for (const auto& entry : entries)
+	{
+		if (entry.rva < identity.imageSize)
+		{
+			hint(entry.hash, identity.base + static_cast<uintptr_t>(entry.rva));
+			g_scanStats.cacheEntries++;
+		}
+	}
+
+	return true;
+}
+
+bool pattern::save_hint_cache(const char* path)
+{
+	executable_identity identity;
+
+	if (!GetExecutableIdentity(identity))
+	{
+		return false;
+	}
+
+	std::vector<hint_cache_entry> entries;
+
+	for (const auto& hint : g_hints)
+	{
+		if (hint.second >= identity.base && hint.second - identity.base < identity.imageSize)
+		{
+			entries.push_back({ hint.first, static_cast<uint64_t>(hint.second - identity.base) });
+		}
+	}
+
+	hint_cache_header header = { hintCacheMagic, hintCacheVersion, identity.timestamp, identity.imageSize, identity.sectionHash, static_cast<uint32_t>(entries.size()), 0 };
+
+	// write a sibling temp file, then swap it in so readers never see a torn cache
+	const std::string tempPath = std::string(path) + ".tmp";
+	FILE* file = fopen(tempPath.c_str(), "wb");
+
+	if (!file)
+	{
+		return false;
+	}
+
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+		(entries.empty() || fwrite(entries.data(), sizeof(hint_cache_entry), entries.size(), file) == entries.size());
+
+	written = (fclose(file) == 0) && written;
+
+#if defined(_WIN32)
+	written = written && MoveFileExA(tempPath.c_str(), path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+	written = written && rename(tempPath.c_str(), path) == 0;
+#endif
+
+	if (!written)
+	{
+		remove(tempPath.c_str());
+	}
+
+	return written;
+}
+
+pattern::scan_stats pattern::get_scan_stats()
+{
+	return g_scanStats;
+}
 }
\ No newline at end of file
@@ -68,8 +68,12 @@ namespace hook
 		}
 	};
 
+	class pattern_batch;
+
 	class pattern
 	{
+		friend class pattern_batch;
+
 	private:
 		std::string m_bytes;
 		std::string m_mask;
@@ -163,6 +167,51 @@ namespace hook
 	public:
 		// define a hint
 		static void hint(uint64_t hash, uintptr_t address);
+
+		// Persistent hints for the main executable: load before creating patterns, save after the last scan.
+		// The file is keyed by the PE timestamp, image size and section table; a stale or foreign file is ignored.
+		static bool load_hint_cache(const char* path);
+		static bool save_hint_cache(const char* path);
+
+		struct scan_stats
+		{
+			uint32_t cacheEntries; // hints loaded from the cache file
+			uint32_t hintHits;     // patterns resolved from hints without scanning
+			uint32_t hintMisses;   // patterns whose hints were all stale
+			uint32_t scans;        // full range scans
+			double scanMilliseconds;
+		};
+
+		static scan_stats get_scan_stats();
+
+		// worker threads for scanning large ranges; 1 = single-threaded (default), 0 = automatic (up to 8).
+		// Only enable outside DllMain and loader callbacks: the scan waits for its workers, which need the loader lock.
+		static void set_scan_threads(unsigned count);
+	};
+
+	// Resolves several patterns with one pass over each distinct scan range instead of one full scan per pattern.
+	// Each pattern is anchored on its rarest fixed byte; a 256-entry table maps byte values to the patterns
+	// anchored on them, so most addresses cost a single lookup. Patterns already resolved (or satisfied by hints)
+	// are skipped, and `expected` stops a pattern early exactly like count().
+	class pattern_batch
+	{
+	private:
+		struct entry
+		{
+			pattern* target;
+			int maxCount;
+		};
+
+		std::vector<entry> m_entries;
+
+	public:
+		inline pattern_batch& add(pattern& target, int expected = INT_MAX)
+		{
+			m_entries.push_back({ &target, expected });
+			return *this;
+		}
+
+		void scan();
 	};
 
 	class module_pattern
@@ -170,10 +219,10 @@ namespace hook
 	{
 	public:
 		template<size_t Len>
-		module_pattern(void* module, const char(&pattern)[Len])
+		module_pattern(void* module, const char(&pattern_string)[Len])
 			: pattern(module)
 		{
-			Initialize(pattern, Len);
+			Initialize(pattern_string, Len);
 		}
 	};
 
@@ -182,12 +231,12 @@ namespace hook
 	{
 	public:
 		template<size_t Len>
-		range_pattern(uintptr_t begin, uintptr_t end, const char(&pattern)[Len]) : pattern()
+		range_pattern(uintptr_t begin, uintptr_t end, const char(&pattern_string)[Len]) : pattern()
 		{
 			m_module = getRVA<void>(0);
 			range_start = begin;
 			range_end = end;
-			Initialize(pattern, Len);
+			Initialize(pattern_string, Len);
 		}
 	};
 
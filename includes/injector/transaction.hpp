@@ -0,0 +1,325 @@
+/*
+ *  Injectors - Patch Transactions
+ *
+ *  Batches several small patches so each touched page is unprotected once, all writes are applied,
+ *  protection is restored and the instruction cache is flushed once. Original bytes are kept for rollback.
+ *
+ *  The page grouping and rollback logic only talk to a memory backend, so they can be driven by a fake backend
+ *  (no windows.h needed) as long as basic_transaction<Backend> is used directly.
+ *
+ *  This software is provided 'as-is', without any express or implied
+ *  warranty. In no event will the authors be held liable for any damages
+ *  arising from the use of this software.
+ *
+ */
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace injector
+{
+
+/*
+ *  Memory backend concept (used by basic_transaction)
+ *
+ *      size_t page_size();
+ *      bool   unprotect(uintptr_t page, size_t size, uint32_t& out_oldprotect);   // make RWX, report old protection
+ *      bool   protect(uintptr_t page, size_t size, uint32_t protection);          // restore @protection
+ *      void   read(uintptr_t addr, void* out, size_t size);
+ *      void   write(uintptr_t addr, const void* in, size_t size);
+ *      void   flush(uintptr_t addr, size_t size);                                 // instruction cache
+ */
+
+/*
+ *  basic_transaction
+ *      Collects writes and applies them in one go on commit()
+ *      Writes are applied in the order they were added; overlapping writes are allowed and rollback() undoes them in reverse
+ */
+template<class Backend>
+class basic_transaction
+{
+    public:
+        struct patch
+        {
+            uintptr_t               addr;
+            std::vector<uint8_t>    bytes;
+            std::vector<uint8_t>    original;   // filled on commit()
+        };
+
+        enum class state { pending, committed, rolled_back };
+
+    private:
+        struct page_protect
+        {
+            uintptr_t   page;
+            uint32_t    oldprotect;
+        };
+
+        Backend&            backend;
+        std::vector<patch>  patches;
+        state               current = state::pending;
+        size_t              pages_touched = 0;
+
+        // Sorted, unique page bases covering every queued write
+        std::vector<uintptr_t> collect_pages() const
+        {
+            const uintptr_t psize = backend.page_size();
+            std::vector<uintptr_t> pages;
+            for(auto& p : patches)
+            {
+                const uintptr_t first = p.addr & ~(psize - 1);
+                const uintptr_t last  = (p.addr + p.bytes.size() - 1) & ~(psize - 1);
+                for(uintptr_t page = first; ; page += psize)
+                {
+                    pages.push_back(page);
+                    if(page == last) break;
+                }
+            }
+            std::sort(pages.begin(), pages.end());
+            pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+            return pages;
+        }
+
+        // Unprotects every page once; on failure re-protects what was already unprotected and returns false
+        bool unprotect_pages(const std::vector<uintptr_t>& pages, std::vector<page_protect>& out)
+        {
+            const size_t psize = backend.page_size();
+            out.clear();
+            out.reserve(pages.size());
+            for(uintptr_t page : pages)
+            {
+                uint32_t oldprotect = 0;
+                if(!backend.unprotect(page, psize, oldprotect))
+                {
+                    reprotect_pages(out);
+                    return false;
+                }
+                out.push_back(page_protect{ page, oldprotect });
+            }
+            return true;
+        }
+
+        void reprotect_pages(std::vector<page_protect>& pages)
+        {
+            const size_t psize = backend.page_size();
+            for(auto it = pages.rbegin(); it != pages.rend(); ++it)
+                backend.protect(it->page, psize, it->oldprotect);
+            pages.clear();
+        }
+
+        void flush_patched_range()
+        {
+            uintptr_t lo = UINTPTR_MAX, hi = 0;
+            for(auto& p : patches)
+            {
+                lo = (std::min)(lo, p.addr);
+                hi = (std::max)(hi, p.addr + p.bytes.size());
+            }
+            if(lo < hi) backend.flush(lo, hi - lo);
+        }
+
+        void queue(uintptr_t addr, const void* bytes, size_t size)
+        {
+            if(size == 0 || current != state::pending) return;
+            patch p;
+            p.addr = addr;
+            p.bytes.assign(static_cast<const uint8_t*>(bytes), static_cast<const uint8_t*>(bytes) + size);
+            patches.push_back(std::move(p));
+        }
+
+        void queue_branch(uint8_t opcode, uintptr_t at, uintptr_t dest)
+        {
+            uint8_t insn[5];
+            const int32_t rel = static_cast<int32_t>(dest - (at + sizeof(insn)));
+            insn[0] = opcode;
+            memcpy(&insn[1], &rel, sizeof(rel));
+            queue(at, insn, sizeof(insn));
+        }
+
+    public:
+        explicit basic_transaction(Backend& backend) : backend(backend)
+        {}
+
+        basic_transaction(const basic_transaction&) = delete;
+        basic_transaction& operator=(const basic_transaction&) = delete;
+
+        /*
+         *  write_raw / write
+         *      Queues @size bytes from @value (or the object @value) to be written at @addr
+         */
+        void write_raw(uintptr_t addr, const void* value, size_t size)
+        {
+            queue(addr, value, size);
+        }
+
+        template<class T>
+        void write(uintptr_t addr, T value)
+        {
+            queue(addr, &value, sizeof(value));
+        }
+
+        /*
+         *  fill
+         *      Queues @size copies of the byte @value at @addr
+         */
+        void fill(uintptr_t addr, uint8_t value, size_t size)
+        {
+            std::vector<uint8_t> bytes(size, value);
+            queue(addr, bytes.data(), size);
+        }
+
+        /*
+         *  make_jmp / make_call
+         *      Queues a JMP/CALL rel32 at @at that branches into @dest
+         */
+        void make_jmp(uintptr_t at, uintptr_t dest)     { queue_branch(0xE9, at, dest); }
+        void make_call(uintptr_t at, uintptr_t dest)    { queue_branch(0xE8, at, dest); }
+
+        /*
+         *  make_nop
+         *      Queues @count NOP instructions at @at
+         */
+        void make_nop(uintptr_t at, size_t count = 1)   { fill(at, 0x90, count); }
+
+        /*
+         *  commit
+         *      Unprotects each touched page once, saves the original bytes, applies every write, restores protection
+         *      and flushes the instruction cache over the patched range.
+         *      Nothing is written when a page can't be unprotected; returns false in that case.
+         */
+        bool commit()
+        {
+            if(current != state::pending) return false;
+            if(patches.empty())
+            {
+                current = state::committed;
+                return true;
+            }
+
+            std::vector<page_protect> unprotected;
+            const std::vector<uintptr_t> pages = collect_pages();
+            if(!unprotect_pages(pages, unprotected))
+                return false;
+
+            for(auto& p : patches)
+            {
+                p.original.resize(p.bytes.size());
+                backend.read(p.addr, p.original.data(), p.original.size());
+                backend.write(p.addr, p.bytes.data(), p.bytes.size());
+            }
+
+            reprotect_pages(unprotected);
+            flush_patched_range();
+            pages_touched = pages.size();
+            current = state::committed;
+            return true;
+        }
+
+        /*
+         *  rollback
+         *      Writes back the original bytes of a committed transaction, last write first
+         */
+        bool rollback()
+        {
+            if(current != state::committed) return false;
+            if(patches.empty())
+            {
+                current = state::rolled_back;
+                return true;
+            }
+
+            std::vector<page_protect> unprotected;
+            if(!unprotect_pages(collect_pages(), unprotected))
+                return false;
+
+            for(auto it = patches.rbegin(); it != patches.rend(); ++it)
+                backend.write(it->addr, it->original.data(), it->original.size());
+
+            reprotect_pages(unprotected);
+            flush_patched_range();
+            current = state::rolled_back;
+            return true;
+        }
+
+        state                       status() const          { return current; }
+        size_t                      page_count() const      { return pages_touched; }
+        const std::vector<patch>&   queued() const          { return patches; }
+};
+
+
+#if defined(_WIN32) && defined(INJECTOR_HAS_INJECTOR_HPP)
+
+/*
+ *  vp_memory_backend
+ *      VirtualProtect / FlushInstructionCache on the current process
+ */
+struct vp_memory_backend
+{
+    size_t page_size()
+    {
+        static const size_t size = []
+        {
+            SYSTEM_INFO si;
+            GetSystemInfo(&si);
+            return size_t(si.dwPageSize);
+        }();
+        return size;
+    }
+
+    bool unprotect(uintptr_t page, size_t size, uint32_t& out_oldprotect)
+    {
+        DWORD oldprotect = 0;
+        if(!UnprotectMemory(memory_pointer_raw(page), size, oldprotect)) return false;
+        out_oldprotect = oldprotect;
+        return true;
+    }
+
+    bool protect(uintptr_t page, size_t size, uint32_t protection)
+    {
+        return ProtectMemory(memory_pointer_raw(page), size, protection);
+    }
+
+    void read(uintptr_t addr, void* out, size_t size)       { memcpy(out, reinterpret_cast<const void*>(addr), size); }
+    void write(uintptr_t addr, const void* in, size_t size) { memcpy(reinterpret_cast<void*>(addr), in, size); }
+
+    void flush(uintptr_t addr, size_t size)
+    {
+        FlushInstructionCache(GetCurrentProcess(), reinterpret_cast<const void*>(addr), size);
+    }
+};
+
+/*
+ *  transaction_backend_holder
+ *      Owns the backend of a transaction; listed as the first base so it is constructed before basic_transaction binds to it
+ */
+struct transaction_backend_holder
+{
+    vp_memory_backend vp;
+};
+
+/*
+ *  transaction
+ *      basic_transaction over the live process; addresses and destinations accept anything memory_pointer_tr does
+ */
+class transaction : private transaction_backend_holder, public basic_transaction<vp_memory_backend>
+{
+    public:
+        transaction() : basic_transaction<vp_memory_backend>(transaction_backend_holder::vp)
+        {}
+
+        // Translated like the immediate injector functions
+        static uintptr_t translate(memory_pointer_tr p)                 { return reinterpret_cast<uintptr_t>(p.get<void>()); }
+
+        template<class T>
+        void WriteMemory(memory_pointer_tr addr, T value)               { write<T>(translate(addr), value); }
+        void MakeJMP(memory_pointer_tr at, memory_pointer_raw dest)     { make_jmp(translate(at), translate(dest)); }
+        void MakeCALL(memory_pointer_tr at, memory_pointer_raw dest)    { make_call(translate(at), translate(dest)); }
+        void MakeNOP(memory_pointer_tr at, size_t count = 1)            { make_nop(translate(at), count); }
+};
+
+#endif
+
+} // namespace injector
@@ -5,10 +5,13 @@
 
 #include "dll_log.hpp"
 #include "hook_manager.hpp"
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <vector>
 #include <shared_mutex>
 #include <cstring> // std::strcmp
-#include <algorithm> // std::find_if, std::remove, std::remove_if
+#include <algorithm> // std::find_if, std::remove, std::remove_if, std::lower_bound, std::is_sorted, std::stable_sort
 #include <Windows.h>
 
 enum class hook_method
@@ -37,43 +40,213 @@ static bool s_is_loading_export_module = false;
 extern std::filesystem::path g_reshade_dll_path;
 static std::filesystem::path s_export_hook_path;
 static std::shared_mutex s_hooks_mutex;
-static std::vector<named_hook> s_hooks;
+static std::deque<named_hook> s_hooks; // Deque so that entries never move once added (the lookup index points into it)
 static std::shared_mutex s_delayed_hook_paths_mutex;
 static std::vector<std::filesystem::path> s_delayed_hook_paths;
 static PVOID s_dll_notification_cookie = nullptr;
 
-static std::vector<module_export> enumerate_module_exports(HMODULE handle)
+// Lookup index over the hook list, so that 'call' and 'is_hooked' (and with them every 'call_vtable') need neither a lock nor a linear search.
+// Maintained by 'install_internal' and 'uninstall' while they hold the hook list lock: a new hook is inserted into the published index in place (slots are
+// only ever filled, key last, so concurrent readers see either an empty slot or a complete one), and when the index gets half full a twice as large one
+// is built from the hook list and published with an atomic pointer swap. Entries in the hook list never change or move once added, so superseded indices
+// stay valid and are only freed in 'uninstall'; with the doubling they add up to less than the live one.
+struct hook_index
 {
-	const auto image_base = reinterpret_cast<const BYTE *>(handle);
-	const auto image_header = reinterpret_cast<const IMAGE_NT_HEADERS *>(image_base +
-		reinterpret_cast<const IMAGE_DOS_HEADER *>(image_base)->e_lfanew);
+	struct slot
+	{
+		std::atomic<reshade::hook::address> key = nullptr;
+		std::atomic<const named_hook *> hook = nullptr;
+	};
+
+	explicit hook_index(const std::deque<named_hook> &hooks)
+	{
+		size_t capacity = 16;
+		while (capacity < hooks.size() * 4)
+			capacity *= 2;
+		mask = capacity - 1;
+		by_target = std::make_unique<slot[]>(capacity);
+		by_replacement = std::make_unique<slot[]>(capacity);
+
+		// Insert in list order and keep the first entry per key, which is what a linear search would find
+		for (const named_hook &hook : hooks)
+			insert(hook);
+	}
+
+	size_t hash(reshade::hook::address key) const
+	{
+		uint64_t value = reinterpret_cast<uintptr_t>(key);
+		value ^= value >> 33;
+		value *= 0xFF51AFD7ED558CCDull;
+		value ^= value >> 33;
+		return static_cast<size_t>(value) & mask;
+	}
+
+	// Returns false once the tables are half full, so that probes stay short and never run out of empty slots
+	bool insert(const named_hook &hook)
+	{
+		if ((count + 1) * 2 > mask + 1)
+			return false;
+		count++;
+		insert(by_target.get(), hook.target, &hook);
+		insert(by_replacement.get(), hook.replacement, &hook);
+		return true;
+	}
+
+	void insert(slot *table, reshade::hook::address key, const named_hook *hook)
+	{
+		if (key == nullptr)
+			return;
+		for (size_t i = hash(key); ; i = (i + 1) & mask)
+		{
+			const reshade::hook::address existing = table[i].key.load(std::memory_order_relaxed);
+			if (existing == key)
+				return;
+			if (existing == nullptr)
+			{
+				table[i].hook.store(hook, std::memory_order_relaxed);
+				table[i].key.store(key, std::memory_order_release);
+				return;
+			}
+		}
+	}
+
+	const named_hook *find(const slot *table, reshade::hook::address key) const
+	{
+		for (size_t i = hash(key); ; i = (i + 1) & mask)
+		{
+			const reshade::hook::address existing = table[i].key.load(std::memory_order_acquire);
+			if (existing == key)
+				return table[i].hook.load(std::memory_order_relaxed);
+			if (existing == nullptr)
+				return nullptr;
+		}
+	}
+
+	size_t mask = 0;
+	size_t count = 0; // Written only under 's_hooks_mutex'
+	std::unique_ptr<slot[]> by_target;
+	std::unique_ptr<slot[]> by_replacement;
+};
+
+static std::atomic<const hook_index *> s_hook_index = nullptr;
+static std::vector<std::unique_ptr<hook_index>> s_hook_indices; // Every index ever published (protected by 's_hooks_mutex')
+
+// Adds the hook last appended to 's_hooks' to the index. Call with 's_hooks_mutex' held exclusively.
+static void index_new_hook_locked()
+{
+	if (!s_hook_indices.empty() && s_hook_indices.back()->insert(s_hooks.back()))
+		return;
+
+	s_hook_indices.push_back(std::make_unique<hook_index>(s_hooks));
+	s_hook_index.store(s_hook_indices.back().get(), std::memory_order_release);
+}
+
+// Export table of a module sorted by name (binary search) and indexed by ordinal, built once per module and cached by module base.
+// Names and addresses point into the mapped image, so a cached entry is only reused while the image at that base has the same time stamp and size.
+// Superseded entries stay allocated until 'uninstall', so pointers handed out never dangle.
+struct module_export_index
+{
+	explicit module_export_index(HMODULE handle) : module(handle)
+	{
+		const auto image_base = reinterpret_cast<const BYTE *>(handle);
+		const auto image_header = reinterpret_cast<const IMAGE_NT_HEADERS *>(image_base +
+			reinterpret_cast<const IMAGE_DOS_HEADER *>(image_base)->e_lfanew);
+
+		if (image_header->Signature != IMAGE_NT_SIGNATURE)
+			return; // The handle does not point to a valid module
+
+		timestamp = image_header->FileHeader.TimeDateStamp;
+		image_size = image_header->OptionalHeader.SizeOfImage;
 
-	if (image_header->Signature != IMAGE_NT_SIGNATURE ||
-		image_header->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT].Size == 0)
-		return {}; // The handle does not point to a valid module
+		if (image_header->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT].Size == 0)
+			return;
 
-	const auto export_dir = reinterpret_cast<const IMAGE_EXPORT_DIRECTORY *>(image_base +
-		image_header->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT].VirtualAddress);
-	const auto export_base = static_cast<WORD>(export_dir->Base);
+		const auto export_dir = reinterpret_cast<const IMAGE_EXPORT_DIRECTORY *>(image_base +
+			image_header->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT].VirtualAddress);
+		ordinal_base = static_cast<WORD>(export_dir->Base);
 
-	if (export_dir->NumberOfFunctions == 0)
-		return {}; // This module does not contain any exported functions
+		if (export_dir->NumberOfFunctions == 0)
+			return; // This module does not contain any exported functions
 
-	std::vector<module_export> exports;
-	exports.reserve(export_dir->NumberOfNames);
+		const auto functions = reinterpret_cast<const DWORD *>(image_base + export_dir->AddressOfFunctions);
+		const auto names = reinterpret_cast<const DWORD *>(image_base + export_dir->AddressOfNames);
+		const auto name_ordinals = reinterpret_cast<const WORD *>(image_base + export_dir->AddressOfNameOrdinals);
+
+		by_ordinal.resize(export_dir->NumberOfFunctions);
+		for (size_t i = 0; i < by_ordinal.size(); i++)
+			if (functions[i] != 0)
+				by_ordinal[i] = const_cast<void *>(reinterpret_cast<const void *>(image_base + functions[i]));
+
+		by_name.reserve(export_dir->NumberOfNames);
+		for (size_t i = 0; i < by_name.capacity(); i++)
+		{
+			module_export &symbol = by_name.emplace_back();
+			symbol.ordinal = ordinal_base + name_ordinals[i];
+			symbol.name = reinterpret_cast<const char *>(image_base + names[i]);
+			symbol.address = const_cast<void *>(reinterpret_cast<const void *>(image_base + functions[name_ordinals[i]]));
+		}
+
+		// The name table of a well-formed image is already sorted, so this is usually only the check
+		const auto name_less = [](const module_export &lhs, const module_export &rhs) { return std::strcmp(lhs.name, rhs.name) < 0; };
+		if (!std::is_sorted(by_name.begin(), by_name.end(), name_less))
+			std::stable_sort(by_name.begin(), by_name.end(), name_less);
+	}
+
+	bool matches(HMODULE handle, DWORD handle_timestamp, DWORD handle_image_size) const
+	{
+		return module == handle && timestamp == handle_timestamp && image_size == handle_image_size;
+	}
+
+	const module_export *find(const char *name) const
+	{
+		const auto it = std::lower_bound(by_name.begin(), by_name.end(), name,
+			[](const module_export &symbol, const char *name) { return std::strcmp(symbol.name, name) < 0; });
+		return it != by_name.end() && std::strcmp(it->name, name) == 0 ? &*it : nullptr;
+	}
+	reshade::hook::address find(unsigned short ordinal) const
+	{
+		return ordinal >= ordinal_base && static_cast<size_t>(ordinal - ordinal_base) < by_ordinal.size() ? by_ordinal[ordinal - ordinal_base] : nullptr;
+	}
+
+	HMODULE module;
+	DWORD timestamp = 0;
+	DWORD image_size = 0;
+	unsigned short ordinal_base = 0;
+	std::vector<module_export> by_name;
+	std::vector<reshade::hook::address> by_ordinal;
+};
+
+static std::shared_mutex s_export_indices_mutex;
+static std::vector<std::unique_ptr<const module_export_index>> s_export_indices;
+
+static const module_export_index &find_module_export_index(HMODULE handle)
+{
+	const auto image_base = reinterpret_cast<const BYTE *>(handle);
+	const auto image_header = reinterpret_cast<const IMAGE_NT_HEADERS *>(image_base +
+		reinterpret_cast<const IMAGE_DOS_HEADER *>(image_base)->e_lfanew);
+	const DWORD timestamp = image_header->Signature == IMAGE_NT_SIGNATURE ? image_header->FileHeader.TimeDateStamp : 0;
+	const DWORD image_size = image_header->Signature == IMAGE_NT_SIGNATURE ? image_header->OptionalHeader.SizeOfImage : 0;
+
+	const auto find_cached = [&]() -> const module_export_index * {
+		for (const std::unique_ptr<const module_export_index> &index : s_export_indices)
+			if (index->matches(handle, timestamp, image_size))
+				return index.get();
+		return nullptr;
+	};
 
-	for (size_t i = 0; i < exports.capacity(); i++)
 	{
-		module_export &symbol = exports.emplace_back();
-		symbol.ordinal = export_base +
-			reinterpret_cast<const  WORD *>(image_base + export_dir->AddressOfNameOrdinals)[i];
-		symbol.name = reinterpret_cast<const char *>(image_base +
-			reinterpret_cast<const DWORD *>(image_base + export_dir->AddressOfNames)[i]);
-		symbol.address = const_cast<void *>(reinterpret_cast<const void *>(image_base +
-			reinterpret_cast<const DWORD *>(image_base + export_dir->AddressOfFunctions)[symbol.ordinal - export_base]));
+		const std::shared_lock<std::shared_mutex> lock(s_export_indices_mutex);
+		if (const module_export_index *const index = find_cached())
+			return *index;
 	}
 
-	return exports;
+	auto index = std::make_unique<const module_export_index>(handle);
+
+	const std::unique_lock<std::shared_mutex> lock(s_export_indices_mutex);
+	if (const module_export_index *const existing = find_cached())
+		return *existing; // Another thread built it in the meantime
+
+	return *s_export_indices.emplace_back(std::move(index));
 }
 
 static bool install_internal(const char *name, reshade::hook &hook, hook_method method)
@@ -124,6 +297,7 @@ static bool install_internal(const char *name, reshade::hook &hook, hook_method
 	// Protect access to hook list with a mutex
 	{ const std::unique_lock<std::shared_mutex> lock(s_hooks_mutex);
 		s_hooks.push_back({ hook, name, method });
+		index_new_hook_locked();
 	}
 
 #if RESHADE_VERBOSE_LOG
@@ -140,11 +314,11 @@ static bool install_internal(HMODULE target_module, HMODULE replacement_module,
 		return false;
 	}
 
-	// Load export tables from both modules
-	const std::vector<module_export> target_exports = enumerate_module_exports(target_module);
-	const std::vector<module_export> replacement_exports = enumerate_module_exports(replacement_module);
+	// Look up the (cached) export tables of both modules
+	const module_export_index &target_exports = find_module_export_index(target_module);
+	const module_export_index &replacement_exports = find_module_export_index(replacement_module);
 
-	if (target_exports.empty())
+	if (target_exports.by_name.empty())
 	{
 		reshade::log::message(reshade::log::level::warning, "> Empty export table! Skipped.");
 		return false;
@@ -152,7 +326,7 @@ static bool install_internal(HMODULE target_module, HMODULE replacement_module,
 
 	size_t num_installed_hooks = 0;
 	std::vector<std::tuple<const char *, reshade::hook::address, reshade::hook::address>> matches;
-	matches.reserve(replacement_exports.size());
+	matches.reserve(replacement_exports.by_name.size());
 
 #if RESHADE_VERBOSE_LOG
 	reshade::log::message(reshade::log::level::debug, "> Dumping matches in export table:");
@@ -162,19 +336,16 @@ static bool install_internal(HMODULE target_module, HMODULE replacement_module,
 #endif
 
 	// Analyze export tables and find entries that exist in both modules
-	for (const module_export &symbol : target_exports)
+	for (const module_export &symbol : target_exports.by_name)
 	{
 		if (symbol.name == nullptr || symbol.address == nullptr)
 			continue;
 
 		// Find appropriate replacement
-		const auto it = std::find_if(replacement_exports.cbegin(), replacement_exports.cend(),
-			[&symbol](const module_export &module_export) {
-				return std::strcmp(module_export.name, symbol.name) == 0;
-			});
+		const module_export *const replacement = replacement_exports.find(symbol.name);
 
 		// Filter out uninteresting functions
-		if (it != replacement_exports.cend() &&
+		if (replacement != nullptr &&
 			std::strcmp(symbol.name, "CompatValue") != 0 &&
 			std::strcmp(symbol.name, "CompatString") != 0 &&
 			std::strcmp(symbol.name, "DXGIDumpJournal") != 0 &&
@@ -193,7 +364,7 @@ static bool install_internal(HMODULE target_module, HMODULE replacement_module,
 #if RESHADE_VERBOSE_LOG
 			reshade::log::message(reshade::log::level::debug, "  | %-016p | %-7hu | %-50s |", reinterpret_cast<uintptr_t>(symbol.address), symbol.ordinal, symbol.name);
 #endif
-			matches.push_back(std::make_tuple(symbol.name, symbol.address, it->address));
+			matches.push_back(std::make_tuple(symbol.name, symbol.address, replacement->address));
 		}
 	}
 
@@ -283,6 +454,26 @@ static named_hook find_internal(reshade::hook::address target, reshade::hook::ad
 {
 	assert(target != nullptr || replacement != nullptr);
 
+	// Fast path through the published index, which holds every installed hook
+	const hook_index *const index = s_hook_index.load(std::memory_order_acquire);
+	if (index == nullptr)
+		return named_hook {};
+
+	if (replacement == nullptr)
+	{
+		const named_hook *const hook = index->find(index->by_target.get(), target);
+		return hook != nullptr ? *hook : named_hook {};
+	}
+	if (target == nullptr)
+	{
+		const named_hook *const hook = index->find(index->by_replacement.get(), replacement);
+		return hook != nullptr ? *hook : named_hook {};
+	}
+
+	// The first hook for this target is the match unless the same target was hooked again with a different replacement, which the search below handles
+	if (const named_hook *const hook = index->find(index->by_target.get(), target); hook == nullptr || hook->replacement == replacement)
+		return hook != nullptr ? *hook : named_hook {};
+
 	// Protect access to hook list with a mutex
 	const std::shared_lock<std::shared_mutex> lock(s_hooks_mutex);
 
@@ -487,7 +678,18 @@ void reshade::hooks::uninstall()
 	for (named_hook &hook : s_hooks)
 		uninstall_internal(hook.name, hook, hook.method);
 
-	s_hooks.clear();
+	{ const std::unique_lock<std::shared_mutex> lock(s_hooks_mutex);
+		s_hooks.clear();
+
+		// No hooked function can be running anymore at this point, so all indices can be released
+		s_hook_index.store(nullptr, std::memory_order_release);
+		s_hook_indices.clear();
+	}
+
+	{
+		const std::unique_lock<std::shared_mutex> lock(s_export_indices_mutex);
+		s_export_indices.clear();
+	}
 
 #ifndef RESHADE_TEST_APPLICATION
 	if (s_dll_notification_cookie && s_dll_notification_cookie != reinterpret_cast<PVOID>(-1))
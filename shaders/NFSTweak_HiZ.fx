@@ -0,0 +1,82 @@
+// Hi-Z depth pyramid producer for NFSTweakBridge (NFSTWEAK_DEPTH_HIZ).
+// Do not enable this by hand: the add-on renders the hidden technique once per frame right before the
+// pre-HUD effects pass and copies the levels into one mip-chained texture published as NFSTWEAK_DEPTH_HIZ.
+// Put this file in your ReShade "Shaders" folder next to ShowCustomDepth.fx. Requires ReShade 5+.
+//
+// Consumers:
+//   texture HiZTex : NFSTWEAK_DEPTH_HIZ;
+//   sampler sHiZ { Texture = HiZTex; MagFilter = POINT; MinFilter = POINT; MipFilter = POINT; };
+//   float2 minmax = tex2Dlod(sHiZ, float4(uv, 0, level)).rg; // R = min raw depth, G = max raw depth
+// Mip 0 is half the buffer resolution; each following mip halves again (6 levels).
+
+texture NFSTweakDepthTex : NFSTWEAK_DEPTH;
+sampler sDepth { Texture = NFSTweakDepthTex; MagFilter = POINT; MinFilter = POINT; MipFilter = POINT; };
+
+#define HIZ_LEVEL_TEXTURE(n, div) \
+    texture NFSTweak_HiZ##n { Width = BUFFER_WIDTH / div; Height = BUFFER_HEIGHT / div; Format = RG32F; }; \
+    sampler sHiZ##n { Texture = NFSTweak_HiZ##n; MagFilter = POINT; MinFilter = POINT; MipFilter = POINT; };
+
+HIZ_LEVEL_TEXTURE(0, 2)
+HIZ_LEVEL_TEXTURE(1, 4)
+HIZ_LEVEL_TEXTURE(2, 8)
+HIZ_LEVEL_TEXTURE(3, 16)
+HIZ_LEVEL_TEXTURE(4, 32)
+HIZ_LEVEL_TEXTURE(5, 64)
+
+float4 VS_Fullscreen(uint id : SV_VertexID, out float2 uv : TEXCOORD) : SV_Position
+{
+    uv = float2((id << 1) & 2, id & 2);
+    return float4(uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+}
+
+// Conservative min/max over every source texel the destination texel overlaps.
+// Handles odd sizes and a depth buffer that does not match the back buffer (up to 3x per axis).
+float2 ReduceMinMax(sampler src, float2 vpos, int2 dst_size, bool single_channel)
+{
+    const int2 src_size = tex2Dsize(src);
+    const int2 dst = int2(vpos);
+    const int2 lo = (dst * src_size) / dst_size;
+    const int2 hi = min(((dst + 1) * src_size + dst_size - 1) / dst_size, src_size);
+
+    float2 mm = float2(1.0, 0.0);
+    [unroll] for (int y = 0; y < 3; ++y)
+    {
+        [unroll] for (int x = 0; x < 3; ++x)
+        {
+            const int2 p = lo + int2(x, y);
+            if (p.x < hi.x && p.y < hi.y)
+            {
+                const float2 v = single_channel ? tex2Dfetch(src, p).rr : tex2Dfetch(src, p).rg;
+                mm = float2(min(mm.x, v.x), max(mm.y, v.y));
+            }
+        }
+    }
+    return mm;
+}
+
+float2 PS_HiZ0(float4 pos : SV_Position, float2 uv : TEXCOORD) : SV_Target
+{
+    return ReduceMinMax(sDepth, pos.xy, int2(BUFFER_WIDTH / 2, BUFFER_HEIGHT / 2), true);
+}
+
+#define HIZ_REDUCE_PS(n, prev, div) \
+    float2 PS_HiZ##n(float4 pos : SV_Position, float2 uv : TEXCOORD) : SV_Target \
+    { \
+        return ReduceMinMax(sHiZ##prev, pos.xy, int2(BUFFER_WIDTH / div, BUFFER_HEIGHT / div), false); \
+    }
+
+HIZ_REDUCE_PS(1, 0, 4)
+HIZ_REDUCE_PS(2, 1, 8)
+HIZ_REDUCE_PS(3, 2, 16)
+HIZ_REDUCE_PS(4, 3, 32)
+HIZ_REDUCE_PS(5, 4, 64)
+
+technique NFSTweak_HiZ < hidden = true; ui_tooltip = "Rendered by NFSTweakBridge before the pre-HUD pass."; >
+{
+    pass { VertexShader = VS_Fullscreen; PixelShader = PS_HiZ0; RenderTarget = NFSTweak_HiZ0; }
+    pass { VertexShader = VS_Fullscreen; PixelShader = PS_HiZ1; RenderTarget = NFSTweak_HiZ1; }
+    pass { VertexShader = VS_Fullscreen; PixelShader = PS_HiZ2; RenderTarget = NFSTweak_HiZ2; }
+    pass { VertexShader = VS_Fullscreen; PixelShader = PS_HiZ3; RenderTarget = NFSTweak_HiZ3; }
+    pass { VertexShader = VS_Fullscreen; PixelShader = PS_HiZ4; RenderTarget = NFSTweak_HiZ4; }
+    pass { VertexShader = VS_Fullscreen; PixelShader = PS_HiZ5; RenderTarget = NFSTweak_HiZ5; }
+}
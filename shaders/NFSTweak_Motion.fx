@@ -0,0 +1,54 @@
+// Camera-motion vector producer for NFSTweakBridge (NFSTWEAK_MOTION).
+// Do not enable this by hand: the add-on renders the hidden technique once per frame on the pre-HUD
+// command list, after the depth snapshot (so depth and motion describe the same frame), and publishes a
+// copy of the result as NFSTWEAK_MOTION. Requires ReShade 5+ and the bridge camera feed.
+//
+// Consumers:
+//   texture MotionTex : NFSTWEAK_MOTION;
+//   sampler sMotion { Texture = MotionTex; MagFilter = POINT; MinFilter = POINT; };
+//   float2 prev_uv = uv + tex2D(sMotion, uv).rg; // where this pixel was last frame
+// Only camera-induced motion: moving cars are treated as static geometry. Zero without a camera feed
+// or on a camera cut.
+
+#include "NFSTweak_Normals.fxh" // depth linearization + view-space position helpers
+
+uniform float4x4 NFSTweakView < source = "nfstweak_view"; >;
+uniform float4x4 NFSTweakPrevView < source = "nfstweak_view_prev"; >;
+uniform float4x4 NFSTweakPrevProj < source = "nfstweak_proj_prev"; >;
+
+texture NFSTweakDepthTex : NFSTWEAK_DEPTH;
+sampler sDepth { Texture = NFSTweakDepthTex; MagFilter = POINT; MinFilter = POINT; MipFilter = POINT; };
+
+texture NFSTweak_MotionTex { Width = BUFFER_WIDTH; Height = BUFFER_HEIGHT; Format = RG16F; };
+
+float4 VS_Fullscreen(uint id : SV_VertexID, out float2 uv : TEXCOORD) : SV_Position
+{
+    uv = float2((id << 1) & 2, id & 2);
+    return float4(uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+}
+
+// View matrices are rigid (row vectors): inverse = [R^T 0; -t R^T 1].
+float3 ViewToWorld(float3 p)
+{
+    const float3x3 r = float3x3(NFSTweakView[0].xyz, NFSTweakView[1].xyz, NFSTweakView[2].xyz);
+    return mul(r, p - NFSTweakView[3].xyz);
+}
+
+float2 PS_Motion(float4 pos : SV_Position, float2 uv : TEXCOORD) : SV_Target
+{
+    // Flags: bit 0 = valid camera, bit 1 = cut.
+    if ((NFSTweakCameraFlags & 3u) != 1u)
+        return 0.0;
+
+    const float3 world = ViewToWorld(NFSTweak_ViewPosition(uv, tex2Dlod(sDepth, float4(uv, 0, 0)).r));
+    const float4 prev_clip = mul(mul(float4(world, 1.0), NFSTweakPrevView), NFSTweakPrevProj);
+    if (prev_clip.w <= 0.0)
+        return 0.0;
+    const float2 prev_uv = prev_clip.xy / prev_clip.w * float2(0.5, -0.5) + 0.5;
+    return prev_uv - uv;
+}
+
+technique NFSTweak_Motion < hidden = true; ui_tooltip = "Rendered by NFSTweakBridge before the pre-HUD pass."; >
+{
+    pass { VertexShader = VS_Fullscreen; PixelShader = PS_Motion; RenderTarget = NFSTweak_MotionTex; }
+}
@@ -0,0 +1,33 @@
+// View-space normal reconstruction producer for NFSTweakBridge (NFSTWEAK_NORMALS).
+// Do not enable this by hand: the add-on renders the hidden technique once per frame after the depth
+// snapshot and before the pre-HUD effects pass, then publishes a copy of the result as NFSTWEAK_NORMALS.
+// Requires ReShade 5+.
+//
+// Consumers:
+//   #include "NFSTweak_Normals.fxh"
+//   texture NormalsTex : NFSTWEAK_NORMALS;
+//   sampler sNormals { Texture = NormalsTex; MagFilter = POINT; MinFilter = POINT; };
+//   float3 n = NFSTweak_DecodeNormal(tex2D(sNormals, uv).rg);
+
+#include "NFSTweak_Normals.fxh"
+
+texture NFSTweakDepthTex : NFSTWEAK_DEPTH;
+sampler sDepth { Texture = NFSTweakDepthTex; MagFilter = POINT; MinFilter = POINT; MipFilter = POINT; };
+
+texture NFSTweak_NormalsTex { Width = BUFFER_WIDTH; Height = BUFFER_HEIGHT; Format = RG16; };
+
+float4 VS_Fullscreen(uint id : SV_VertexID, out float2 uv : TEXCOORD) : SV_Position
+{
+    uv = float2((id << 1) & 2, id & 2);
+    return float4(uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+}
+
+float2 PS_Normals(float4 pos : SV_Position, float2 uv : TEXCOORD) : SV_Target
+{
+    return NFSTweak_EncodeNormal(NFSTweak_ReconstructNormal(sDepth, uv));
+}
+
+technique NFSTweak_Normals < hidden = true; ui_tooltip = "Rendered by NFSTweakBridge before the pre-HUD pass."; >
+{
+    pass { VertexShader = VS_Fullscreen; PixelShader = PS_Normals; RenderTarget = NFSTweak_NormalsTex; }
+}
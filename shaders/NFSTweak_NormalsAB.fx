@@ -0,0 +1,70 @@
+// A/B benchmark: shared NFSTWEAK_NORMALS vs. per-effect normal reconstruction.
+// Enable NFSTweak_NormalsAB, then compare its GPU time in ReShade's Statistics tab with
+// NFSTWEAK_NORMALS_AB_INLINE = 0 (sample shared normals) and = 1 (reconstruct from depth in every pass).
+// For the shared case add the "normals" row of the NFSTweakBridge overlay (producer cost) to the total.
+// NFSTWEAK_NORMALS_AB_CONSUMERS models how many effects need normals in one frame.
+
+#include "NFSTweak_Normals.fxh"
+
+#ifndef NFSTWEAK_NORMALS_AB_INLINE
+    #define NFSTWEAK_NORMALS_AB_INLINE 0
+#endif
+#ifndef NFSTWEAK_NORMALS_AB_CONSUMERS
+    #define NFSTWEAK_NORMALS_AB_CONSUMERS 4
+#endif
+
+texture NFSTweakDepthTex : NFSTWEAK_DEPTH;
+sampler sDepth { Texture = NFSTweakDepthTex; MagFilter = POINT; MinFilter = POINT; MipFilter = POINT; };
+texture NFSTweakNormalsTex : NFSTWEAK_NORMALS;
+sampler sNormals { Texture = NFSTweakNormalsTex; MagFilter = POINT; MinFilter = POINT; MipFilter = POINT; };
+
+texture NFSTweak_NormalsABTex { Width = BUFFER_WIDTH; Height = BUFFER_HEIGHT; Format = RGBA8; };
+
+texture BackBufferTex : COLOR;
+sampler sColor { Texture = BackBufferTex; };
+sampler sAB { Texture = NFSTweak_NormalsABTex; };
+
+uniform bool NormalsABShow < ui_label = "Show normals"; > = false;
+
+float4 VS_Fullscreen(uint id : SV_VertexID, out float2 uv : TEXCOORD) : SV_Position
+{
+    uv = float2((id << 1) & 2, id & 2);
+    return float4(uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+}
+
+float3 ConsumerNormal(float2 uv)
+{
+#if NFSTWEAK_NORMALS_AB_INLINE
+    return NFSTweak_ReconstructNormal(sDepth, uv);
+#else
+    return NFSTweak_DecodeNormal(tex2Dlod(sNormals, float4(uv, 0, 0)).rg);
+#endif
+}
+
+// One pass per simulated consumer effect, each fetching normals the way that effect would.
+float4 PS_Consumer(float4 pos : SV_Position, float2 uv : TEXCOORD) : SV_Target
+{
+    return float4(ConsumerNormal(uv) * 0.5 + 0.5, 1.0);
+}
+
+float4 PS_Show(float4 pos : SV_Position, float2 uv : TEXCOORD) : SV_Target
+{
+    return NormalsABShow ? tex2D(sAB, uv) : tex2D(sColor, uv);
+}
+
+technique NFSTweak_NormalsAB
+{
+#if NFSTWEAK_NORMALS_AB_CONSUMERS >= 1
+    pass { VertexShader = VS_Fullscreen; PixelShader = PS_Consumer; RenderTarget = NFSTweak_NormalsABTex; }
+#endif
+#if NFSTWEAK_NORMALS_AB_CONSUMERS >= 2
+    pass { VertexShader = VS_Fullscreen; PixelShader = PS_Consumer; RenderTarget = NFSTweak_NormalsABTex; }
+#endif
+#if NFSTWEAK_NORMALS_AB_CONSUMERS >= 3
+    pass { VertexShader = VS_Fullscreen; PixelShader = PS_Consumer; RenderTarget = NFSTweak_NormalsABTex; }
+#endif
+#if NFSTWEAK_NORMALS_AB_CONSUMERS >= 4
+    pass { VertexShader = VS_Fullscreen; PixelShader = PS_Consumer; RenderTarget = NFSTweak_NormalsABTex; }
+#endif
+    pass { VertexShader = VS_Fullscreen; PixelShader = PS_Show; }
+}
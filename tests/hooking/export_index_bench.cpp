@@ -0,0 +1,260 @@
+// Export matching in ReShade's hook manager: the cached, name-sorted module_export_index against the per-call export
+// enumeration plus linear search it replaced. Matches every export of a target module against the exports of a
+// replacement module (what install_internal(HMODULE, HMODULE) does for each system DLL ReShade wraps):
+//   - linear: enumerate both export tables, then std::find_if by name for each target export (the old code);
+//   - cold:   find_module_export_index builds both indices, then binary search by name;
+//   - warm:   both indices come from the cache.
+// Also times single name lookups, and checks that every method finds the same matches, that ordinal lookups return
+// the export table entries and that a changed image at the same base is not served from the cache.
+// Without file arguments both modules are synthetic PE32 images (the replacement exports every 4th target name plus
+// some of its own).
+//
+//   export_index_bench [--exports N] [--lookups L] [--repeat R] [--seed S] [target.dll replacement.dll]
+
+#include <cassert>
+#include <mutex> // std::unique_lock, which hook_manager.cpp gets transitively on MSVC
+#include <windows.h>
+#include "../../includes/reshade/hook_manager.cpp"
+#include "hook_manager_host.hpp"
+#include "pe_image.hpp"
+
+#include <chrono>
+#include <set>
+#include <tuple>
+
+FARPROC GetProcAddress(HMODULE, LPCSTR) { return nullptr; }
+
+namespace
+{
+uint32_t s_failures = 0;
+
+void expect(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        ++s_failures;
+        fprintf(stderr, "FAIL %s\n", what);
+    }
+}
+
+using export_match = std::tuple<const char *, reshade::hook::address, reshade::hook::address>;
+
+// The export enumeration hook_manager.cpp did on every install_internal(HMODULE, HMODULE) call before the index
+std::vector<module_export> enumerate_module_exports(HMODULE handle)
+{
+    const auto image_base = reinterpret_cast<const BYTE *>(handle);
+    const auto image_header = reinterpret_cast<const IMAGE_NT_HEADERS *>(image_base + reinterpret_cast<const IMAGE_DOS_HEADER *>(image_base)->e_lfanew);
+    if (image_header->Signature != IMAGE_NT_SIGNATURE || image_header->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT].Size == 0)
+        return {};
+    const auto export_dir = reinterpret_cast<const IMAGE_EXPORT_DIRECTORY *>(image_base + image_header->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT].VirtualAddress);
+    const auto export_base = static_cast<WORD>(export_dir->Base);
+    if (export_dir->NumberOfFunctions == 0)
+        return {};
+
+    std::vector<module_export> exports;
+    exports.reserve(export_dir->NumberOfNames);
+    for (size_t i = 0; i < exports.capacity(); i++)
+    {
+        module_export &symbol = exports.emplace_back();
+        symbol.ordinal = export_base + reinterpret_cast<const WORD *>(image_base + export_dir->AddressOfNameOrdinals)[i];
+        symbol.name = reinterpret_cast<const char *>(image_base + reinterpret_cast<const DWORD *>(image_base + export_dir->AddressOfNames)[i]);
+        symbol.address = const_cast<void *>(reinterpret_cast<const void *>(image_base +
+            reinterpret_cast<const DWORD *>(image_base + export_dir->AddressOfFunctions)[symbol.ordinal - export_base]));
+    }
+    return exports;
+}
+
+std::vector<export_match> match_linear(HMODULE target, HMODULE replacement)
+{
+    const std::vector<module_export> target_exports = enumerate_module_exports(target);
+    const std::vector<module_export> replacement_exports = enumerate_module_exports(replacement);
+    std::vector<export_match> matches;
+    for (const module_export &symbol : target_exports)
+    {
+        const auto it = std::find_if(replacement_exports.cbegin(), replacement_exports.cend(),
+            [&symbol](const module_export &e) { return std::strcmp(e.name, symbol.name) == 0; });
+        if (it != replacement_exports.cend())
+            matches.emplace_back(symbol.name, symbol.address, it->address);
+    }
+    return matches;
+}
+
+// The matching loop of install_internal(HMODULE, HMODULE), without its filter list
+std::vector<export_match> match_indexed(HMODULE target, HMODULE replacement)
+{
+    const module_export_index &target_exports = find_module_export_index(target);
+    const module_export_index &replacement_exports = find_module_export_index(replacement);
+    std::vector<export_match> matches;
+    matches.reserve(replacement_exports.by_name.size());
+    for (const module_export &symbol : target_exports.by_name)
+        if (const module_export *const r = replacement_exports.find(symbol.name))
+            matches.emplace_back(symbol.name, symbol.address, r->address);
+    return matches;
+}
+
+std::vector<export_match> sorted(std::vector<export_match> matches)
+{
+    std::sort(matches.begin(), matches.end(), [](const export_match &a, const export_match &b) { return std::strcmp(std::get<0>(a), std::get<0>(b)) < 0; });
+    return matches;
+}
+
+void clear_export_cache()
+{
+    const std::unique_lock<std::shared_mutex> lock(s_export_indices_mutex);
+    s_export_indices.clear();
+}
+
+template <typename F>
+double best_ms(uint32_t repeat, F &&body)
+{
+    double best = 0.0;
+    for (uint32_t r = 0; r < repeat; ++r)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        body();
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        best = (r == 0) ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+// Export names shaped like system DLL exports: shared prefixes, so comparisons do not end at the first character
+std::vector<std::string> make_names(size_t count, std::mt19937 &rng, const char *tag)
+{
+    static const char *const prefixes[] = { "D3D", "D3DKMT", "Direct3D", "DXGI", "Nt", "Rtl", "Ldr", "Create", "Get", "Set" };
+    std::set<std::string> names;
+    while (names.size() < count)
+    {
+        std::string name = prefixes[rng() % std::size(prefixes)];
+        name += tag;
+        const size_t length = 4 + rng() % 24;
+        for (size_t i = 0; i < length; ++i)
+            name += static_cast<char>((i % 5 == 0 ? 'A' : 'a') + rng() % 26);
+        names.insert(std::move(name));
+    }
+    return { names.begin(), names.end() };
+}
+
+void check_ordinals(pe_image &image)
+{
+    const module_export_index &index = find_module_export_index(image.module());
+    const std::vector<module_export> exports = enumerate_module_exports(image.module());
+    bool ok = !exports.empty();
+    for (const module_export &symbol : exports)
+        ok = ok && index.find(symbol.ordinal) == symbol.address;
+    ok = ok && index.find(static_cast<unsigned short>(index.ordinal_base - 1)) == nullptr &&
+        index.find(static_cast<unsigned short>(index.ordinal_base + index.by_ordinal.size())) == nullptr;
+    expect(ok, "ordinal lookups return the export table entries");
+}
+
+void check_cache_identity(pe_image &image)
+{
+    const module_export_index *const first = &find_module_export_index(image.module());
+    expect(&find_module_export_index(image.module()) == first, "second lookup served from the cache");
+    image.nt_headers()->FileHeader.TimeDateStamp ^= 1;
+    const module_export_index *const changed = &find_module_export_index(image.module());
+    expect(changed != first && changed->timestamp == image.nt_headers()->FileHeader.TimeDateStamp, "changed image at the same base gets a new index");
+    image.nt_headers()->FileHeader.TimeDateStamp ^= 1;
+    expect(&find_module_export_index(image.module()) == first, "original image still matches its cached index");
+}
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t export_count = 4000;
+    uint32_t lookup_count = 100000;
+    uint32_t repeat = 5;
+    uint32_t seed = 1;
+    std::vector<const char *> files;
+    bool usage = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--exports" && i + 1 < argc)
+            export_count = std::max(1u, static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10)));
+        else if (arg == "--lookups" && i + 1 < argc)
+            lookup_count = std::max(1u, static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10)));
+        else if (arg == "--repeat" && i + 1 < argc)
+            repeat = std::max(1u, static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10)));
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (arg.rfind("--", 0) != 0)
+            files.push_back(argv[i]);
+        else
+            usage = true;
+    }
+    if (usage || (files.size() != 0 && files.size() != 2))
+    {
+        fprintf(stderr, "usage: %s [--exports N] [--lookups L] [--repeat R] [--seed S] [target.dll replacement.dll]\n", argv[0]);
+        return 2;
+    }
+
+    pe_image target, replacement;
+    if (files.empty())
+    {
+        std::mt19937 rng(seed);
+        const std::vector<std::string> target_names = make_names(export_count, rng, "");
+        std::vector<std::string> replacement_names = make_names(export_count / 16 + 1, rng, "ReShade");
+        for (size_t i = 0; i < target_names.size(); i += 4)
+            replacement_names.push_back(target_names[i]);
+        make_export_pe_image(target, target_names, 0x50000000u + seed);
+        make_export_pe_image(replacement, replacement_names, 0x60000000u + seed, 100);
+    }
+    else
+    {
+        pe_image *const images[] = { &target, &replacement };
+        for (size_t i = 0; i < 2; ++i)
+        {
+            std::string error;
+            if (!load_pe_image(files[i], *images[i], error) || (!images[i]->pe32 && !(error = "PE32+ export tables are not supported by the 32-bit shim").empty()))
+            {
+                fprintf(stderr, "%s: %s\n", files[i], error.c_str());
+                return 2;
+            }
+        }
+    }
+
+    const std::vector<module_export> target_exports = enumerate_module_exports(target.module());
+    const std::vector<module_export> replacement_exports = enumerate_module_exports(replacement.module());
+    printf("%s: %zu exports, %s: %zu exports\n", target.name.c_str(), target_exports.size(), replacement.name.c_str(), replacement_exports.size());
+
+    std::vector<export_match> linear, cold, warm;
+    const double linear_ms = best_ms(repeat, [&]() { linear = match_linear(target.module(), replacement.module()); });
+    const double cold_ms = best_ms(repeat, [&]() { clear_export_cache(); cold = match_indexed(target.module(), replacement.module()); });
+    const double warm_ms = best_ms(repeat, [&]() { warm = match_indexed(target.module(), replacement.module()); });
+    printf("  %-34s %10s %9s\n", "match all exports", "ms", "speedup");
+    printf("  %-34s %10.3f %9s\n", "linear (enumerate + find_if)", linear_ms, "");
+    printf("  %-34s %10.3f %8.1fx\n", "index, cold (build + binary search)", cold_ms, cold_ms > 0.0 ? linear_ms / cold_ms : 0.0);
+    printf("  %-34s %10.3f %8.1fx\n", "index, warm (cached)", warm_ms, warm_ms > 0.0 ? linear_ms / warm_ms : 0.0);
+    printf("  matches=%zu\n", linear.size());
+    expect(sorted(cold) == sorted(linear) && sorted(warm) == sorted(linear), "indexed matching finds the linear matches");
+    if (files.empty())
+        expect(linear.size() == (export_count + 3) / 4, "every shared name matched");
+
+    // Single lookups of names the replacement exports, as 'call' falls back to when an export hook is resolved late
+    if (!replacement_exports.empty())
+    {
+        std::mt19937 rng(seed);
+        std::vector<const char *> names(lookup_count);
+        for (const char *&name : names)
+            name = replacement_exports[rng() % replacement_exports.size()].name;
+        const module_export_index &index = find_module_export_index(replacement.module());
+        size_t found_indexed = 0, found_linear = 0;
+        const double indexed_ns = best_ms(1, [&]() {
+            for (const char *name : names)
+                found_indexed += index.find(name) != nullptr;
+        }) * 1e6 / lookup_count;
+        const double linear_ns = best_ms(1, [&]() {
+            for (const char *name : names)
+                found_linear += std::find_if(replacement_exports.cbegin(), replacement_exports.cend(),
+                    [name](const module_export &e) { return std::strcmp(e.name, name) == 0; }) != replacement_exports.cend();
+        }) * 1e6 / lookup_count;
+        printf("  name lookup: index %.1f ns, linear %.1f ns (%.1fx)\n", indexed_ns, linear_ns, indexed_ns > 0.0 ? linear_ns / indexed_ns : 0.0);
+        expect(found_indexed == lookup_count && found_linear == lookup_count, "every looked up name found");
+    }
+
+    check_ordinals(target);
+    check_ordinals(replacement);
+    check_cache_identity(target);
+    return s_failures != 0 ? 1 : 0;
+}
@@ -0,0 +1,189 @@
+// Lookup cost of ReShade's hook manager with many installed hooks (the 'is_hooked'/'call' pair behind every 'call_vtable').
+// Builds hook_manager.cpp as-is (RESHADE_TEST_APPLICATION, so no loader notifications) with a fake reshade::hook in place
+// of MinHook, installs N function hooks and N vtable hooks, then times lookups through the index published by
+// 'install_internal' against the linear search over the hook list it replaced (shared lock plus std::find_if):
+//   - is_hooked on hooked vtable entries and on entries that are not hooked (the common 'call_vtable' case);
+//   - call(replacement) for function hooks and call(replacement, target) for vtable hooks.
+// Every lookup must agree with the linear search. A reader thread also looks up each hook while the others are still
+// being installed, which must find every hook whose install already returned.
+//
+//   hook_index_bench [--hooks N] [--lookups L] [--seed S]
+
+#include <cassert>
+#include <mutex> // std::unique_lock, which hook_manager.cpp gets transitively on MSVC
+#include <windows.h>
+#include "../../includes/reshade/hook_manager.cpp"
+#include "hook_manager_host.hpp"
+
+#include <chrono>
+#include <random>
+#include <thread>
+
+FARPROC GetProcAddress(HMODULE, LPCSTR) { return nullptr; }
+
+namespace
+{
+uint32_t s_failures = 0;
+
+void expect(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        ++s_failures;
+        fprintf(stderr, "FAIL %s\n", what);
+    }
+}
+
+// The lookup 'find_internal' did before the index: every call takes the shared lock and walks the list.
+named_hook find_linear(reshade::hook::address target, reshade::hook::address replacement)
+{
+    const std::shared_lock<std::shared_mutex> lock(s_hooks_mutex);
+    const auto it = std::find_if(s_hooks.cbegin(), s_hooks.cend(),
+        [target, replacement](const named_hook &hook) {
+            if (replacement == nullptr)
+                return hook.target == target;
+            return hook.replacement == replacement && (target == nullptr || hook.target == target);
+        });
+    return it != s_hooks.cend() ? *it : named_hook {};
+}
+
+struct hook_set
+{
+    explicit hook_set(size_t count) :
+        function_targets(count), function_replacements(count), vtable(count), vtable_originals(count), vtable_replacements(count), unhooked_vtable(count) {}
+
+    reshade::hook::address function_target(size_t i) { return &function_targets[i]; }
+    reshade::hook::address function_replacement(size_t i) { return &function_replacements[i]; }
+    reshade::hook::address vtable_replacement(size_t i) { return &vtable_replacements[i]; }
+
+    // Distinct addresses standing in for functions; vtables are writable arrays of such addresses
+    std::vector<char> function_targets, function_replacements;
+    std::vector<reshade::hook::address> vtable;
+    std::vector<char> vtable_originals, vtable_replacements;
+    std::vector<reshade::hook::address> unhooked_vtable;
+};
+
+double install_all(hook_set &set, std::atomic<size_t> *installed = nullptr)
+{
+    for (size_t i = 0; i < set.vtable.size(); i++)
+        set.vtable[i] = &set.vtable_originals[i];
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < set.vtable.size(); i++)
+    {
+        expect(reshade::hooks::install("function", set.function_target(i), set.function_replacement(i), true), "function hook installed");
+        expect(reshade::hooks::install("vtable", set.vtable.data(), i, set.vtable_replacement(i)), "vtable hook installed");
+        if (installed != nullptr)
+            installed->store(i + 1, std::memory_order_release);
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Returns nanoseconds per lookup; 'checksum' keeps the lookups from being optimized away
+template <typename F>
+double time_lookups(const std::vector<uint32_t> &order, F &&lookup, uintptr_t &checksum)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (const uint32_t i : order)
+        checksum += reinterpret_cast<uintptr_t>(lookup(i));
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / static_cast<double>(order.size());
+}
+
+// Looks every hook up while they are being installed: anything whose install returned must already be in the published index.
+void test_concurrent_install(hook_set &set)
+{
+    std::atomic<size_t> installed = 0;
+    std::atomic<bool> done = false;
+    std::atomic<uint32_t> missing = 0;
+    std::thread reader([&]() {
+        while (!done.load(std::memory_order_acquire))
+        {
+            const size_t count = installed.load(std::memory_order_acquire);
+            for (size_t i = 0; i < count; i++)
+                if (!reshade::hooks::is_hooked(&set.vtable[i]) || reshade::hooks::call(set.function_replacement(i)) != set.function_target(i))
+                    missing.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    install_all(set, &installed);
+    done.store(true, std::memory_order_release);
+    reader.join();
+    expect(missing.load() == 0, "hooks visible to a concurrent reader once installed");
+}
+}
+
+int main(int argc, char **argv)
+{
+    size_t hook_count = 1000;
+    size_t lookup_count = 200000;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--hooks" && i + 1 < argc)
+            hook_count = std::max<size_t>(1, strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--lookups" && i + 1 < argc)
+            lookup_count = std::max<size_t>(1, strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else
+        {
+            fprintf(stderr, "usage: %s [--hooks N] [--lookups L] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    hook_set set(hook_count);
+    const double install_us = install_all(set);
+    expect(s_hooks.size() == hook_count * 2, "every hook in the list");
+
+    size_t index_bytes = 0;
+    for (const std::unique_ptr<hook_index> &index : s_hook_indices)
+        index_bytes += (index->mask + 1) * 2 * sizeof(hook_index::slot);
+    printf("hooks=%zu (function %zu, vtable %zu) install=%.1f us (%.0f ns/hook) indices=%zu index memory=%.1f KB\n", s_hooks.size(), hook_count, hook_count,
+        install_us, install_us * 1000.0 / static_cast<double>(s_hooks.size()), s_hook_indices.size(), index_bytes / 1024.0);
+
+    // Every lookup through the index must return what the linear search finds
+    for (size_t i = 0; i < hook_count; i++)
+    {
+        expect(find_internal(&set.vtable[i], nullptr).replacement == find_linear(&set.vtable[i], nullptr).replacement, "is_hooked agrees");
+        expect(!reshade::hooks::is_hooked(&set.unhooked_vtable[i]), "unhooked entry not reported");
+        expect(reshade::hooks::call(set.function_replacement(i)) == find_linear(nullptr, set.function_replacement(i)).call(), "call(replacement) agrees");
+        expect(reshade::hooks::call(set.vtable_replacement(i), &set.vtable[i]) == &set.vtable_originals[i], "call(replacement, target) returns the original entry");
+        expect(set.vtable[i] == set.vtable_replacement(i), "vtable entry replaced");
+    }
+
+    std::vector<uint32_t> order(lookup_count);
+    std::mt19937 rng(seed);
+    for (uint32_t &i : order)
+        i = static_cast<uint32_t>(rng() % hook_count);
+
+    uintptr_t checksum = 0;
+    struct row { const char *label; double indexed, linear; };
+    const row rows[] = {
+        { "is_hooked (hooked)",
+            time_lookups(order, [&](uint32_t i) { return find_internal(&set.vtable[i], nullptr).trampoline; }, checksum),
+            time_lookups(order, [&](uint32_t i) { return find_linear(&set.vtable[i], nullptr).trampoline; }, checksum) },
+        { "is_hooked (not hooked)",
+            time_lookups(order, [&](uint32_t i) { return find_internal(&set.unhooked_vtable[i], nullptr).trampoline; }, checksum),
+            time_lookups(order, [&](uint32_t i) { return find_linear(&set.unhooked_vtable[i], nullptr).trampoline; }, checksum) },
+        { "call(replacement)",
+            time_lookups(order, [&](uint32_t i) { return find_internal(nullptr, set.function_replacement(i)).trampoline; }, checksum),
+            time_lookups(order, [&](uint32_t i) { return find_linear(nullptr, set.function_replacement(i)).trampoline; }, checksum) },
+        { "call(replacement, target)",
+            time_lookups(order, [&](uint32_t i) { return find_internal(&set.vtable[i], set.vtable_replacement(i)).trampoline; }, checksum),
+            time_lookups(order, [&](uint32_t i) { return find_linear(&set.vtable[i], set.vtable_replacement(i)).trampoline; }, checksum) },
+    };
+    printf("  %-26s %12s %12s %9s\n", "lookup", "index (ns)", "linear (ns)", "speedup");
+    for (const row &r : rows)
+        printf("  %-26s %12.1f %12.1f %8.1fx\n", r.label, r.indexed, r.linear, r.indexed > 0.0 ? r.linear / r.indexed : 0.0);
+    printf("  checksum %zx\n", static_cast<size_t>(checksum));
+
+    reshade::hooks::uninstall();
+    expect(s_hooks.empty() && s_hook_indices.empty() && s_hook_index.load() == nullptr, "uninstall releases the hook list and indices");
+    expect(!reshade::hooks::is_hooked(&set.vtable[0]), "nothing hooked after uninstall");
+    expect(set.vtable[0] == &set.vtable_originals[0], "uninstall restores vtable entries");
+
+    test_concurrent_install(set);
+    reshade::hooks::uninstall();
+    return s_failures != 0 ? 1 : 0;
+}
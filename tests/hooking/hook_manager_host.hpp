@@ -0,0 +1,24 @@
+#pragma once
+// What hook_manager.cpp needs from the rest of ReShade when a test builds it directly (after including it with
+// RESHADE_TEST_APPLICATION): the module globals and a MinHook stand-in where installing a function hook just makes its
+// trampoline the target.
+
+#include <filesystem>
+
+HMODULE g_module_handle = nullptr;
+std::filesystem::path g_reshade_dll_path = "ReShade.dll";
+
+void reshade::hook::enable() const {}
+void reshade::hook::disable() const {}
+reshade::hook::status reshade::hook::install()
+{
+    trampoline = target;
+    return status::success;
+}
+reshade::hook::status reshade::hook::uninstall()
+{
+    trampoline = nullptr;
+    return status::success;
+}
+reshade::hook::address reshade::hook::call() const { return trampoline; }
+bool reshade::hook::apply_queued_actions() { return true; }
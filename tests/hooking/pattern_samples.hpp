@@ -0,0 +1,60 @@
+#pragma once
+// Patterns sampled from a PE image's code for the scanner tests. Include after Hooking.Patterns.cpp.
+
+#include "pe_image.hpp"
+
+// Pattern text in IDA format, zero-filled: module_pattern hashes the whole array.
+struct pattern_text
+{
+    char text[160] = {};
+};
+
+// Samples from the range the scanner covers: [base, base + SizeOfCode], intersected with the code section.
+inline std::vector<pattern_text> sample_patterns(pe_image &image, uint32_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    const uint32_t scan_end = image.nt_headers()->OptionalHeader.SizeOfCode;
+    const uint32_t code_end = std::min(image.code_rva + image.code_size, scan_end);
+    std::vector<pattern_text> patterns;
+    if (code_end <= image.code_rva + 64)
+        return patterns;
+
+    for (uint32_t attempts = 0; patterns.size() < count && attempts < count * 1000; ++attempts)
+    {
+        const uint32_t length = 12 + rng() % 21;
+        const uint32_t rva = image.code_rva + rng() % (code_end - image.code_rva - length);
+        const uint8_t *bytes = image.base() + rva;
+
+        // Skip padding and zero runs: they match thousands of times and say nothing about code scanning.
+        uint32_t filler = 0;
+        for (uint32_t i = 0; i < length; ++i)
+            filler += (bytes[i] == 0x00 || bytes[i] == 0xCC || bytes[i] == 0x90) ? 1 : 0;
+        if (filler * 3 > length)
+            continue;
+
+        pattern_text p;
+        size_t pos = 0;
+        for (uint32_t i = 0; i < length; ++i)
+        {
+            // Wildcard an occasional 4-byte immediate, never the first byte.
+            if (i > 0 && i + 4 <= length && rng() % 8 == 0)
+            {
+                for (int k = 0; k < 4; ++k, ++i)
+                    pos += snprintf(p.text + pos, sizeof(p.text) - pos, "%s?", pos != 0 ? " " : "");
+                --i;
+                continue;
+            }
+            pos += snprintf(p.text + pos, sizeof(p.text) - pos, "%s%02X", pos != 0 ? " " : "", bytes[i]);
+        }
+        patterns.push_back(p);
+    }
+    return patterns;
+}
+
+inline std::vector<uintptr_t> match_addresses(hook::pattern &p)
+{
+    std::vector<uintptr_t> addresses;
+    for (size_t i = 0; i < p.size(); ++i)
+        addresses.push_back(reinterpret_cast<uintptr_t>(p.get(static_cast<int>(i)).get<void>()));
+    return addresses;
+}
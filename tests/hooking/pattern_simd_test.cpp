@@ -0,0 +1,304 @@
+// Equivalence tests and throughput benchmark for the vector paths of Hooking.Patterns.cpp.
+// Builds the scanner TU as-is and calls ScanScalar / ScanSse2 / ScanAvx2 and VerifyScalar / VerifySse2 / VerifyAvx2
+// directly (AVX2 only when the CPU has it):
+//   - verify: every pattern length 1..96 with several masks, and a mismatch at every byte position;
+//   - scan: every pattern length 1..72, every range start 0..33, range ends sweeping the last 70 bytes and a stride
+//     elsewhere, natural and edge anchors, collect-all and stop-at-first; low-entropy data so partial matches abound.
+// The data and pattern buffers end at a PROT_NONE page, so any read past the last byte a pattern may cover faults.
+// Exits non-zero on any difference from the scalar path.
+//
+//   pattern_simd_test [--bench] [--mb N] [--seed S]
+
+#include <windows.h>
+#include "../../includes/hooking/Hooking.Patterns.cpp"
+#include "pe_image.hpp"
+
+#include <chrono>
+#include <sys/mman.h>
+
+using namespace hook;
+
+namespace
+{
+bool s_avx2 = false;
+uint64_t s_checks = 0;
+uint64_t s_failures = 0;
+
+// `size` readable bytes followed by an inaccessible page. Leaked on purpose: the tests allocate a handful.
+uint8_t *guarded_alloc(size_t size)
+{
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t span = (size + page - 1) / page * page;
+    auto *mem = static_cast<uint8_t *>(mmap(nullptr, span + page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (mem == MAP_FAILED)
+    {
+        perror("mmap");
+        exit(2);
+    }
+    mprotect(mem + span, page, PROT_NONE);
+    return mem + span - size;
+}
+
+void check(bool ok, const char *what, size_t a, size_t b, size_t c)
+{
+    ++s_checks;
+    if (!ok && s_failures++ < 20)
+        fprintf(stderr, "FAIL %s (%zu, %zu, %zu)\n", what, a, b, c);
+}
+
+// Pattern bytes live in a guarded buffer too, so the vector verifiers cannot read past pattern.size either.
+struct test_pattern
+{
+    masked_pattern compiled;
+    uint8_t *storage = nullptr;
+    std::string bytes;
+    std::string mask;
+
+    void assign(const uint8_t *source, size_t size, const std::vector<bool> &wildcard)
+    {
+        bytes.assign(reinterpret_cast<const char *>(source), size);
+        mask.assign(size, 'x');
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (wildcard[i])
+            {
+                bytes[i] = 0;
+                mask[i] = '?';
+            }
+        }
+        storage = guarded_alloc(size);
+        memcpy(storage, bytes.data(), size);
+        compiled.bytes = storage;
+        compiled.size = size;
+        compiled.mask.assign(size, 0);
+        for (size_t i = 0; i < size; ++i)
+            compiled.mask[i] = (mask[i] == '?') ? 0x00 : 0xFF;
+        set_anchors(SelectAnchor(bytes, mask), std::string::npos);
+    }
+
+    // anchor1 = npos picks the library's second anchor.
+    void set_anchors(size_t anchor0, size_t anchor1)
+    {
+        compiled.anchor0 = anchor0;
+        compiled.anchor1 = (anchor1 != std::string::npos) ? anchor1 : SelectAnchor(bytes, mask, anchor0);
+        if (compiled.anchor1 == std::string::npos)
+            compiled.anchor1 = compiled.anchor0;
+    }
+
+    bool all_wildcards() const { return compiled.anchor0 == std::string::npos; }
+};
+
+std::vector<bool> make_wildcards(size_t size, uint32_t variant, std::mt19937 &rng)
+{
+    std::vector<bool> wildcard(size, false);
+    for (size_t i = 0; i < size; ++i)
+    {
+        switch (variant)
+        {
+        case 0: break;                                          // all fixed
+        case 1: wildcard[i] = (i % 2) == 1; break;             // alternating
+        case 2: wildcard[i] = (i % 16) >= 12; break;           // immediates at the end of each 16-byte chunk
+        case 3: wildcard[i] = i != size - 1; break;            // only the last byte fixed
+        default: wildcard[i] = (rng() % 4) == 0; break;        // random
+        }
+    }
+    return wildcard;
+}
+
+void test_verify(std::mt19937 &rng)
+{
+    for (size_t size = 1; size <= 96; ++size)
+    {
+        for (uint32_t variant = 0; variant < 6; ++variant)
+        {
+            std::vector<uint8_t> source(size);
+            for (auto &b : source)
+                b = static_cast<uint8_t>(rng());
+            test_pattern p;
+            p.assign(source.data(), size, make_wildcards(size, variant, rng));
+
+            uint8_t *candidate = guarded_alloc(size);
+            memcpy(candidate, source.data(), size);
+            check(VerifyScalar(p.compiled, candidate), "VerifyScalar exact", size, variant, 0);
+            check(VerifySse2(p.compiled, candidate), "VerifySse2 exact", size, variant, 0);
+            if (s_avx2)
+                check(VerifyAvx2(p.compiled, candidate), "VerifyAvx2 exact", size, variant, 0);
+
+            for (size_t pos = 0; pos < size; ++pos)
+            {
+                candidate[pos] ^= static_cast<uint8_t>(1u << (rng() % 8));
+                const bool expected = p.compiled.mask[pos] == 0x00;
+                check(VerifyScalar(p.compiled, candidate) == expected, "VerifyScalar mismatch", size, variant, pos);
+                check(VerifySse2(p.compiled, candidate) == expected, "VerifySse2 mismatch", size, variant, pos);
+                if (s_avx2)
+                    check(VerifyAvx2(p.compiled, candidate) == expected, "VerifyAvx2 mismatch", size, variant, pos);
+                candidate[pos] = source[pos];
+            }
+        }
+    }
+}
+
+template <typename TScan>
+std::vector<uintptr_t> collect(TScan &&scan, const masked_pattern &pattern, uintptr_t begin, uintptr_t end, size_t stop_after)
+{
+    std::vector<uintptr_t> found;
+    scan(pattern, begin, end, [&](uintptr_t address) {
+        found.push_back(address);
+        return found.size() == stop_after;
+    });
+    return found;
+}
+
+void test_scan(std::mt19937 &rng)
+{
+    const size_t data_size = 256;
+    uint8_t *data = guarded_alloc(data_size);
+    // Two-symbol alphabet with sparse noise: long partial matches at most offsets.
+    for (size_t i = 0; i < data_size; ++i)
+        data[i] = (rng() % 16 == 0) ? static_cast<uint8_t>(rng()) : (rng() % 2 ? 0xAA : 0xBB);
+
+    const auto scalar = [](const masked_pattern &p, uintptr_t b, uintptr_t e, auto &&m) { ScanScalar(p, b, e, m); };
+    const auto sse2 = [](const masked_pattern &p, uintptr_t b, uintptr_t e, auto &&m) { ScanSse2(p, b, e, m); };
+    const auto avx2 = [](const masked_pattern &p, uintptr_t b, uintptr_t e, auto &&m) { ScanAvx2(p, b, e, m); };
+
+    for (size_t size = 1; size <= 72; ++size)
+    {
+        test_pattern p;
+        const size_t source = rng() % (data_size - size + 1);
+        p.assign(data + source, size, make_wildcards(size, size % 3 == 0 ? 4 : 0, rng));
+        if (p.all_wildcards())
+            continue;
+
+        // Natural anchors, then the last fixed byte (largest look-ahead) with the natural anchor and with itself.
+        size_t last_fixed = size - 1;
+        while (p.mask[last_fixed] == '?')
+            --last_fixed;
+        const size_t anchor_sets[][2] = {
+            { p.compiled.anchor0, p.compiled.anchor1 },
+            { last_fixed, p.compiled.anchor0 },
+            { last_fixed, last_fixed },
+        };
+
+        for (const auto &anchors : anchor_sets)
+        {
+            p.set_anchors(anchors[0], anchors[1]);
+            const uintptr_t base = reinterpret_cast<uintptr_t>(data);
+            const size_t last_start = data_size - size; // a pattern starting here ends at the guard page
+            for (size_t begin = 0; begin <= std::min<size_t>(33, last_start); ++begin)
+            {
+                for (size_t end = begin; end <= last_start; ++end)
+                {
+                    if (last_start - end > 70 && (end - begin) % 13 != 0)
+                        continue;
+                    for (const size_t stop_after : { size_t(1), size_t(SIZE_MAX) })
+                    {
+                        const auto expected = collect(scalar, p.compiled, base + begin, base + end, stop_after);
+                        check(collect(sse2, p.compiled, base + begin, base + end, stop_after) == expected, "ScanSse2", size, begin, end);
+                        if (s_avx2)
+                            check(collect(avx2, p.compiled, base + begin, base + end, stop_after) == expected, "ScanAvx2", size, begin, end);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template <typename TScan>
+double scan_throughput(TScan &&scan, const masked_pattern &pattern, uintptr_t begin, uintptr_t end, size_t &matches)
+{
+    double best = 0.0;
+    for (int r = 0; r < 3; ++r)
+    {
+        matches = 0;
+        const auto start = std::chrono::steady_clock::now();
+        scan(pattern, begin, end, [&](uintptr_t) {
+            ++matches;
+            return false;
+        });
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = (r == 0) ? seconds : std::min(best, seconds);
+    }
+    return best > 0.0 ? static_cast<double>(end - begin + 1) / best / (1024.0 * 1024.0 * 1024.0) : 0.0;
+}
+
+void bench(uint32_t mb, std::mt19937 &rng)
+{
+    pe_image image;
+    make_synthetic_pe_image(image, mb << 20, rng());
+    const uint8_t *code = image.base() + image.code_rva;
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(code);
+    const uintptr_t end = begin + image.code_size - 128;
+
+    const auto scalar = [](const masked_pattern &p, uintptr_t b, uintptr_t e, auto &&m) { ScanScalar(p, b, e, m); };
+    const auto sse2 = [](const masked_pattern &p, uintptr_t b, uintptr_t e, auto &&m) { ScanSse2(p, b, e, m); };
+    const auto avx2 = [](const masked_pattern &p, uintptr_t b, uintptr_t e, auto &&m) { ScanAvx2(p, b, e, m); };
+
+    printf("throughput on %u MB synthetic code (GB/s, best of 3, all matches collected)\n", mb);
+    printf("  %-6s %-8s %8s %8s %8s %8s\n", "length", "anchors", "scalar", "sse2", "avx2", "matches");
+    for (const size_t size : { size_t(8), size_t(16), size_t(32), size_t(64) })
+    {
+        test_pattern p;
+        p.assign(code + rng() % (image.code_size / 2), size, make_wildcards(size, 2, rng));
+        for (const bool common : { false, true })
+        {
+            // Common anchors (0x8B, 0x44 ...) turn most blocks into candidates; the rarest pair is the normal case.
+            if (common)
+            {
+                size_t a0 = std::string::npos, a1 = std::string::npos;
+                for (size_t i = 0; i < size; ++i)
+                {
+                    if (p.mask[i] == '?')
+                        continue;
+                    if (a0 == std::string::npos || ByteCommonness(p.bytes[i]) > ByteCommonness(p.bytes[a0]))
+                        a1 = a0, a0 = i;
+                    else if (a1 == std::string::npos || ByteCommonness(p.bytes[i]) > ByteCommonness(p.bytes[a1]))
+                        a1 = i;
+                }
+                p.set_anchors(a0, a1);
+            }
+            size_t matches_scalar = 0, matches_sse2 = 0, matches_avx2 = 0;
+            const double gbs_scalar = scan_throughput(scalar, p.compiled, begin, end, matches_scalar);
+            const double gbs_sse2 = scan_throughput(sse2, p.compiled, begin, end, matches_sse2);
+            const double gbs_avx2 = s_avx2 ? scan_throughput(avx2, p.compiled, begin, end, matches_avx2) : 0.0;
+            printf("  %-6zu %-8s %8.2f %8.2f %8.2f %8zu\n", size, common ? "common" : "rarest", gbs_scalar, gbs_sse2, gbs_avx2, matches_scalar);
+            check(matches_sse2 == matches_scalar && (!s_avx2 || matches_avx2 == matches_scalar), "bench match count", size, matches_scalar, matches_sse2);
+        }
+    }
+}
+}
+
+int main(int argc, char **argv)
+{
+    bool run_bench = false;
+    uint32_t mb = 64;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--bench")
+            run_bench = true;
+        else if (arg == "--mb" && i + 1 < argc)
+            mb = std::max(1u, static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10)));
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else
+        {
+            fprintf(stderr, "usage: %s [--bench] [--mb N] [--seed S]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    s_avx2 = __builtin_cpu_supports("avx2") && GetScanIsa() == scan_isa::avx2;
+    printf("scan isa: %s\n", s_avx2 ? "avx2" : "sse2 (AVX2 paths not tested on this CPU)");
+
+    std::mt19937 rng(seed);
+    const auto start = std::chrono::steady_clock::now();
+    test_verify(rng);
+    test_scan(rng);
+    printf("equivalence: %llu checks, %llu failures (%.1f s)\n", static_cast<unsigned long long>(s_checks),
+        static_cast<unsigned long long>(s_failures), std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+    if (run_bench)
+        bench(mb, rng);
+    return s_failures != 0 ? 1 : 0;
+}
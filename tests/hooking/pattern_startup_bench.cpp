@@ -0,0 +1,172 @@
+// Startup cost of pattern resolution with and without the persistent hint cache.
+// The PE image (a file or a synthetic PE32 image) stands in for the main executable. Three startups resolve the
+// same sampled patterns:
+//   - cold: no cache file, every pattern scans; the hints are then saved;
+//   - warm: load_hint_cache first, every pattern resolves from its hints without scanning;
+//   - stale: the image timestamp changed, so the cache is rejected and everything scans again.
+// Then malformed cache files (an entry count larger than the file, a truncated entry list) must be rejected without
+// allocating for the claimed count. Prints get_scan_stats() for each startup; exits non-zero when a startup
+// resolves different matches or a cache file is accepted or rejected wrongly.
+//
+//   pattern_startup_bench [--patterns N] [--seed S] [--synthetic-mb M] [--cache PATH] [image.exe]
+
+#include <windows.h>
+#include "../../includes/hooking/Hooking.Patterns.cpp"
+#include "pattern_samples.hpp"
+
+#include <chrono>
+#include <deque>
+
+namespace
+{
+uint32_t s_failures = 0;
+
+void expect(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        ++s_failures;
+        fprintf(stderr, "FAIL %s\n", what);
+    }
+}
+
+struct startup_result
+{
+    double milliseconds = 0.0;
+    bool cache_loaded = false;
+    hook::pattern::scan_stats stats = {};
+    std::vector<std::vector<uintptr_t>> matches;
+};
+
+// One process start: fresh hint table, optional cache load, then every pattern resolved as a hook installer would.
+startup_result run_startup(pe_image &image, const std::vector<pattern_text> &texts, const char *cache_path)
+{
+    hook::g_hints.clear();
+    hook::g_scanStats = {};
+    startup_result result;
+    std::deque<hook::module_pattern> patterns;
+    const auto start = std::chrono::steady_clock::now();
+    if (cache_path != nullptr)
+        result.cache_loaded = hook::pattern::load_hint_cache(cache_path);
+    for (const pattern_text &t : texts)
+        patterns.emplace_back(image.base(), t.text).size();
+    result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    result.stats = hook::pattern::get_scan_stats();
+    for (auto &p : patterns)
+        result.matches.push_back(match_addresses(p));
+    return result;
+}
+
+void print_startup(const char *label, const startup_result &r)
+{
+    printf("  %-5s %9.3f ms  cache=%-3s entries=%u hint_hits=%u hint_misses=%u scans=%u scan_ms=%.3f\n", label, r.milliseconds,
+        r.cache_loaded ? "yes" : "no", r.stats.cacheEntries, r.stats.hintHits, r.stats.hintMisses, r.stats.scans, r.stats.scanMilliseconds);
+}
+
+// Valid header for the current image followed by `entries` entries, claiming `count`.
+void write_cache(const char *path, uint32_t count, uint32_t entries)
+{
+    hook::executable_identity identity = {};
+    hook::GetExecutableIdentity(identity);
+    hook::hint_cache_header header = { hook::hintCacheMagic, hook::hintCacheVersion, identity.timestamp, identity.imageSize, identity.sectionHash, count, 0 };
+    FILE *file = fopen(path, "wb");
+    fwrite(&header, sizeof(header), 1, file);
+    for (uint32_t i = 0; i < entries; ++i)
+    {
+        const hook::hint_cache_entry entry = { i, 0x1000u + i };
+        fwrite(&entry, sizeof(entry), 1, file);
+    }
+    fclose(file);
+}
+
+void test_malformed_cache(const char *path)
+{
+    const auto try_load = [&](uint32_t count, uint32_t entries) {
+        hook::g_hints.clear();
+        try
+        {
+            write_cache(path, count, entries);
+            return hook::pattern::load_hint_cache(path);
+        }
+        catch (const std::bad_alloc &)
+        {
+            ++s_failures;
+            fprintf(stderr, "FAIL load_hint_cache allocated for count=%u\n", count);
+            return true;
+        }
+    };
+    expect(try_load(4, 4), "well-formed cache accepted");
+    expect(!try_load(0xFFFFFFFFu, 2), "entry count beyond the file rejected");
+    expect(!try_load(0x7FFFFFFFu, 0), "entry count with no entries rejected");
+    expect(!try_load(10, 3), "truncated entry list rejected");
+    expect(hook::g_hints.empty(), "rejected cache adds no hints");
+}
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t pattern_count = 200;
+    uint32_t seed = 1;
+    uint32_t synthetic_mb = 16;
+    std::string cache_path = "pattern_startup_bench.hints";
+    const char *file = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--patterns" && i + 1 < argc)
+            pattern_count = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--synthetic-mb" && i + 1 < argc)
+            synthetic_mb = std::max(1u, static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10)));
+        else if (arg == "--cache" && i + 1 < argc)
+            cache_path = argv[++i];
+        else if (arg.rfind("--", 0) != 0 && file == nullptr)
+            file = argv[i];
+        else
+        {
+            fprintf(stderr, "usage: %s [--patterns N] [--seed S] [--synthetic-mb M] [--cache PATH] [image.exe]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    pe_image image;
+    std::string error;
+    if (file == nullptr)
+        make_synthetic_pe_image(image, synthetic_mb << 20, seed);
+    else if (!load_pe_image(file, image, error))
+    {
+        fprintf(stderr, "%s: %s\n", file, error.c_str());
+        return 2;
+    }
+    g_host_main_module = image.module();
+    hook::pattern::set_scan_threads(1);
+
+    const std::vector<pattern_text> texts = sample_patterns(image, pattern_count, seed);
+    printf("%s: scan=%.2f MB patterns=%zu\n", image.name.c_str(), image.nt_headers()->OptionalHeader.SizeOfCode / (1024.0 * 1024.0), texts.size());
+
+    remove(cache_path.c_str());
+    const startup_result cold = run_startup(image, texts, cache_path.c_str());
+    const auto save_start = std::chrono::steady_clock::now();
+    expect(hook::pattern::save_hint_cache(cache_path.c_str()), "save_hint_cache");
+    const double save_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - save_start).count();
+    const startup_result warm = run_startup(image, texts, cache_path.c_str());
+    image.nt_headers()->FileHeader.TimeDateStamp ^= 1;
+    const startup_result stale = run_startup(image, texts, cache_path.c_str());
+    image.nt_headers()->FileHeader.TimeDateStamp ^= 1;
+
+    print_startup("cold", cold);
+    printf("  save  %9.3f ms\n", save_ms);
+    print_startup("warm", warm);
+    print_startup("stale", stale);
+    printf("  warm startup %.1fx faster than cold\n", warm.milliseconds > 0.0 ? cold.milliseconds / warm.milliseconds : 0.0);
+
+    expect(!cold.cache_loaded && cold.stats.scans > 0, "cold startup scans");
+    expect(warm.cache_loaded && warm.stats.scans == 0 && warm.stats.hintHits == texts.size(), "warm startup resolves from hints only");
+    expect(!stale.cache_loaded && stale.stats.scans == cold.stats.scans, "stale cache rejected");
+    expect(warm.matches == cold.matches && stale.matches == cold.matches, "same matches in every startup");
+
+    test_malformed_cache(cache_path.c_str());
+    remove(cache_path.c_str());
+    return s_failures != 0 ? 1 : 0;
+}
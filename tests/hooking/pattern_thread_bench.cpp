@@ -0,0 +1,126 @@
+// Thread scaling of the chunked pattern scan (EnsureMatches with set_scan_threads(1..N)).
+// Resolves the same sampled patterns at every thread count, once collecting all matches and once stopping at the
+// first (count(1)-style early exit across chunks), and checks that every thread count returns exactly the
+// single-threaded matches. Also checks that the default (no set_scan_threads call) stays on the calling thread.
+//
+//   pattern_thread_bench [--max-threads N] [--patterns P] [--seed S] [--synthetic-mb M] [--repeat R] [image.exe]
+
+#include <windows.h>
+#include "../../includes/hooking/Hooking.Patterns.cpp"
+#include "pattern_samples.hpp"
+
+#include <chrono>
+#include <deque>
+
+namespace
+{
+struct thread_run
+{
+    double milliseconds = 0.0;
+    std::vector<std::vector<uintptr_t>> matches;
+};
+
+// INT_MAX collects everything (size()); 1 stops at the first match in address order (count(1)).
+thread_run run(pe_image &image, const std::vector<pattern_text> &texts, int max_count)
+{
+    thread_run result;
+    std::deque<hook::module_pattern> patterns;
+    hook::g_hints.clear();
+    const auto start = std::chrono::steady_clock::now();
+    for (const pattern_text &t : texts)
+    {
+        hook::module_pattern &p = patterns.emplace_back(image.base(), t.text);
+        if (max_count == 1)
+            p.count(1);
+        else
+            p.size();
+    }
+    result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    for (auto &p : patterns)
+        result.matches.push_back(match_addresses(p));
+    return result;
+}
+}
+
+int main(int argc, char **argv)
+{
+    unsigned max_threads = std::max(1u, std::min(std::thread::hardware_concurrency(), 16u));
+    uint32_t pattern_count = 32;
+    uint32_t seed = 1;
+    uint32_t synthetic_mb = 32;
+    uint32_t repeat = 3;
+    const char *file = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        if (arg == "--max-threads" && i + 1 < argc)
+            max_threads = std::max(1u, static_cast<unsigned>(strtoul(argv[++i], nullptr, 10)));
+        else if (arg == "--patterns" && i + 1 < argc)
+            pattern_count = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--synthetic-mb" && i + 1 < argc)
+            synthetic_mb = std::max(1u, static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10)));
+        else if (arg == "--repeat" && i + 1 < argc)
+            repeat = std::max(1u, static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10)));
+        else if (arg.rfind("--", 0) != 0 && file == nullptr)
+            file = argv[i];
+        else
+        {
+            fprintf(stderr, "usage: %s [--max-threads N] [--patterns P] [--seed S] [--synthetic-mb M] [--repeat R] [image.exe]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    pe_image image;
+    std::string error;
+    if (file == nullptr)
+        make_synthetic_pe_image(image, synthetic_mb << 20, seed);
+    else if (!load_pe_image(file, image, error))
+    {
+        fprintf(stderr, "%s: %s\n", file, error.c_str());
+        return 2;
+    }
+
+    const std::vector<pattern_text> texts = sample_patterns(image, pattern_count, seed);
+    const uint32_t scan_bytes = image.nt_headers()->OptionalHeader.SizeOfCode;
+    printf("%s: scan=%.2f MB patterns=%zu hardware threads=%u\n", image.name.c_str(), scan_bytes / (1024.0 * 1024.0), texts.size(),
+        std::thread::hardware_concurrency());
+
+    uint32_t failures = 0;
+    if (hook::GetScanThreadCount(scan_bytes) != 1)
+    {
+        ++failures;
+        fprintf(stderr, "FAIL default scan is not single-threaded\n");
+    }
+
+    printf("  %-8s %12s %9s %12s %9s\n", "threads", "all (ms)", "speedup", "first (ms)", "speedup");
+    thread_run baseline_all, baseline_first;
+    for (unsigned threads = 1; threads <= max_threads; ++threads)
+    {
+        hook::pattern::set_scan_threads(threads);
+        thread_run best_all, best_first;
+        for (uint32_t r = 0; r < repeat; ++r)
+        {
+            thread_run all = run(image, texts, INT_MAX);
+            thread_run first = run(image, texts, 1);
+            if (r == 0 || all.milliseconds < best_all.milliseconds)
+                best_all = std::move(all);
+            if (r == 0 || first.milliseconds < best_first.milliseconds)
+                best_first = std::move(first);
+        }
+        if (threads == 1)
+        {
+            baseline_all = best_all;
+            baseline_first = best_first;
+        }
+        else if (best_all.matches != baseline_all.matches || best_first.matches != baseline_first.matches)
+        {
+            ++failures;
+            fprintf(stderr, "FAIL %u threads returned different matches\n", threads);
+        }
+        printf("  %-8u %12.2f %8.2fx %12.2f %8.2fx\n", threads, best_all.milliseconds, baseline_all.milliseconds / best_all.milliseconds,
+            best_first.milliseconds, baseline_first.milliseconds / best_first.milliseconds);
+    }
+    return failures != 0 ? 1 : 0;
+}
@@ -0,0 +1,3 @@
+#pragma once
+// Case-sensitive alias for headers that include <Windows.h>.
+#include "windows.h"
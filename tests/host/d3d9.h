@@ -0,0 +1,60 @@
+#pragma once
+// Declarations of the D3D9 interfaces the add-on calls (tests/ only). Nothing here is ever instantiated on Linux:
+// the synthetic streams push CPU depth, never surfaces.
+
+#include <windows.h>
+
+typedef enum _D3DFORMAT
+{
+    D3DFMT_UNKNOWN = 0,
+    D3DFMT_A8R8G8B8 = 21,
+    D3DFMT_D32 = 71,
+    D3DFMT_D15S1 = 73,
+    D3DFMT_D24S8 = 75,
+    D3DFMT_D24X8 = 77,
+    D3DFMT_D24X4S4 = 79,
+    D3DFMT_D16 = 80,
+    D3DFMT_D32F_LOCKABLE = 82,
+    D3DFMT_R32F = 114,
+} D3DFORMAT;
+
+typedef enum _D3DPOOL
+{
+    D3DPOOL_DEFAULT = 0,
+    D3DPOOL_SYSTEMMEM = 2,
+} D3DPOOL;
+
+#define D3DLOCK_READONLY 0x10ul
+
+typedef struct _D3DSURFACE_DESC
+{
+    D3DFORMAT Format;
+    UINT Width;
+    UINT Height;
+} D3DSURFACE_DESC;
+
+typedef struct _D3DLOCKED_RECT
+{
+    int Pitch;
+    void *pBits;
+} D3DLOCKED_RECT;
+
+struct IDirect3DDevice9;
+
+struct IDirect3DSurface9
+{
+    virtual ULONG AddRef() = 0;
+    virtual ULONG Release() = 0;
+    virtual HRESULT GetDevice(IDirect3DDevice9 **device) = 0;
+    virtual HRESULT GetDesc(D3DSURFACE_DESC *desc) = 0;
+    virtual HRESULT LockRect(D3DLOCKED_RECT *locked, const void *rect, DWORD flags) = 0;
+    virtual HRESULT UnlockRect() = 0;
+};
+
+struct IDirect3DDevice9
+{
+    virtual ULONG AddRef() = 0;
+    virtual ULONG Release() = 0;
+    virtual HRESULT CreateOffscreenPlainSurface(UINT width, UINT height, D3DFORMAT format, D3DPOOL pool, IDirect3DSurface9 **surface, HANDLE *shared) = 0;
+    virtual HRESULT GetRenderTargetData(IDirect3DSurface9 *render_target, IDirect3DSurface9 *dest) = 0;
+};
@@ -0,0 +1,15 @@
+#pragma once
+// ReShade's log interface as used by includes/reshade (the log itself lives in the ReShade tree, not here). Messages are dropped.
+
+namespace reshade::log
+{
+    enum class level
+    {
+        error = 1,
+        warning = 2,
+        info = 3,
+        debug = 4,
+    };
+
+    inline void message(level, const char *, ...) {}
+}
@@ -0,0 +1,3 @@
+#pragma once
+// ReShade add-ons exchange textures with the overlay as 64-bit resource view handles.
+#define ImTextureID ImU64
@@ -0,0 +1,277 @@
+#pragma once
+// PE images for the hooking tests, held in a heap buffer laid out the way the loader maps them: headers at the base,
+// each section at its RVA (no relocations, imports or protections). Either a real file from disk or a synthetic PE32
+// image whose code section is generated from common x86 instruction shapes.
+
+#include <windows.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+struct pe_image
+{
+    std::string name;
+    std::vector<uint8_t> memory; // SizeOfImage plus slack, so scans that read a pattern past the last candidate stay inside
+    uint32_t code_rva = 0;       // first executable section
+    uint32_t code_size = 0;
+    bool pe32 = false;
+
+    uint8_t *base() { return memory.data(); }
+    HMODULE module() { return reinterpret_cast<HMODULE>(memory.data()); }
+    IMAGE_NT_HEADERS *nt_headers() { return reinterpret_cast<IMAGE_NT_HEADERS *>(base() + reinterpret_cast<IMAGE_DOS_HEADER *>(base())->e_lfanew); }
+};
+
+static constexpr uint32_t k_pe_image_slack = 4096;
+
+inline bool load_pe_image(const char *path, pe_image &image, std::string &error)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        error = "cannot open";
+        return false;
+    }
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[65536];
+    for (size_t n; (n = fread(chunk, 1, sizeof(chunk), file)) != 0;)
+        bytes.insert(bytes.end(), chunk, chunk + n);
+    fclose(file);
+
+    const auto in_file = [&](size_t offset, size_t size) { return offset <= bytes.size() && size <= bytes.size() - offset; };
+    if (!in_file(0, sizeof(IMAGE_DOS_HEADER)) || reinterpret_cast<const IMAGE_DOS_HEADER *>(bytes.data())->e_magic != IMAGE_DOS_SIGNATURE)
+    {
+        error = "not an MZ file";
+        return false;
+    }
+    const size_t nt_offset = static_cast<size_t>(reinterpret_cast<const IMAGE_DOS_HEADER *>(bytes.data())->e_lfanew);
+    if (!in_file(nt_offset, offsetof(IMAGE_NT_HEADERS, OptionalHeader) + 64))
+    {
+        error = "truncated headers";
+        return false;
+    }
+    // The fields read here sit at the same offsets in PE32 and PE32+ optional headers.
+    const auto *nt = reinterpret_cast<const IMAGE_NT_HEADERS *>(bytes.data() + nt_offset);
+    const WORD magic = nt->OptionalHeader.Magic;
+    if (nt->Signature != IMAGE_NT_SIGNATURE || (magic != IMAGE_NT_OPTIONAL_HDR32_MAGIC && magic != IMAGE_NT_OPTIONAL_HDR64_MAGIC))
+    {
+        error = "not a PE image";
+        return false;
+    }
+    const size_t sections_offset = nt_offset + offsetof(IMAGE_NT_HEADERS, OptionalHeader) + nt->FileHeader.SizeOfOptionalHeader;
+    const uint32_t section_count = nt->FileHeader.NumberOfSections;
+    const uint32_t image_size = nt->OptionalHeader.SizeOfImage;
+    if (!in_file(sections_offset, section_count * sizeof(IMAGE_SECTION_HEADER)) || image_size == 0 || image_size > (1u << 30))
+    {
+        error = "bad section table or image size";
+        return false;
+    }
+
+    image.name = path;
+    image.pe32 = magic == IMAGE_NT_OPTIONAL_HDR32_MAGIC;
+    image.memory.assign(static_cast<size_t>(image_size) + k_pe_image_slack, 0);
+    memcpy(image.base(), bytes.data(), std::min<size_t>({ nt->OptionalHeader.SizeOfHeaders, bytes.size(), image_size }));
+    image.code_rva = image.code_size = 0;
+    const auto *sections = reinterpret_cast<const IMAGE_SECTION_HEADER *>(bytes.data() + sections_offset);
+    for (uint32_t i = 0; i < section_count; ++i)
+    {
+        const IMAGE_SECTION_HEADER &s = sections[i];
+        if (s.VirtualAddress >= image_size)
+            continue;
+        size_t size = std::min<size_t>(s.SizeOfRawData, image_size - s.VirtualAddress);
+        if (s.VirtualSize != 0)
+            size = std::min<size_t>(size, s.VirtualSize);
+        if (in_file(s.PointerToRawData, size))
+            memcpy(image.base() + s.VirtualAddress, bytes.data() + s.PointerToRawData, size);
+        if (image.code_size == 0 && (s.Characteristics & (IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE)) != 0)
+        {
+            image.code_rva = s.VirtualAddress;
+            image.code_size = static_cast<uint32_t>(std::min<size_t>(s.VirtualSize != 0 ? s.VirtualSize : s.SizeOfRawData, image_size - s.VirtualAddress));
+        }
+    }
+    if (image.code_size == 0)
+    {
+        error = "no code section";
+        return false;
+    }
+    return true;
+}
+
+// Appends one instruction drawn from a handful of shapes that dominate compiled x86 code (stack frame setup, mov
+// through ebp/esp, calls, short and near jumps, immediate compares, int3 padding).
+inline void append_synthetic_instruction(std::vector<uint8_t> &code, std::mt19937 &rng)
+{
+    const auto byte = [&]() { return static_cast<uint8_t>(rng()); };
+    const auto small = [&]() { return static_cast<uint8_t>((rng() % 32) * 4); };
+    const auto imm32 = [&](uint32_t value) {
+        for (int i = 0; i < 4; ++i)
+            code.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    };
+    switch (rng() % 16)
+    {
+    case 0: code.insert(code.end(), { 0x8B, 0x44, 0x24, small() }); break;          // mov eax, [esp+x]
+    case 1: code.insert(code.end(), { 0x8B, 0x45, small() }); break;                // mov eax, [ebp+x]
+    case 2: code.insert(code.end(), { 0x89, static_cast<uint8_t>(0x40 + rng() % 64), small() }); break;
+    case 3: code.push_back(0xE8); imm32(rng() % 0x200000 - 0x100000); break;        // call rel32
+    case 4: code.insert(code.end(), { 0x83, 0xC4, small() }); break;                // add esp, x
+    case 5: code.insert(code.end(), { 0x85, 0xC0, static_cast<uint8_t>(0x74 + rng() % 2), byte() }); break; // test eax, eax; jz/jnz
+    case 6: code.push_back(static_cast<uint8_t>(0x50 + rng() % 8)); break;          // push reg
+    case 7: code.push_back(static_cast<uint8_t>(0x58 + rng() % 8)); break;          // pop reg
+    case 8: code.insert(code.end(), { 0x0F, static_cast<uint8_t>(0x84 + rng() % 2) }); imm32(rng() % 0x1000); break;
+    case 9: code.insert(code.end(), { 0xC7, 0x45, small() }); imm32(rng() % 3 == 0 ? rng() : rng() % 256); break;
+    case 10: code.insert(code.end(), { 0xFF, 0x15 }); imm32(0x00890000 + (rng() % 0x1000) * 4); break; // call [iat]
+    case 11: code.insert(code.end(), { 0x8D, 0x4C, 0x24, small() }); break;         // lea ecx, [esp+x]
+    case 12: code.insert(code.end(), { 0x33, 0xC0 }); break;                        // xor eax, eax
+    case 13: code.insert(code.end(), { 0xD9, static_cast<uint8_t>(0x40 + rng() % 8), small() }); break; // fld
+    case 14: code.insert(code.end(), { 0xB8 }); imm32(rng()); break;                // mov eax, imm32
+    default:                                                                        // function end and alignment
+        code.push_back(0xC3);
+        while (code.size() % 16 != 0)
+            code.push_back(0xCC);
+        code.insert(code.end(), { 0x55, 0x8B, 0xEC });
+        break;
+    }
+}
+
+// PE32 image with a single .text section of `code_size` generated bytes.
+inline void make_synthetic_pe_image(pe_image &image, uint32_t code_size, uint32_t seed)
+{
+    const uint32_t code_rva = 0x1000;
+    const uint32_t code_span = (code_size + 0xFFF) & ~0xFFFu;
+    const uint32_t image_size = code_rva + code_span;
+
+    image.name = "synthetic";
+    image.pe32 = true;
+    image.code_rva = code_rva;
+    image.code_size = code_size;
+    image.memory.assign(static_cast<size_t>(image_size) + k_pe_image_slack, 0);
+
+    auto *dos = reinterpret_cast<IMAGE_DOS_HEADER *>(image.base());
+    dos->e_magic = IMAGE_DOS_SIGNATURE;
+    dos->e_lfanew = 0x80;
+    IMAGE_NT_HEADERS *nt = image.nt_headers();
+    nt->Signature = IMAGE_NT_SIGNATURE;
+    nt->FileHeader.Machine = IMAGE_FILE_MACHINE_I386;
+    nt->FileHeader.NumberOfSections = 1;
+    nt->FileHeader.TimeDateStamp = 0x40000000u + seed;
+    nt->FileHeader.SizeOfOptionalHeader = sizeof(IMAGE_OPTIONAL_HEADER32);
+    nt->OptionalHeader.Magic = IMAGE_NT_OPTIONAL_HDR32_MAGIC;
+    nt->OptionalHeader.SizeOfCode = code_size;
+    nt->OptionalHeader.BaseOfCode = code_rva;
+    nt->OptionalHeader.ImageBase = 0x00400000;
+    nt->OptionalHeader.SectionAlignment = 0x1000;
+    nt->OptionalHeader.FileAlignment = 0x200;
+    nt->OptionalHeader.SizeOfImage = image_size;
+    nt->OptionalHeader.SizeOfHeaders = 0x400;
+    nt->OptionalHeader.NumberOfRvaAndSizes = IMAGE_NUMBEROF_DIRECTORY_ENTRIES;
+    IMAGE_SECTION_HEADER *text = IMAGE_FIRST_SECTION(nt);
+    memcpy(text->Name, ".text", 5);
+    text->VirtualSize = code_size;
+    text->VirtualAddress = code_rva;
+    text->SizeOfRawData = code_span;
+    text->PointerToRawData = 0x400;
+    text->Characteristics = IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE | IMAGE_SCN_MEM_READ;
+
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> code;
+    code.reserve(static_cast<size_t>(code_size) + 64);
+    while (code.size() < code_size)
+        append_synthetic_instruction(code, rng);
+    memcpy(image.base() + code_rva, code.data(), code_size);
+}
+
+// PE32 image that exports `names` (sorted by the generator, as a linker would) from a small .text section, one
+// function every 16 bytes, plus an .edata section with the export directory. Export ordinals start at `ordinal_base`.
+inline void make_export_pe_image(pe_image &image, std::vector<std::string> names, uint32_t timestamp, uint32_t ordinal_base = 1)
+{
+    std::sort(names.begin(), names.end());
+    const uint32_t count = static_cast<uint32_t>(names.size());
+    const auto align = [](uint32_t value) { return (value + 0xFFFu) & ~0xFFFu; };
+
+    const uint32_t code_rva = 0x1000;
+    const uint32_t code_size = std::max(0x1000u, count * 16);
+    const uint32_t edata_rva = code_rva + align(code_size);
+    const uint32_t functions_rva = edata_rva + sizeof(IMAGE_EXPORT_DIRECTORY);
+    const uint32_t names_rva = functions_rva + count * 4;
+    const uint32_t ordinals_rva = names_rva + count * 4;
+    const uint32_t strings_rva = ordinals_rva + count * 2;
+    uint32_t strings_size = sizeof("synthetic.dll");
+    for (const std::string &name : names)
+        strings_size += static_cast<uint32_t>(name.size()) + 1;
+    const uint32_t edata_size = strings_rva + strings_size - edata_rva;
+    const uint32_t image_size = edata_rva + align(edata_size);
+
+    image.name = "synthetic exports";
+    image.pe32 = true;
+    image.code_rva = code_rva;
+    image.code_size = code_size;
+    image.memory.assign(static_cast<size_t>(image_size) + k_pe_image_slack, 0);
+
+    auto *dos = reinterpret_cast<IMAGE_DOS_HEADER *>(image.base());
+    dos->e_magic = IMAGE_DOS_SIGNATURE;
+    dos->e_lfanew = 0x80;
+    IMAGE_NT_HEADERS *nt = image.nt_headers();
+    nt->Signature = IMAGE_NT_SIGNATURE;
+    nt->FileHeader.Machine = IMAGE_FILE_MACHINE_I386;
+    nt->FileHeader.NumberOfSections = 2;
+    nt->FileHeader.TimeDateStamp = timestamp;
+    nt->FileHeader.SizeOfOptionalHeader = sizeof(IMAGE_OPTIONAL_HEADER32);
+    nt->OptionalHeader.Magic = IMAGE_NT_OPTIONAL_HDR32_MAGIC;
+    nt->OptionalHeader.SizeOfCode = code_size;
+    nt->OptionalHeader.BaseOfCode = code_rva;
+    nt->OptionalHeader.ImageBase = 0x10000000;
+    nt->OptionalHeader.SectionAlignment = 0x1000;
+    nt->OptionalHeader.FileAlignment = 0x200;
+    nt->OptionalHeader.SizeOfImage = image_size;
+    nt->OptionalHeader.SizeOfHeaders = 0x400;
+    nt->OptionalHeader.NumberOfRvaAndSizes = IMAGE_NUMBEROF_DIRECTORY_ENTRIES;
+    nt->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_EXPORT] = { edata_rva, edata_size };
+    IMAGE_SECTION_HEADER *sections = IMAGE_FIRST_SECTION(nt);
+    memcpy(sections[0].Name, ".text", 5);
+    sections[0].VirtualSize = code_size;
+    sections[0].VirtualAddress = code_rva;
+    sections[0].Characteristics = IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE | IMAGE_SCN_MEM_READ;
+    memcpy(sections[1].Name, ".edata", 6);
+    sections[1].VirtualSize = edata_size;
+    sections[1].VirtualAddress = edata_rva;
+    sections[1].Characteristics = IMAGE_SCN_MEM_READ;
+
+    uint8_t *const base = image.base();
+    for (uint32_t i = 0; i < code_size; i += 16)
+        base[code_rva + i] = 0xC3;
+
+    auto *dir = reinterpret_cast<IMAGE_EXPORT_DIRECTORY *>(base + edata_rva);
+    dir->TimeDateStamp = timestamp;
+    dir->Base = ordinal_base;
+    dir->NumberOfFunctions = count;
+    dir->NumberOfNames = count;
+    dir->AddressOfFunctions = functions_rva;
+    dir->AddressOfNames = names_rva;
+    dir->AddressOfNameOrdinals = ordinals_rva;
+
+    // Function i lives at code_rva + 16 * i; the name table is sorted, the function table is in a shuffled order so
+    // that name ordinals are not simply the name index.
+    std::vector<uint32_t> slot(count);
+    for (uint32_t i = 0; i < count; ++i)
+        slot[i] = i;
+    std::shuffle(slot.begin(), slot.end(), std::mt19937(timestamp));
+    uint32_t string_rva = strings_rva;
+    memcpy(base + string_rva, "synthetic.dll", sizeof("synthetic.dll"));
+    dir->Name = string_rva;
+    string_rva += sizeof("synthetic.dll");
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint32_t function_rva = code_rva + 16 * slot[i];
+        const uint16_t ordinal = static_cast<uint16_t>(slot[i]);
+        memcpy(base + functions_rva + 4 * slot[i], &function_rva, 4);
+        memcpy(base + names_rva + 4 * i, &string_rva, 4);
+        memcpy(base + ordinals_rva + 2 * i, &ordinal, 2);
+        memcpy(base + string_rva, names[i].c_str(), names[i].size() + 1);
+        string_rva += static_cast<uint32_t>(names[i].size()) + 1;
+    }
+}
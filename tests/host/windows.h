@@ -0,0 +1,313 @@
+#pragma once
+// Minimal Win32 surface for building the add-on and the hooking helpers on Linux (tests/ only).
+// Timing and thread ids are real; file mapping, threads and events report failure, which exercises the same
+// fallbacks the add-on takes when those calls fail on Windows (in-memory trace store, synchronous logging).
+
+#include <cstdarg>
+#include <cstddef>
+#include <exception>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+typedef int BOOL;
+typedef uint32_t DWORD; // 32-bit as on Windows, so PE structures keep their layout
+typedef unsigned short WORD;
+typedef unsigned char BYTE;
+typedef short SHORT;
+typedef unsigned short USHORT;
+typedef int32_t LONG;
+typedef uint32_t ULONG;
+typedef long long LONGLONG;
+typedef unsigned int UINT;
+typedef long HRESULT;
+typedef void VOID;
+typedef void *HANDLE;
+typedef void *LPVOID;
+typedef void *PVOID;
+typedef const void *LPCVOID;
+typedef DWORD *LPDWORD;
+typedef char CHAR;
+typedef const char *LPCSTR;
+typedef wchar_t WCHAR;
+typedef wchar_t *PWSTR;
+typedef const wchar_t *LPCWSTR;
+typedef uintptr_t ULONG_PTR;
+typedef uintptr_t SIZE_T;
+typedef struct HINSTANCE__ *HMODULE;
+typedef HMODULE HINSTANCE;
+typedef intptr_t (*FARPROC)();
+typedef union _LARGE_INTEGER
+{
+    struct
+    {
+        DWORD LowPart;
+        LONG HighPart;
+    };
+    LONGLONG QuadPart;
+} LARGE_INTEGER;
+
+#define TRUE 1
+#define FALSE 0
+#define WINAPI
+#define APIENTRY
+#define CALLBACK
+#define NTAPI
+#define STDMETHODCALLTYPE
+#define __stdcall
+#define __cdecl
+#define __thiscall
+#define __fastcall
+#define __declspec(x)
+#define _Printf_format_string_
+#define MAX_PATH 260
+#define INFINITE 0xFFFFFFFFul
+#define WAIT_OBJECT_0 0ul
+#define WAIT_TIMEOUT 258ul
+#define S_OK ((HRESULT)0)
+#define E_FAIL ((HRESULT)0x80004005L)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+#define INVALID_HANDLE_VALUE ((HANDLE)(intptr_t)-1)
+#define _TRUNCATE ((size_t)-1)
+
+#define DLL_PROCESS_DETACH 0
+#define DLL_PROCESS_ATTACH 1
+#define DLL_THREAD_ATTACH 2
+#define DLL_THREAD_DETACH 3
+
+#define VK_SHIFT 0x10
+#define VK_F9 0x78
+#define VK_F10 0x79
+#define VK_F11 0x7A
+#define VK_LCONTROL 0xA2
+#define VK_RCONTROL 0xA3
+
+#define GENERIC_READ 0x80000000ul
+#define GENERIC_WRITE 0x40000000ul
+#define FILE_SHARE_READ 0x1
+#define FILE_SHARE_WRITE 0x2
+#define CREATE_ALWAYS 2
+#define OPEN_EXISTING 3
+#define OPEN_ALWAYS 4
+#define FILE_ATTRIBUTE_NORMAL 0x80
+#define MOVEFILE_REPLACE_EXISTING 0x1
+#define MOVEFILE_WRITE_THROUGH 0x8
+#define PAGE_READWRITE 0x04
+#define PAGE_EXECUTE_READWRITE 0x40
+#define FILE_MAP_WRITE 0x2
+#define FILE_MAP_ALL_ACCESS 0xF001F
+#define THREAD_PRIORITY_BELOW_NORMAL (-1)
+
+// Structured exception handling has no g++ equivalent: libstdc++ already maps __try to try, the handler becomes a catch.
+#ifndef __try
+#define __try try
+#endif
+#define __except(filter) catch (...)
+#define EXCEPTION_EXECUTE_HANDLER 1
+
+// COM interface ids only appear in ReShade's private-data helpers, which nothing here instantiates.
+inline const unsigned char k_host_null_uuid[16] = {};
+#define __uuidof(x) k_host_null_uuid
+
+inline BOOL QueryPerformanceFrequency(LARGE_INTEGER *freq)
+{
+    freq->QuadPart = 1000000000ll;
+    return TRUE;
+}
+
+inline BOOL QueryPerformanceCounter(LARGE_INTEGER *now)
+{
+    timespec ts = {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    now->QuadPart = static_cast<LONGLONG>(ts.tv_sec) * 1000000000ll + ts.tv_nsec;
+    return TRUE;
+}
+
+inline DWORD GetCurrentThreadId() { return static_cast<DWORD>(syscall(SYS_gettid)); }
+inline DWORD GetCurrentProcessId() { return static_cast<DWORD>(getpid()); }
+inline HANDLE GetCurrentProcess() { return reinterpret_cast<HANDLE>(static_cast<intptr_t>(-1)); }
+inline HANDLE GetCurrentThread() { return reinterpret_cast<HANDLE>(static_cast<intptr_t>(-2)); }
+inline DWORD GetLastError() { return 0; }
+inline void Sleep(DWORD ms) { usleep(static_cast<useconds_t>(ms) * 1000u); }
+inline void OutputDebugStringA(const char *) {}
+inline SHORT GetAsyncKeyState(int) { return 0; }
+inline DWORD GetModuleFileNameA(HMODULE, char *, DWORD) { return 0; }
+
+// Header-only ReShade resolves its exports through these; each test host defines them.
+FARPROC GetProcAddress(HMODULE module, LPCSTR name);
+
+// Hosts that need a main executable (hint cache identity) point this at an image buffer.
+inline HMODULE g_host_main_module = nullptr;
+inline HMODULE GetModuleHandleA(LPCSTR name) { return name == nullptr ? g_host_main_module : nullptr; }
+#define GetModuleHandle GetModuleHandleA
+
+// ReShade's hook manager (RESHADE_TEST_APPLICATION build). Paths are std::filesystem::path, whose c_str() is char on
+// Linux, hence the character-type templates. Virtual function tables in the tests are plain writable arrays.
+#define GET_MODULE_HANDLE_EX_FLAG_PIN 0x1
+inline BOOL VirtualProtect(LPVOID, SIZE_T, DWORD protection, DWORD *old_protection)
+{
+    *old_protection = protection;
+    return TRUE;
+}
+template <typename C>
+inline BOOL GetModuleHandleExW(DWORD, const C *, HMODULE *module)
+{
+    *module = nullptr;
+    return FALSE;
+}
+template <typename C>
+inline HMODULE LoadLibraryW(const C *) { return nullptr; }
+inline BOOL FreeLibrary(HMODULE) { return TRUE; }
+inline int _wcsicmp(const char *a, const char *b) { return strcasecmp(a, b); }
+
+// MSVC <intrin.h> CPU identification, used by the hooking scanner's ISA dispatch.
+inline void __cpuidex(int info[4], int leaf, int subleaf)
+{
+    __asm__ __volatile__("cpuid" : "=a"(info[0]), "=b"(info[1]), "=c"(info[2]), "=d"(info[3]) : "a"(leaf), "c"(subleaf));
+}
+inline void __cpuid(int info[4], int leaf) { __cpuidex(info, leaf, 0); }
+
+typedef DWORD(WINAPI *LPTHREAD_START_ROUTINE)(LPVOID);
+inline HANDLE CreateThread(void *, SIZE_T, LPTHREAD_START_ROUTINE, LPVOID, DWORD, DWORD *) { return nullptr; }
+inline BOOL SetThreadPriority(HANDLE, int) { return TRUE; }
+inline HANDLE CreateEventA(void *, BOOL, BOOL, const char *) { return nullptr; }
+inline BOOL SetEvent(HANDLE) { return FALSE; }
+inline DWORD WaitForSingleObject(HANDLE, DWORD) { return WAIT_OBJECT_0; }
+inline BOOL CloseHandle(HANDLE) { return TRUE; }
+
+inline HANDLE CreateFileA(const char *, DWORD, DWORD, void *, DWORD, DWORD, HANDLE) { return INVALID_HANDLE_VALUE; }
+inline HANDLE CreateFileMappingA(HANDLE, void *, DWORD, DWORD, DWORD, const char *) { return nullptr; }
+inline void *MapViewOfFile(HANDLE, DWORD, DWORD, DWORD, SIZE_T) { return nullptr; }
+inline BOOL UnmapViewOfFile(LPCVOID) { return TRUE; }
+inline BOOL FlushViewOfFile(LPCVOID, SIZE_T) { return TRUE; }
+inline BOOL MoveFileExA(const char *, const char *, DWORD) { return FALSE; }
+
+// PE32 image layout (the game and the hooking code are 32-bit, so IMAGE_NT_HEADERS is the 32-bit variant).
+#define IMAGE_DOS_SIGNATURE 0x5A4D
+#define IMAGE_NT_SIGNATURE 0x00004550
+#define IMAGE_NT_OPTIONAL_HDR32_MAGIC 0x10B
+#define IMAGE_NT_OPTIONAL_HDR64_MAGIC 0x20B
+#define IMAGE_FILE_MACHINE_I386 0x014C
+#define IMAGE_NUMBEROF_DIRECTORY_ENTRIES 16
+#define IMAGE_DIRECTORY_ENTRY_EXPORT 0
+#define IMAGE_SIZEOF_SHORT_NAME 8
+#define IMAGE_SCN_CNT_CODE 0x00000020
+#define IMAGE_SCN_MEM_EXECUTE 0x20000000
+#define IMAGE_SCN_MEM_READ 0x40000000
+
+typedef struct _IMAGE_DOS_HEADER
+{
+    WORD e_magic, e_cblp, e_cp, e_crlc, e_cparhdr, e_minalloc, e_maxalloc, e_ss, e_sp, e_csum, e_ip, e_cs, e_lfarlc, e_ovno;
+    WORD e_res[4];
+    WORD e_oemid, e_oeminfo;
+    WORD e_res2[10];
+    LONG e_lfanew;
+} IMAGE_DOS_HEADER, *PIMAGE_DOS_HEADER;
+
+typedef struct _IMAGE_FILE_HEADER
+{
+    WORD Machine;
+    WORD NumberOfSections;
+    DWORD TimeDateStamp;
+    DWORD PointerToSymbolTable;
+    DWORD NumberOfSymbols;
+    WORD SizeOfOptionalHeader;
+    WORD Characteristics;
+} IMAGE_FILE_HEADER, *PIMAGE_FILE_HEADER;
+
+typedef struct _IMAGE_DATA_DIRECTORY
+{
+    DWORD VirtualAddress;
+    DWORD Size;
+} IMAGE_DATA_DIRECTORY, *PIMAGE_DATA_DIRECTORY;
+
+typedef struct _IMAGE_OPTIONAL_HEADER32
+{
+    WORD Magic;
+    BYTE MajorLinkerVersion, MinorLinkerVersion;
+    DWORD SizeOfCode, SizeOfInitializedData, SizeOfUninitializedData, AddressOfEntryPoint, BaseOfCode, BaseOfData, ImageBase;
+    DWORD SectionAlignment, FileAlignment;
+    WORD MajorOperatingSystemVersion, MinorOperatingSystemVersion, MajorImageVersion, MinorImageVersion, MajorSubsystemVersion, MinorSubsystemVersion;
+    DWORD Win32VersionValue, SizeOfImage, SizeOfHeaders, CheckSum;
+    WORD Subsystem, DllCharacteristics;
+    DWORD SizeOfStackReserve, SizeOfStackCommit, SizeOfHeapReserve, SizeOfHeapCommit, LoaderFlags, NumberOfRvaAndSizes;
+    IMAGE_DATA_DIRECTORY DataDirectory[IMAGE_NUMBEROF_DIRECTORY_ENTRIES];
+} IMAGE_OPTIONAL_HEADER32, IMAGE_OPTIONAL_HEADER, *PIMAGE_OPTIONAL_HEADER;
+
+typedef struct _IMAGE_NT_HEADERS
+{
+    DWORD Signature;
+    IMAGE_FILE_HEADER FileHeader;
+    IMAGE_OPTIONAL_HEADER32 OptionalHeader;
+} IMAGE_NT_HEADERS32, IMAGE_NT_HEADERS, *PIMAGE_NT_HEADERS;
+
+typedef struct _IMAGE_SECTION_HEADER
+{
+    BYTE Name[IMAGE_SIZEOF_SHORT_NAME];
+    DWORD VirtualSize;
+    DWORD VirtualAddress;
+    DWORD SizeOfRawData;
+    DWORD PointerToRawData;
+    DWORD PointerToRelocations;
+    DWORD PointerToLinenumbers;
+    WORD NumberOfRelocations;
+    WORD NumberOfLinenumbers;
+    DWORD Characteristics;
+} IMAGE_SECTION_HEADER, *PIMAGE_SECTION_HEADER;
+
+typedef struct _IMAGE_EXPORT_DIRECTORY
+{
+    DWORD Characteristics;
+    DWORD TimeDateStamp;
+    WORD MajorVersion, MinorVersion;
+    DWORD Name;
+    DWORD Base;
+    DWORD NumberOfFunctions;
+    DWORD NumberOfNames;
+    DWORD AddressOfFunctions;
+    DWORD AddressOfNames;
+    DWORD AddressOfNameOrdinals;
+} IMAGE_EXPORT_DIRECTORY, *PIMAGE_EXPORT_DIRECTORY;
+
+static_assert(sizeof(IMAGE_DOS_HEADER) == 64 && sizeof(IMAGE_NT_HEADERS32) == 248 && sizeof(IMAGE_SECTION_HEADER) == 40, "PE layout");
+
+#define IMAGE_FIRST_SECTION(nt) \
+    ((PIMAGE_SECTION_HEADER)((ULONG_PTR)(nt) + offsetof(IMAGE_NT_HEADERS, OptionalHeader) + ((const IMAGE_NT_HEADERS *)(nt))->FileHeader.SizeOfOptionalHeader))
+
+template <size_t N>
+inline int sprintf_s(char (&buffer)[N], const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const int n = vsnprintf(buffer, N, format, args);
+    va_end(args);
+    return n;
+}
+
+inline int sprintf_s(char *buffer, size_t size, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const int n = vsnprintf(buffer, size, format, args);
+    va_end(args);
+    return n;
+}
+
+inline int vsnprintf_s(char *buffer, size_t size, size_t, const char *format, va_list args)
+{
+    return vsnprintf(buffer, size, format, args);
+}
+
+inline int strncpy_s(char *dest, size_t size, const char *src, size_t)
+{
+    if (size == 0)
+        return 0;
+    strncpy(dest, src, size - 1);
+    dest[size - 1] = '\0';
+    return 0;
+}
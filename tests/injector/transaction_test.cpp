@@ -0,0 +1,208 @@
+// injector::basic_transaction against a fake memory backend: a byte buffer split into pages, with every unprotect,
+// protect and flush call recorded and unprotect failures injectable per page. Checks that a commit touches each page
+// once (one unprotect and one protect restoring the old protection per page, one flush over the patched range), that
+// rollback restores the original bytes, and that a failed unprotect leaves memory and protections untouched.
+//
+//   transaction_test
+
+#include "injector/transaction.hpp"
+
+#include <cstdio>
+#include <map>
+#include <set>
+
+namespace
+{
+uint32_t s_failures = 0;
+
+void expect(bool ok, const char *what)
+{
+    if (!ok)
+    {
+        ++s_failures;
+        fprintf(stderr, "FAIL %s\n", what);
+    }
+}
+
+constexpr uint32_t k_protect_code = 0x20;   // PAGE_EXECUTE_READ
+constexpr uint32_t k_protect_rwx = 0x40;    // PAGE_EXECUTE_READWRITE
+
+struct fake_backend
+{
+    static constexpr uintptr_t base = 0x400000;
+    static constexpr size_t page = 0x1000;
+
+    explicit fake_backend(size_t pages) : memory(pages * page)
+    {
+        for (size_t i = 0; i < memory.size(); ++i)
+            memory[i] = static_cast<uint8_t>(i * 7 + 3);
+        for (size_t i = 0; i < pages; ++i)
+            protection[base + i * page] = k_protect_code;
+    }
+
+    size_t page_size() { return page; }
+
+    bool unprotect(uintptr_t at, size_t size, uint32_t &out_oldprotect)
+    {
+        expect(size == page && protection.count(at) != 0, "unprotect of one whole page");
+        if (failing_pages.count(at) != 0)
+            return false;
+        ++unprotects[at];
+        out_oldprotect = protection[at];
+        protection[at] = k_protect_rwx;
+        return true;
+    }
+
+    bool protect(uintptr_t at, size_t size, uint32_t value)
+    {
+        expect(size == page && protection.count(at) != 0, "protect of one whole page");
+        ++protects[at];
+        protection[at] = value;
+        return true;
+    }
+
+    void read(uintptr_t addr, void *out, size_t size)
+    {
+        check_access(addr, size, false);
+        memcpy(out, &memory[addr - base], size);
+    }
+
+    void write(uintptr_t addr, const void *in, size_t size)
+    {
+        check_access(addr, size, true);
+        memcpy(&memory[addr - base], in, size);
+    }
+
+    void flush(uintptr_t addr, size_t size)
+    {
+        flushes.push_back({ addr, size });
+    }
+
+    // Writes must only ever hit pages that are currently unprotected
+    void check_access(uintptr_t addr, size_t size, bool writing)
+    {
+        expect(addr >= base && addr + size <= base + memory.size(), "access inside the fake image");
+        if (writing)
+            for (uintptr_t p = addr & ~(page - 1); p < addr + size; p += page)
+                expect(protection[p] == k_protect_rwx, "write to an unprotected page");
+    }
+
+    void reset_counters()
+    {
+        unprotects.clear();
+        protects.clear();
+        flushes.clear();
+    }
+
+    std::vector<uint8_t> memory;
+    std::map<uintptr_t, uint32_t> protection;
+    std::map<uintptr_t, uint32_t> unprotects, protects;
+    std::vector<std::pair<uintptr_t, size_t>> flushes;
+    std::set<uintptr_t> failing_pages;
+};
+
+using test_transaction = injector::basic_transaction<fake_backend>;
+constexpr uintptr_t base = fake_backend::base;
+constexpr size_t page = fake_backend::page;
+
+// One unprotect and one protect for each of @pages and nothing else; every page back at its original protection
+void expect_each_page_once(const fake_backend &mem, const std::set<uintptr_t> &pages, const char *what)
+{
+    bool ok = mem.unprotects.size() == pages.size() && mem.protects.size() == pages.size();
+    for (uintptr_t p : pages)
+        ok = ok && mem.unprotects.count(p) != 0 && mem.unprotects.at(p) == 1 && mem.protects.count(p) != 0 && mem.protects.at(p) == 1;
+    for (const auto &[p, value] : mem.protection)
+        ok = ok && value == k_protect_code;
+    expect(ok, what);
+}
+
+// Writes spread over three of four pages: two on the first page, one straddling pages 2 and 3, one jump on page 3
+void queue_patches(test_transaction &t)
+{
+    t.write<uint32_t>(base + 0x10, 0xDEADBEEF);
+    t.make_nop(base + 0x20, 6);
+    t.fill(base + 2 * page - 3, 0xCC, 8);
+    t.make_jmp(base + 2 * page + 0x40, base + 0x100);
+}
+
+void test_commit_and_rollback()
+{
+    fake_backend mem(4);
+    const std::vector<uint8_t> original = mem.memory;
+    test_transaction t(mem);
+    queue_patches(t);
+    // Overlaps the first write; rollback has to undo it before the first one to get the original bytes back
+    t.write<uint16_t>(base + 0x12, 0x1234);
+
+    expect(mem.unprotects.empty() && mem.memory == original, "nothing happens before commit");
+    expect(t.commit(), "commit succeeds");
+    expect(t.status() == test_transaction::state::committed, "state committed");
+    expect(t.page_count() == 3, "three pages touched");
+    expect_each_page_once(mem, { base, base + page, base + 2 * page }, "commit unprotects and protects each page once");
+    expect(mem.flushes.size() == 1, "commit flushes once");
+    expect(!mem.flushes.empty() && mem.flushes[0].first == base + 0x10 && mem.flushes[0].second == 2 * page + 0x45 - 0x10,
+        "flush covers the patched range");
+
+    uint32_t value = 0;
+    memcpy(&value, &mem.memory[0x10], sizeof(value));
+    expect(value == 0x1234BEEF, "overlapping writes applied in order");
+    expect(mem.memory[0x20] == 0x90 && mem.memory[0x25] == 0x90 && mem.memory[0x26] == original[0x26], "nops written");
+    expect(mem.memory[2 * page - 3] == 0xCC && mem.memory[2 * page + 4] == 0xCC && mem.memory[2 * page + 5] == original[2 * page + 5],
+        "fill across a page boundary");
+    int32_t rel = 0;
+    memcpy(&rel, &mem.memory[2 * page + 0x41], sizeof(rel));
+    expect(mem.memory[2 * page + 0x40] == 0xE9 && rel == static_cast<int32_t>(0x100 - (2 * page + 0x45)), "jmp rel32 encoded");
+    expect(memcmp(&mem.memory[3 * page], &original[3 * page], page) == 0, "untouched page unchanged");
+    expect(!t.commit(), "second commit refused");
+
+    mem.reset_counters();
+    expect(t.rollback(), "rollback succeeds");
+    expect(t.status() == test_transaction::state::rolled_back, "state rolled back");
+    expect(mem.memory == original, "rollback restores every original byte");
+    expect_each_page_once(mem, { base, base + page, base + 2 * page }, "rollback unprotects and protects each page once");
+    expect(mem.flushes.size() == 1, "rollback flushes once");
+    expect(!t.rollback(), "second rollback refused");
+}
+
+void test_unprotect_failure()
+{
+    fake_backend mem(4);
+    const std::vector<uint8_t> original = mem.memory;
+    mem.failing_pages.insert(base + 2 * page);
+    test_transaction t(mem);
+    queue_patches(t);
+
+    expect(!t.commit(), "commit fails when a page cannot be unprotected");
+    expect(t.status() == test_transaction::state::pending, "state stays pending");
+    expect(t.page_count() == 0, "no pages reported");
+    expect(mem.memory == original, "memory untouched after a failed unprotect");
+    expect_each_page_once(mem, { base, base + page }, "already unprotected pages protected again, once");
+    expect(mem.flushes.empty(), "nothing flushed");
+    expect(!t.rollback(), "nothing to roll back");
+
+    // Once the page can be unprotected the same transaction commits
+    mem.failing_pages.clear();
+    mem.reset_counters();
+    expect(t.commit() && t.page_count() == 3 && mem.memory != original, "commit succeeds on retry");
+}
+
+void test_empty()
+{
+    fake_backend mem(1);
+    test_transaction t(mem);
+    t.write_raw(base, nullptr, 0);
+    expect(t.commit() && t.queued().empty(), "empty transaction commits");
+    expect(mem.unprotects.empty() && mem.flushes.empty(), "empty transaction touches nothing");
+    t.make_nop(base, 4);
+    expect(t.queued().empty(), "writes after commit are ignored");
+}
+}
+
+int main()
+{
+    test_commit_and_rollback();
+    test_unprotect_failure();
+    test_empty();
+    printf("transaction_test: %u failure(s)\n", s_failures);
+    return s_failures != 0 ? 1 : 0;
+}
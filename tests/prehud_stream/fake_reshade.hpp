@@ -0,0 +1,375 @@
+#pragma once
+// In-memory ReShade device, command list, queue and effect runtime for driving the add-on's callbacks on Linux.
+// Resources and views are plain handles with descriptors; nothing is rendered. The runtime reports render_effects
+// calls through `on_render_effects`, which is where the stream generator checks its invariants. Command lists count
+// copies, resolves and barriers recorded between begin_render_pass and end_render_pass, which Vulkan does not allow.
+// Every technique and texture variable the add-on looks up exists, so its FX products run against the fake too.
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fake_reshade
+{
+using namespace reshade::api;
+
+#define FAKE_RESHADE_API_OBJECT_STUBS \
+    uint64_t get_native() const override { return 0; } \
+    void get_private_data(const uint8_t[16], uint64_t *) const override {} \
+    void set_private_data(const uint8_t[16], const uint64_t) override {}
+
+class command_list_impl final : public command_list
+{
+public:
+    explicit command_list_impl(device *owner) : owner(owner) {}
+
+    device *get_device() override { return owner; }
+    void barrier(uint32_t count, const resource *, const resource_usage *, const resource_usage *) override
+    {
+        barriers += count;
+        if (in_render_pass)
+            barriers_in_pass += count;
+    }
+    void copy_texture_region(resource, uint32_t, const subresource_box *, resource, uint32_t, const subresource_box *, filter_mode) override
+    {
+        ++copies;
+        if (in_render_pass)
+            ++copies_in_pass;
+    }
+    void resolve_texture_region(resource, uint32_t, const subresource_box *, resource, uint32_t, uint32_t, uint32_t, uint32_t, format) override
+    {
+        ++resolves;
+        if (in_render_pass)
+            ++resolves_in_pass;
+    }
+    void begin_render_pass(uint32_t, const render_pass_render_target_desc *, const render_pass_depth_stencil_desc *) override { in_render_pass = true; }
+    void end_render_pass() override { in_render_pass = false; }
+
+    bool in_render_pass = false;
+    uint64_t barriers = 0;
+    uint64_t copies = 0;
+    uint64_t resolves = 0;
+    uint64_t barriers_in_pass = 0;
+    uint64_t copies_in_pass = 0;
+    uint64_t resolves_in_pass = 0;
+
+    FAKE_RESHADE_API_OBJECT_STUBS
+    void bind_render_targets_and_depth_stencil(uint32_t, const resource_view *, resource_view) override {}
+    void bind_pipeline(pipeline_stage, pipeline) override {}
+    void bind_pipeline_states(uint32_t, const dynamic_state *, const uint32_t *) override {}
+    void bind_viewports(uint32_t, uint32_t, const viewport *) override {}
+    void bind_scissor_rects(uint32_t, uint32_t, const rect *) override {}
+    void push_constants(shader_stage, pipeline_layout, uint32_t, uint32_t, uint32_t, const void *) override {}
+    void push_descriptors(shader_stage, pipeline_layout, uint32_t, const descriptor_table_update &) override {}
+    void bind_descriptor_tables(shader_stage, pipeline_layout, uint32_t, uint32_t, const descriptor_table *) override {}
+    void bind_index_buffer(resource, uint64_t, uint32_t) override {}
+    void bind_vertex_buffers(uint32_t, uint32_t, const resource *, const uint64_t *, const uint32_t *) override {}
+    void bind_stream_output_buffers(uint32_t, uint32_t, const resource *, const uint64_t *, const uint64_t *, const resource *, const uint64_t *) override {}
+    void draw(uint32_t, uint32_t, uint32_t, uint32_t) override {}
+    void draw_indexed(uint32_t, uint32_t, uint32_t, int32_t, uint32_t) override {}
+    void dispatch(uint32_t, uint32_t, uint32_t) override {}
+    void draw_or_dispatch_indirect(indirect_command, resource, uint64_t, uint32_t, uint32_t) override {}
+    void copy_resource(resource, resource) override {}
+    void copy_buffer_region(resource, uint64_t, resource, uint64_t, uint64_t) override {}
+    void copy_buffer_to_texture(resource, uint64_t, uint32_t, uint32_t, resource, uint32_t, const subresource_box *) override {}
+    void copy_texture_to_buffer(resource, uint32_t, const subresource_box *, resource, uint64_t, uint32_t, uint32_t) override {}
+    void clear_depth_stencil_view(resource_view, const float *, const uint8_t *, uint32_t, const rect *) override {}
+    void clear_render_target_view(resource_view, const float[4], uint32_t, const rect *) override {}
+    void clear_unordered_access_view_uint(resource_view, const uint32_t[4], uint32_t, const rect *) override {}
+    void clear_unordered_access_view_float(resource_view, const float[4], uint32_t, const rect *) override {}
+    void generate_mipmaps(resource_view) override {}
+    void begin_query(query_heap, query_type, uint32_t) override {}
+    void end_query(query_heap, query_type, uint32_t) override {}
+    void copy_query_heap_results(query_heap, query_type, uint32_t, uint32_t, resource, uint64_t, uint32_t) override {}
+    void begin_debug_event(const char *, const float[4]) override {}
+    void end_debug_event() override {}
+    void insert_debug_marker(const char *, const float[4]) override {}
+    void dispatch_mesh(uint32_t, uint32_t, uint32_t) override {}
+    void dispatch_rays(resource, uint64_t, uint64_t, resource, uint64_t, uint64_t, uint64_t, resource, uint64_t, uint64_t, uint64_t, resource, uint64_t, uint64_t, uint64_t, uint32_t, uint32_t, uint32_t) override {}
+    void copy_acceleration_structure(resource_view, resource_view, acceleration_structure_copy_mode) override {}
+    void build_acceleration_structure(acceleration_structure_type, acceleration_structure_build_flags, uint32_t, const acceleration_structure_build_input *, resource, uint64_t, resource_view, resource_view, acceleration_structure_build_mode) override {}
+    void query_acceleration_structures(uint32_t, const resource_view *, query_heap, query_type, uint32_t) override {}
+    void update_buffer_region(const void *, resource, uint64_t, uint64_t) override {}
+    void update_texture_region(const subresource_data &, resource, uint32_t, const subresource_box *) override {}
+
+private:
+    device *const owner;
+};
+
+class device_impl final : public device
+{
+public:
+    explicit device_impl(device_api api) : api(api) {}
+
+    device_api get_api() const override { return api; }
+    bool check_capability(device_caps capability) const override { return capability == device_caps::resolve_depth_stencil && can_resolve_depth; }
+
+    bool create_resource(const resource_desc &desc, const subresource_data *, resource_usage, resource *out_resource, void **) override
+    {
+        const uint64_t handle = next_handle++;
+        resources[handle] = desc;
+        *out_resource = { handle };
+        return true;
+    }
+    void destroy_resource(resource res) override { resources.erase(res.handle); }
+    resource_desc get_resource_desc(resource res) const override
+    {
+        const auto it = resources.find(res.handle);
+        return it != resources.end() ? it->second : resource_desc {};
+    }
+
+    bool create_resource_view(resource res, resource_usage, const resource_view_desc &desc, resource_view *out_view) override
+    {
+        if (resources.find(res.handle) == resources.end())
+            return false;
+        const uint64_t handle = next_handle++;
+        views[handle] = { res, desc };
+        ++views_created;
+        *out_view = { handle };
+        return true;
+    }
+    void destroy_resource_view(resource_view view) override
+    {
+        if (views.erase(view.handle) != 0)
+            ++views_destroyed;
+    }
+    resource get_resource_from_view(resource_view view) const override
+    {
+        const auto it = views.find(view.handle);
+        return it != views.end() ? it->second.res : resource { 0 };
+    }
+    resource_view_desc get_resource_view_desc(resource_view view) const override
+    {
+        const auto it = views.find(view.handle);
+        return it != views.end() ? it->second.desc : resource_view_desc {};
+    }
+
+    // Creates a game-owned texture plus one view of it, the way the game's own render targets and depth buffers appear.
+    resource_view make_texture(uint32_t width, uint32_t height, format fmt, resource_usage usage, uint32_t samples = 1)
+    {
+        resource_desc desc(width, height, 1, 1, fmt, samples, memory_heap::gpu_only, usage);
+        resource res = { 0 };
+        create_resource(desc, nullptr, resource_usage::undefined, &res, nullptr);
+        resource_view view = { 0 };
+        create_resource_view(res, usage, resource_view_desc(fmt), &view);
+        return view;
+    }
+    // Destroys a game-owned texture and every view of it (the add-on hears about it through destroy_resource).
+    void release_texture(resource res)
+    {
+        for (auto it = views.begin(); it != views.end();)
+            it = (it->second.res.handle == res.handle) ? views.erase(it) : std::next(it);
+        resources.erase(res.handle);
+    }
+
+    size_t live_views() const { return views.size(); }
+
+    bool can_resolve_depth = true;
+    uint64_t views_created = 0;
+    uint64_t views_destroyed = 0;
+
+    FAKE_RESHADE_API_OBJECT_STUBS
+    bool check_format_support(format, resource_usage) const override { return false; }
+    bool create_sampler(const sampler_desc &, sampler *) override { return false; }
+    void destroy_sampler(sampler) override {}
+    bool map_buffer_region(resource, uint64_t, uint64_t, map_access, void **) override { return false; }
+    void unmap_buffer_region(resource) override {}
+    bool map_texture_region(resource, uint32_t, const subresource_box *, map_access, subresource_data *) override { return false; }
+    void unmap_texture_region(resource, uint32_t) override {}
+    void update_buffer_region(const void *, resource, uint64_t, uint64_t) override {}
+    void update_texture_region(const subresource_data &, resource, uint32_t, const subresource_box *) override {}
+    bool create_pipeline(pipeline_layout, uint32_t, const pipeline_subobject *, pipeline *) override { return false; }
+    void destroy_pipeline(pipeline) override {}
+    bool create_pipeline_layout(uint32_t, const pipeline_layout_param *, pipeline_layout *) override { return false; }
+    void destroy_pipeline_layout(pipeline_layout) override {}
+    bool allocate_descriptor_tables(uint32_t, pipeline_layout, uint32_t, descriptor_table *) override { return false; }
+    void free_descriptor_tables(uint32_t, const descriptor_table *) override {}
+    void get_descriptor_heap_offset(descriptor_table, uint32_t, uint32_t, descriptor_heap *, uint32_t *) const override {}
+    void copy_descriptor_tables(uint32_t, const descriptor_table_copy *) override {}
+    void update_descriptor_tables(uint32_t, const descriptor_table_update *) override {}
+    bool create_query_heap(query_type, uint32_t, query_heap *) override { return false; }
+    void destroy_query_heap(query_heap) override {}
+    bool get_query_heap_results(query_heap, uint32_t, uint32_t, void *, uint32_t) override { return false; }
+    void set_resource_name(resource, const char *) override {}
+    void set_resource_view_name(resource_view, const char *) override {}
+    bool create_fence(uint64_t, fence_flags, fence *, void **) override { return false; }
+    void destroy_fence(fence) override {}
+    uint64_t get_completed_fence_value(fence) const override { return 0; }
+    bool wait(fence, uint64_t, uint64_t) override { return false; }
+    bool signal(fence, uint64_t) override { return false; }
+    bool get_property(device_properties, void *) const override { return false; }
+    uint64_t get_resource_view_gpu_address(resource_view) const override { return 0; }
+    void get_acceleration_structure_size(acceleration_structure_type, acceleration_structure_build_flags, uint32_t, const acceleration_structure_build_input *, uint64_t *, uint64_t *, uint64_t *) const override {}
+    bool get_pipeline_shader_group_handles(pipeline, uint32_t, uint32_t, void *) override { return false; }
+
+private:
+    struct view_entry
+    {
+        resource res;
+        resource_view_desc desc;
+    };
+    const device_api api;
+    uint64_t next_handle = 0x1000;
+    std::unordered_map<uint64_t, resource_desc> resources;
+    std::unordered_map<uint64_t, view_entry> views;
+};
+
+class command_queue_impl final : public command_queue
+{
+public:
+    explicit command_queue_impl(device *owner) : owner(owner), immediate(owner) {}
+
+    device *get_device() override { return owner; }
+    command_queue_type get_type() const override { return command_queue_type::graphics; }
+    command_list *get_immediate_command_list() override { return &immediate; }
+    uint64_t get_timestamp_frequency() const override { return 1000000000ull; }
+    command_list_impl &immediate_list() { return immediate; }
+
+    FAKE_RESHADE_API_OBJECT_STUBS
+    void wait_idle() const override {}
+    void flush_immediate_command_list() const override {}
+    void begin_debug_event(const char *, const float[4]) override {}
+    void end_debug_event() override {}
+    void insert_debug_marker(const char *, const float[4]) override {}
+    bool wait(fence, uint64_t) override { return false; }
+    bool signal(fence, uint64_t) override { return false; }
+
+private:
+    device *const owner;
+    command_list_impl immediate;
+};
+
+class runtime_impl final : public effect_runtime
+{
+public:
+    runtime_impl(device *owner, command_queue *queue) : owner(owner), queue(queue) {}
+
+    device *get_device() override { return owner; }
+    command_queue *get_command_queue() override { return queue; }
+    resource get_back_buffer(uint32_t index) override { return index < back_buffers.size() ? back_buffers[index] : resource { 0 }; }
+    uint32_t get_back_buffer_count() const override { return static_cast<uint32_t>(back_buffers.size()); }
+    uint32_t get_current_back_buffer_index() const override { return current_back_buffer; }
+    void render_effects(command_list *cmd_list, resource_view rtv, resource_view rtv_srgb) override
+    {
+        if (on_render_effects)
+            on_render_effects(cmd_list, rtv, rtv_srgb);
+    }
+    void update_texture_bindings(const char *, resource_view, resource_view) override { ++binding_updates; }
+
+    effect_technique find_technique(const char *effect_name, const char *technique_name) override { return { name_handle(effect_name, technique_name) }; }
+    effect_texture_variable find_texture_variable(const char *effect_name, const char *variable_name) const override { return { name_handle(effect_name, variable_name) }; }
+    // Effect-owned render targets: created on first lookup at back buffer size, kept for the life of the runtime.
+    void get_texture_binding(effect_texture_variable variable, resource_view *out_srv, resource_view *out_srv_srgb) const override
+    {
+        resource_view &view = texture_views[variable.handle];
+        if (view.handle == 0)
+        {
+            const resource_desc back = back_buffers.empty() ? resource_desc {} : owner->get_resource_desc(back_buffers[0]);
+            const resource_desc desc(std::max(back.texture.width, 1u), std::max(back.texture.height, 1u), 1, 1, format::r16g16_float, 1,
+                memory_heap::gpu_only, resource_usage::render_target | resource_usage::shader_resource);
+            resource res = { 0 };
+            owner->create_resource(desc, nullptr, resource_usage::shader_resource, &res);
+            owner->create_resource_view(res, resource_usage::shader_resource, resource_view_desc(desc.texture.format), &view);
+        }
+        *out_srv = view;
+        if (out_srv_srgb != nullptr)
+            *out_srv_srgb = view;
+    }
+    void render_technique(effect_technique, command_list *cmd_list, resource_view, resource_view) override
+    {
+        ++techniques;
+        if (static_cast<command_list_impl *>(cmd_list)->in_render_pass)
+            ++techniques_in_pass;
+    }
+
+    std::vector<resource> back_buffers;
+    uint32_t current_back_buffer = 0;
+    uint64_t binding_updates = 0;
+    uint64_t techniques = 0;
+    uint64_t techniques_in_pass = 0;
+    std::function<void(command_list *, resource_view, resource_view)> on_render_effects;
+
+    FAKE_RESHADE_API_OBJECT_STUBS
+    void *get_hwnd() const override { return nullptr; }
+    bool capture_screenshot(void *) override { return false; }
+    void get_screenshot_width_and_height(uint32_t *, uint32_t *) const override {}
+    bool is_key_down(uint32_t) const override { return false; }
+    bool is_key_pressed(uint32_t) const override { return false; }
+    bool is_key_released(uint32_t) const override { return false; }
+    bool is_mouse_button_down(uint32_t) const override { return false; }
+    bool is_mouse_button_pressed(uint32_t) const override { return false; }
+    bool is_mouse_button_released(uint32_t) const override { return false; }
+    void get_mouse_cursor_position(uint32_t *, uint32_t *, int16_t *) const override {}
+    void enumerate_uniform_variables(const char *, void(*)(effect_runtime *, effect_uniform_variable, void *), void *) override {}
+    effect_uniform_variable find_uniform_variable(const char *, const char *) const override { return {}; }
+    void get_uniform_variable_type(effect_uniform_variable, format *, uint32_t *, uint32_t *, uint32_t *) const override {}
+    void get_uniform_variable_name(effect_uniform_variable, char *, size_t *) const override {}
+    bool get_annotation_bool_from_uniform_variable(effect_uniform_variable, const char *, bool *, size_t, size_t) const override { return false; }
+    bool get_annotation_float_from_uniform_variable(effect_uniform_variable, const char *, float *, size_t, size_t) const override { return false; }
+    bool get_annotation_int_from_uniform_variable(effect_uniform_variable, const char *, int32_t *, size_t, size_t) const override { return false; }
+    bool get_annotation_uint_from_uniform_variable(effect_uniform_variable, const char *, uint32_t *, size_t, size_t) const override { return false; }
+    bool get_annotation_string_from_uniform_variable(effect_uniform_variable, const char *, char *, size_t *) const override { return false; }
+    void get_uniform_value_bool(effect_uniform_variable, bool *, size_t, size_t) const override {}
+    void get_uniform_value_float(effect_uniform_variable, float *, size_t, size_t) const override {}
+    void get_uniform_value_int(effect_uniform_variable, int32_t *, size_t, size_t) const override {}
+    void get_uniform_value_uint(effect_uniform_variable, uint32_t *, size_t, size_t) const override {}
+    void set_uniform_value_bool(effect_uniform_variable, const bool *, size_t, size_t) override {}
+    void set_uniform_value_float(effect_uniform_variable, const float *, size_t, size_t) override {}
+    void set_uniform_value_int(effect_uniform_variable, const int32_t *, size_t, size_t) override {}
+    void set_uniform_value_uint(effect_uniform_variable, const uint32_t *, size_t, size_t) override {}
+    void enumerate_texture_variables(const char *, void(*)(effect_runtime *, effect_texture_variable, void *), void *) override {}
+    void get_texture_variable_name(effect_texture_variable, char *, size_t *) const override {}
+    bool get_annotation_bool_from_texture_variable(effect_texture_variable, const char *, bool *, size_t, size_t) const override { return false; }
+    bool get_annotation_float_from_texture_variable(effect_texture_variable, const char *, float *, size_t, size_t) const override { return false; }
+    bool get_annotation_int_from_texture_variable(effect_texture_variable, const char *, int32_t *, size_t, size_t) const override { return false; }
+    bool get_annotation_uint_from_texture_variable(effect_texture_variable, const char *, uint32_t *, size_t, size_t) const override { return false; }
+    bool get_annotation_string_from_texture_variable(effect_texture_variable, const char *, char *, size_t *) const override { return false; }
+    void update_texture(effect_texture_variable, const uint32_t, const uint32_t, const void *) override {}
+    void enumerate_techniques(const char *, void(*)(effect_runtime *, effect_technique, void *), void *) override {}
+    void get_technique_name(effect_technique, char *, size_t *) const override {}
+    bool get_annotation_bool_from_technique(effect_technique, const char *, bool *, size_t, size_t) const override { return false; }
+    bool get_annotation_float_from_technique(effect_technique, const char *, float *, size_t, size_t) const override { return false; }
+    bool get_annotation_int_from_technique(effect_technique, const char *, int32_t *, size_t, size_t) const override { return false; }
+    bool get_annotation_uint_from_technique(effect_technique, const char *, uint32_t *, size_t, size_t) const override { return false; }
+    bool get_annotation_string_from_technique(effect_technique, const char *, char *, size_t *) const override { return false; }
+    bool get_technique_state(effect_technique) const override { return false; }
+    void set_technique_state(effect_technique, bool) override {}
+    bool get_preprocessor_definition(const char *, char *, size_t *) const override { return false; }
+    void set_preprocessor_definition(const char *, const char *) override {}
+    bool get_effects_state() const override { return false; }
+    void set_effects_state(bool) override {}
+    void get_current_preset_path(char *, size_t *) const override {}
+    void set_current_preset_path(const char *) override {}
+    void reorder_techniques(size_t, const effect_technique *) override {}
+    void block_input_next_frame() override {}
+    uint32_t last_key_pressed() const override { return 0; }
+    uint32_t last_key_released() const override { return 0; }
+    void get_uniform_variable_effect_name(effect_uniform_variable, char *, size_t *) const override {}
+    void get_texture_variable_effect_name(effect_texture_variable, char *, size_t *) const override {}
+    void get_technique_effect_name(effect_technique, char *, size_t *) const override {}
+    void save_current_preset() const override {}
+    bool get_preprocessor_definition_for_effect(const char *, const char *, char *, size_t *) const override { return false; }
+    void set_preprocessor_definition_for_effect(const char *, const char *, const char *) override {}
+    bool open_overlay(bool, input_source) override { return false; }
+    void set_color_space(color_space) override {}
+    void reset_uniform_value(effect_uniform_variable) override {}
+    void reload_effect_next_frame(const char *) override {}
+    void export_current_preset(const char *) const override {}
+    void save_screenshot(const char *) override {}
+
+private:
+    uint64_t name_handle(const char *effect_name, const char *name) const
+    {
+        const auto it = name_handles.try_emplace(std::string(effect_name) + '/' + name, name_handles.size() + 1).first;
+        return it->second;
+    }
+
+    device *const owner;
+    command_queue *const queue;
+    mutable std::unordered_map<std::string, uint64_t> name_handles;
+    mutable std::unordered_map<uint64_t, resource_view> texture_views;
+};
+
+#undef FAKE_RESHADE_API_OBJECT_STUBS
+}
@@ -0,0 +1,556 @@
+// Synthetic frame-stream generator for the pre-HUD decision path.
+// Builds the add-on translation unit as-is against an in-memory ReShade device and replays the per-frame protocol the
+// bridge and DXVK produce (PreDisplay, shadow/mirror/scene passes, token window, composite, HUD, present), with
+// backbuffer rotation, null-RTV bursts, precipitation flips, FE overlay enter/exit (phase invalidate), effect reloads,
+// swapchain resizes, scene depth recreation and 50..5000 passes per frame. Every render_effects call is checked against the invariants:
+// at most one render per frame, never twice for the same token, and never on a non-locked pair the selector would
+// not accept (score below k_prehud_min_unlocked_score). Nothing the add-on records from begin_render_pass may be a
+// copy, resolve, barrier or technique render (it lands inside the game's render pass). Prints throughput; exits non-zero on any violation.
+//
+//   prehud_stream_bench [--frames N] [--passes MIN-MAX] [--path bind|beginpass|both] [--backbuffers K] [--msaa N] [--seed S]
+//                       [--null-rtv P] [--precip P] [--overlay P] [--reload P] [--resize P] [--recreate P] [--sweep] [--verbose]
+
+#include <windows.h>
+#include "../../NFS_addon/dllmain.cpp"
+#include "fake_reshade.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <string>
+
+static bool s_verbose = false;
+static uint64_t s_log_lines = 0;
+
+// ReShade exports, resolved by the header-only API through GetProcAddress as in the real DLL.
+static void fake_log_message(void *, int, const char *message)
+{
+    ++s_log_lines;
+    if (s_verbose)
+        fputs(message, stdout);
+}
+static bool fake_register_addon(void *, uint32_t) { return true; }
+static void fake_unregister_addon(void *) {}
+static void fake_register_event(reshade::addon_event, void *) {}
+static void fake_unregister_event(reshade::addon_event, void *) {}
+static const imgui_function_table *fake_get_imgui_function_table(uint32_t)
+{
+    static const imgui_function_table s_table = {};
+    return &s_table;
+}
+
+static HMODULE const s_reshade_module = reinterpret_cast<HMODULE>(static_cast<uintptr_t>(0x10000));
+
+extern "C" BOOL WINAPI K32EnumProcessModules(HANDLE, HMODULE *modules, DWORD cb, LPDWORD needed)
+{
+    if (cb >= sizeof(HMODULE))
+        modules[0] = s_reshade_module;
+    *needed = sizeof(HMODULE);
+    return TRUE;
+}
+
+FARPROC GetProcAddress(HMODULE module, LPCSTR name)
+{
+    static const struct
+    {
+        const char *name;
+        void *func;
+    } k_exports[] = {
+        { "ReShadeLogMessage", reinterpret_cast<void *>(fake_log_message) },
+        { "ReShadeRegisterAddon", reinterpret_cast<void *>(fake_register_addon) },
+        { "ReShadeUnregisterAddon", reinterpret_cast<void *>(fake_unregister_addon) },
+        { "ReShadeRegisterEvent", reinterpret_cast<void *>(fake_register_event) },
+        { "ReShadeUnregisterEvent", reinterpret_cast<void *>(fake_unregister_event) },
+        { "ReShadeGetImGuiFunctionTable", reinterpret_cast<void *>(fake_get_imgui_function_table) },
+    };
+    if (module != s_reshade_module)
+        return nullptr;
+    for (const auto &e : k_exports)
+    {
+        if (strcmp(e.name, name) == 0)
+            return reinterpret_cast<FARPROC>(e.func);
+    }
+    return nullptr;
+}
+
+namespace
+{
+enum class stream_path
+{
+    bind,       // bind_render_targets_and_depth_stencil only
+    beginpass,  // begin_render_pass only (the add-on falls back to its render-pass selector)
+    both,       // both events per pass, as ReShade reports them under DXVK
+};
+
+struct stream_options
+{
+    uint64_t frames = 20000;
+    uint32_t passes_min = 50;
+    uint32_t passes_max = 5000;
+    uint32_t backbuffers = 3;
+    uint32_t seed = 1;
+    uint32_t msaa = 1;        // scene depth sample count; > 1 also enables the add-on's MSAA depth resolve
+    stream_path path = stream_path::both;
+    double p_null_rtv = 0.05; // per frame: a burst of null-RTV passes around the composite
+    double p_precip = 0.002;  // per frame: precipitation flips
+    double p_overlay = 0.002; // per frame: FE overlay enters or exits
+    double p_reload = 0.001;  // per frame: effects reload
+    double p_resize = 0.0005; // per frame: swapchain resize
+    double p_recreate = 0.001; // per frame: game recreates its scene depth buffer without a swapchain reset
+};
+
+struct stream_stats
+{
+    uint64_t frames = 0;
+    uint64_t callbacks = 0;
+    uint64_t tokens = 0;
+    uint64_t tokens_rendered = 0;
+    uint64_t renders = 0;
+    uint64_t renders_in_hud = 0;      // landed after the composite pass (HUD already drawn into the target)
+    uint64_t double_frame = 0;
+    uint64_t double_token = 0;
+    uint64_t unlocked_pair = 0;
+    uint64_t stale_binding = 0;
+    uint64_t resolve_in_pass = 0;
+    uint64_t copy_in_pass = 0;
+    uint64_t barrier_in_pass = 0;
+    uint64_t technique_in_pass = 0;
+    uint64_t techniques = 0;          // FX product techniques rendered by the add-on
+    uint64_t null_rtv_bursts = 0;
+    uint64_t precip_flips = 0;
+    uint64_t overlay_toggles = 0;
+    uint64_t reloads = 0;
+    uint64_t resizes = 0;
+    uint64_t recreates = 0;
+    double seconds = 0.0;
+};
+
+// Game-side render targets; recreated on resize.
+struct stream_targets
+{
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<resource_view> back;
+    resource_view scene_rt = { 0 };
+    resource_view scene_ds = { 0 };
+    resource_view rain_rt = { 0 };
+    resource_view shadow_ds = { 0 };
+    resource_view mirror_rt = { 0 };
+    resource_view mirror_ds = { 0 };
+    resource_view blur_rt = { 0 };
+};
+
+class stream_generator
+{
+public:
+    explicit stream_generator(const stream_options &options) :
+        opt(options), rng(options.seed), device(device_api::vulkan), queue(&device), runtime(&device, &queue)
+    {
+        bridge = NFSTweak_GetInterface(NFSTWEAK_INTERFACE_VERSION);
+        runtime.on_render_effects = [this](command_list *cmd_list, resource_view rtv, resource_view rtv_srgb) {
+            on_render_effects(cmd_list, rtv, rtv_srgb);
+        };
+    }
+
+    stream_stats run()
+    {
+        g_enable_vulkan_beginpass_prehud.store(opt.path != stream_path::bind);
+        // Set before init like a user's saved choice; runtime re-init (resizes) must keep it.
+        g_enable_vulkan_msaa_resolve.store(opt.msaa > 1);
+        create_targets(1920, 1080);
+        on_init_effect_runtime(&runtime);
+        bridge->NotifyPrecipitationChanged(0);
+
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < opt.frames; ++i)
+            run_frame();
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        on_destroy_effect_runtime(&runtime);
+        release_targets();
+        stats.frames = opt.frames;
+        stats.techniques = runtime.techniques;
+        return stats;
+    }
+
+private:
+    bool chance(double p) { return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < p; }
+    uint32_t uniform(uint32_t lo, uint32_t hi) { return std::uniform_int_distribution<uint32_t>(lo, hi)(rng); }
+
+    void create_targets(uint32_t width, uint32_t height)
+    {
+        targets.width = width;
+        targets.height = height;
+        runtime.back_buffers.clear();
+        targets.back.clear();
+        for (uint32_t i = 0; i < std::max(opt.backbuffers, 1u); ++i)
+        {
+            const resource_view view = device.make_texture(width, height, format::b8g8r8a8_unorm, resource_usage::render_target);
+            targets.back.push_back(view);
+            runtime.back_buffers.push_back(device.get_resource_from_view(view));
+        }
+        targets.scene_rt = device.make_texture(width, height, format::r10g10b10a2_unorm, resource_usage::render_target);
+        targets.scene_ds = device.make_texture(width, height, format::d24_unorm_s8_uint, resource_usage::depth_stencil, opt.msaa);
+        targets.rain_rt = device.make_texture(width, height, format::r8g8b8a8_unorm, resource_usage::render_target);
+        targets.shadow_ds = device.make_texture(2048, 2048, format::d32_float, resource_usage::depth_stencil);
+        targets.mirror_rt = device.make_texture(512, 256, format::r8g8b8a8_unorm, resource_usage::render_target);
+        targets.mirror_ds = device.make_texture(512, 256, format::d24_unorm_s8_uint, resource_usage::depth_stencil);
+        targets.blur_rt = device.make_texture(width / 2, height / 2, format::r8g8b8a8_unorm, resource_usage::render_target);
+    }
+
+    void release_view_resource(resource_view view)
+    {
+        const resource res = device.get_resource_from_view(view);
+        if (res.handle == 0)
+            return;
+        on_destroy_resource(&device, res);
+        // The add-on must not leave a view of a destroyed resource bound to the effects.
+        if (g_bound_runtime_depth_view.handle != 0 && device.get_resource_from_view(g_bound_runtime_depth_view).handle == res.handle)
+            report(stats.stale_binding, "depth view of destroyed resource still bound");
+        device.release_texture(res);
+    }
+
+    void release_targets()
+    {
+        for (const resource_view view : targets.back)
+            release_view_resource(view);
+        for (const resource_view view : { targets.scene_rt, targets.scene_ds, targets.rain_rt, targets.shadow_ds,
+                                          targets.mirror_rt, targets.mirror_ds, targets.blur_rt })
+            release_view_resource(view);
+        targets.back.clear();
+        runtime.back_buffers.clear();
+    }
+
+    // One game pass: the RT/DS bind and/or render pass begin, as selected by --path.
+    void pass(resource_view rtv, resource_view dsv, bool hud = false)
+    {
+        in_hud = hud;
+        pass_dsv = dsv;
+        command_list *const cmd_list = queue.get_immediate_command_list();
+        const uint32_t count = (rtv.handle != 0 || null_rtv_slot) ? 1u : 0u;
+        if (opt.path != stream_path::beginpass)
+        {
+            on_bind_render_targets_and_depth_stencil(cmd_list, count, &rtv, dsv);
+            ++stats.callbacks;
+        }
+        if (opt.path != stream_path::bind)
+        {
+            render_pass_render_target_desc rt_desc = {};
+            rt_desc.view = rtv;
+            render_pass_depth_stencil_desc ds_desc = {};
+            ds_desc.view = dsv;
+            // Everything recorded from begin_render_pass lands inside the game's render pass: no resolves, copies,
+            // barriers or technique renders there.
+            fake_reshade::command_list_impl &list = queue.immediate_list();
+            const uint64_t resolves = list.resolves_in_pass, copies = list.copies_in_pass, barriers = list.barriers_in_pass;
+            const uint64_t techniques = runtime.techniques_in_pass;
+            list.begin_render_pass(count, &rt_desc, dsv.handle != 0 ? &ds_desc : nullptr);
+            on_begin_render_pass(cmd_list, count, &rt_desc, dsv.handle != 0 ? &ds_desc : nullptr);
+            list.end_render_pass();
+            if (list.resolves_in_pass != resolves)
+                report(stats.resolve_in_pass, "resolve recorded inside a render pass");
+            if (list.copies_in_pass != copies)
+                report(stats.copy_in_pass, "copy recorded inside a render pass");
+            if (list.barriers_in_pass != barriers)
+                report(stats.barrier_in_pass, "barrier recorded inside a render pass");
+            if (runtime.techniques_in_pass != techniques)
+                report(stats.technique_in_pass, "technique rendered inside a render pass");
+            ++stats.callbacks;
+        }
+    }
+
+    void null_rtv_burst()
+    {
+        ++stats.null_rtv_bursts;
+        null_rtv_slot = true;
+        for (uint32_t i = uniform(2, 12); i != 0; --i)
+            pass({ 0 }, targets.scene_ds);
+        null_rtv_slot = false;
+    }
+
+    void perturb()
+    {
+        if (chance(opt.p_precip))
+        {
+            precip = !precip;
+            bridge->NotifyPrecipitationChanged(precip ? 0x02u : 0u);
+            ++stats.precip_flips;
+        }
+        if (chance(opt.p_overlay))
+        {
+            overlay = !overlay;
+            bridge->NotifyPhaseInvalidateEx(overlay ? 1u : 2u, ++bridge_epoch);
+            ++stats.overlay_toggles;
+        }
+        if (chance(opt.p_reload))
+        {
+            on_reshade_reloaded_effects(&runtime);
+            ++stats.reloads;
+        }
+        if (chance(opt.p_resize))
+        {
+            on_destroy_effect_runtime(&runtime);
+            release_targets();
+            static const uint32_t k_sizes[][2] = { { 1920, 1080 }, { 1280, 720 }, { 2560, 1440 }, { 1600, 900 } };
+            const uint32_t *size = k_sizes[uniform(0, 3)];
+            create_targets(size[0], size[1]);
+            on_init_effect_runtime(&runtime);
+            ++stats.resizes;
+        }
+        if (chance(opt.p_recreate))
+        {
+            release_view_resource(targets.scene_ds);
+            targets.scene_ds = device.make_texture(targets.width, targets.height, format::d24_unorm_s8_uint, resource_usage::depth_stencil, opt.msaa);
+            ++stats.recreates;
+        }
+    }
+
+    void run_frame()
+    {
+        ++bridge_frame;
+        perturb();
+
+        runtime.current_back_buffer = static_cast<uint32_t>(bridge_frame % runtime.back_buffers.size());
+        const resource_view back = targets.back[runtime.current_back_buffer];
+        bridge->MarkTimelineEvent(NFSTWEAK_TIMELINE_PREDISPLAY, bridge_frame, 0, qpc_now());
+
+        const uint32_t passes = uniform(opt.passes_min, opt.passes_max);
+        const uint32_t shadow = std::max(1u, passes * 4 / 100);
+        const uint32_t mirror = std::max(1u, passes * 6 / 100);
+        const uint32_t rain = precip ? std::max(1u, passes * 5 / 100) : 0u;
+        const uint32_t post = std::max(1u, passes * 10 / 100);
+        const uint32_t used = shadow + mirror + rain + post + 1;
+        const uint32_t scene = overlay ? std::max(1u, passes / 10) : std::max(1u, (passes * 60 / 100));
+        const uint32_t hud = passes > used + scene ? passes - used - scene : 1u;
+        const bool burst = chance(opt.p_null_rtv);
+        composite_done = false;
+        frame_renders = 0;
+
+        command_list *const cmd_list = queue.get_immediate_command_list();
+        on_clear_depth_stencil_view(cmd_list, targets.shadow_ds, nullptr, nullptr, 0, nullptr);
+        for (uint32_t i = 0; i < shadow; ++i)
+            pass({ 0 }, targets.shadow_ds);
+        for (uint32_t i = 0; i < mirror; ++i)
+            pass(targets.mirror_rt, targets.mirror_ds);
+        on_clear_depth_stencil_view(cmd_list, targets.scene_ds, nullptr, nullptr, 0, nullptr);
+        for (uint32_t i = 0; i < scene; ++i)
+            pass(targets.scene_rt, targets.scene_ds);
+        for (uint32_t i = 0; i < rain; ++i)
+            pass(targets.rain_rt, targets.scene_ds);
+        for (uint32_t i = 0; i < post; ++i)
+            pass((i & 1) ? back : targets.blur_rt, { 0 });
+
+        // The bridge only opens a window when the canonical scene pair is bound (never in the FE overlay).
+        if (!overlay)
+        {
+            ++token;
+            ++stats.tokens;
+            bridge->MarkTimelineEvent(NFSTWEAK_TIMELINE_TOKEN, bridge_frame, token, qpc_now());
+            bridge->BeginPreHudWindowEx(token, bridge_epoch);
+            bridge->RequestPreHudEffects();
+            bridge->EndPreHudWindowEx(token, bridge_epoch);
+        }
+        if (burst)
+            null_rtv_burst();
+        pass(back, targets.scene_ds);
+        composite_done = true;
+        if (burst)
+            null_rtv_burst();
+        for (uint32_t i = 0; i < hud; ++i)
+            pass(back, (i & 1) ? targets.scene_ds : resource_view { 0 }, true);
+
+        on_present(&queue, nullptr, nullptr, nullptr, 0, nullptr);
+        ++stats.callbacks;
+    }
+
+    // Invariants are checked against the lock as it stands when the add-on decides (before it refreshes the lock).
+    void on_render_effects(command_list *cmd_list, resource_view rtv, resource_view rtv_srgb)
+    {
+        on_reshade_begin_effects(&runtime, cmd_list, rtv, rtv_srgb);
+        on_reshade_finish_effects(&runtime, cmd_list, rtv, rtv_srgb);
+
+        ++stats.renders;
+        if (++frame_renders > 1)
+            report(stats.double_frame, "double render in frame");
+        if (in_hud && composite_done)
+            ++stats.renders_in_hud;
+        if (!overlay && token != 0)
+        {
+            if (rendered_tokens.size() <= token)
+                rendered_tokens.resize(token + 1, 0);
+            if (rendered_tokens[token]++ != 0)
+                report(stats.double_token, "double render for token");
+            else
+                ++stats.tokens_rendered;
+        }
+
+        const resource rt = device.get_resource_from_view(rtv);
+        const resource ds = device.get_resource_from_view(pass_dsv);
+        const resource back = runtime.back_buffers[runtime.current_back_buffer];
+        const resource_desc rt_desc = device.get_resource_desc(rt);
+        const uint32_t score =
+            rt.handle == back.handle ? 1000u :
+            (rt_desc.texture.width == targets.width && rt_desc.texture.height == targets.height) ? 600u : 0u;
+        if (g_prehud_locked_rt_resource.handle != 0 && g_prehud_locked_ds_resource.handle != 0 &&
+            (rt.handle != g_prehud_locked_rt_resource.handle || ds.handle != g_prehud_locked_ds_resource.handle) &&
+            score < k_prehud_min_unlocked_score)
+            report(stats.unlocked_pair, "render on non-locked pair below score floor");
+    }
+
+    void report(uint64_t &counter, const char *what)
+    {
+        if (counter++ < 8)
+            printf("violation: %s (frame %u token %u)\n", what, bridge_frame, token);
+    }
+
+    const stream_options opt;
+    std::mt19937 rng;
+    fake_reshade::device_impl device;
+    fake_reshade::command_queue_impl queue;
+    fake_reshade::runtime_impl runtime;
+    const NFSTweakInterfaceV1 *bridge = nullptr;
+    stream_targets targets;
+    stream_stats stats;
+    std::vector<uint8_t> rendered_tokens;
+    unsigned int bridge_frame = 0;
+    unsigned int bridge_epoch = 1;
+    unsigned int token = 0;
+    uint32_t frame_renders = 0;
+    bool precip = false;
+    bool overlay = false;
+    resource_view pass_dsv = { 0 };
+    bool in_hud = false;
+    bool composite_done = false;
+    bool null_rtv_slot = false;
+};
+}
+
+static bool parse_options(int argc, char **argv, stream_options &opt, bool &sweep)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--sweep")
+            sweep = true;
+        else if (arg == "--verbose")
+            s_verbose = true;
+        else if (value == nullptr)
+            return false;
+        else if (arg == "--frames")
+            opt.frames = strtoull(value, nullptr, 10), ++i;
+        else if (arg == "--passes")
+        {
+            unsigned int lo = 0, hi = 0;
+            const int n = sscanf(value, "%u-%u", &lo, &hi);
+            if (n < 1 || lo == 0)
+                return false;
+            opt.passes_min = lo;
+            opt.passes_max = n == 2 ? std::max(lo, hi) : lo;
+            ++i;
+        }
+        else if (arg == "--path")
+        {
+            const std::string path = value;
+            if (path == "bind")
+                opt.path = stream_path::bind;
+            else if (path == "beginpass")
+                opt.path = stream_path::beginpass;
+            else if (path == "both")
+                opt.path = stream_path::both;
+            else
+                return false;
+            ++i;
+        }
+        else if (arg == "--backbuffers")
+            opt.backbuffers = static_cast<uint32_t>(strtoul(value, nullptr, 10)), ++i;
+        else if (arg == "--seed")
+            opt.seed = static_cast<uint32_t>(strtoul(value, nullptr, 10)), ++i;
+        else if (arg == "--null-rtv")
+            opt.p_null_rtv = atof(value), ++i;
+        else if (arg == "--precip")
+            opt.p_precip = atof(value), ++i;
+        else if (arg == "--overlay")
+            opt.p_overlay = atof(value), ++i;
+        else if (arg == "--reload")
+            opt.p_reload = atof(value), ++i;
+        else if (arg == "--resize")
+            opt.p_resize = atof(value), ++i;
+        else if (arg == "--msaa")
+            opt.msaa = std::max(1u, static_cast<uint32_t>(strtoul(value, nullptr, 10))), ++i;
+        else if (arg == "--recreate")
+            opt.p_recreate = atof(value), ++i;
+        else
+            return false;
+    }
+    return true;
+}
+
+static const char *path_name(stream_path path)
+{
+    return path == stream_path::bind ? "bind" : path == stream_path::beginpass ? "beginpass" : "both";
+}
+
+static uint64_t print_run(const stream_options &opt, const stream_stats &s)
+{
+    const double ns_per_callback = s.callbacks != 0 ? s.seconds * 1e9 / static_cast<double>(s.callbacks) : 0.0;
+    printf("path=%-9s passes=%u-%u frames=%llu  %.0f frames/s  %.1f ns/callback\n",
+        path_name(opt.path), opt.passes_min, opt.passes_max, static_cast<unsigned long long>(s.frames),
+        s.seconds > 0.0 ? static_cast<double>(s.frames) / s.seconds : 0.0, ns_per_callback);
+    printf("  tokens=%llu rendered=%llu (%.1f%%) renders=%llu in_hud=%llu fx_techniques=%llu\n",
+        static_cast<unsigned long long>(s.tokens), static_cast<unsigned long long>(s.tokens_rendered),
+        s.tokens != 0 ? 100.0 * static_cast<double>(s.tokens_rendered) / static_cast<double>(s.tokens) : 0.0,
+        static_cast<unsigned long long>(s.renders), static_cast<unsigned long long>(s.renders_in_hud),
+        static_cast<unsigned long long>(s.techniques));
+    printf("  events: null_rtv_bursts=%llu precip_flips=%llu overlay_toggles=%llu reloads=%llu resizes=%llu recreates=%llu\n",
+        static_cast<unsigned long long>(s.null_rtv_bursts), static_cast<unsigned long long>(s.precip_flips),
+        static_cast<unsigned long long>(s.overlay_toggles), static_cast<unsigned long long>(s.reloads),
+        static_cast<unsigned long long>(s.resizes), static_cast<unsigned long long>(s.recreates));
+    printf("  violations: double_frame=%llu double_token=%llu unlocked_pair=%llu stale_binding=%llu in_pass(resolve=%llu copy=%llu barrier=%llu technique=%llu) (add-on counters %llu/%llu/%llu)\n",
+        static_cast<unsigned long long>(s.double_frame), static_cast<unsigned long long>(s.double_token),
+        static_cast<unsigned long long>(s.unlocked_pair), static_cast<unsigned long long>(s.stale_binding),
+        static_cast<unsigned long long>(s.resolve_in_pass), static_cast<unsigned long long>(s.copy_in_pass),
+        static_cast<unsigned long long>(s.barrier_in_pass), static_cast<unsigned long long>(s.technique_in_pass),
+        static_cast<unsigned long long>(g_prehud_invariant_double_frame.load()),
+        static_cast<unsigned long long>(g_prehud_invariant_double_token.load()),
+        static_cast<unsigned long long>(g_prehud_invariant_unlocked_pair.load()));
+    return s.double_frame + s.double_token + s.unlocked_pair + s.stale_binding + s.resolve_in_pass + s.copy_in_pass + s.barrier_in_pass + s.technique_in_pass +
+        g_prehud_invariant_double_frame.load() +
+        g_prehud_invariant_double_token.load() + g_prehud_invariant_unlocked_pair.load();
+}
+
+int main(int argc, char **argv)
+{
+    stream_options opt;
+    bool sweep = false;
+    if (!parse_options(argc, argv, opt, sweep))
+    {
+        fprintf(stderr,
+            "usage: %s [--frames N] [--passes MIN-MAX] [--path bind|beginpass|both] [--backbuffers K] [--msaa N] [--seed S]\n"
+            "          [--null-rtv P] [--precip P] [--overlay P] [--reload P] [--resize P] [--recreate P] [--sweep] [--verbose]\n",
+            argv[0]);
+        return 2;
+    }
+
+    DllMain(nullptr, DLL_PROCESS_ATTACH, nullptr);
+    uint64_t violations = 0;
+    if (sweep)
+    {
+        // Throughput at fixed pass counts, no perturbations.
+        for (const uint32_t passes : { 50u, 200u, 1000u, 5000u })
+        {
+            stream_options run = opt;
+            run.passes_min = run.passes_max = passes;
+            run.p_null_rtv = run.p_precip = run.p_overlay = run.p_reload = run.p_resize = run.p_recreate = 0.0;
+            violations += print_run(run, stream_generator(run).run());
+        }
+    }
+    else
+    {
+        violations += print_run(opt, stream_generator(opt).run());
+    }
+    DllMain(nullptr, DLL_PROCESS_DETACH, nullptr);
+
+    printf("log lines: %llu\n", static_cast<unsigned long long>(s_log_lines));
+    return violations != 0 ? 1 : 0;
+}
@@ -0,0 +1,244 @@
+// nfs_trace_decode.cpp
+// Reads an add-on flight recorder file (NFSTweakBridge_FlightRecorder.bin / .prev.bin) after the fact, e.g. after a
+// crash, and prints the merged trace in the same format as the Ctrl+F10 dump plus the hook/callback spans.
+//
+// Build (Linux or any C++17 compiler):
+//   g++ -std=c++17 -O2 -Iincludes tools/nfs_trace_decode.cpp -o nfs_trace_decode
+// Usage:
+//   nfs_trace_decode <file> [-n <last N records>] [--summary]
+
+#include "NFSTweakTraceFile.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr uint32_t k_max_words = 255;
+
+    struct record
+    {
+        NFSTweakTraceRecordHeader header;
+        uint32_t ring;
+        uint32_t thread_id;
+        uint32_t words[k_max_words];
+    };
+
+    // Keep in sync with trace_span_name (NFS_addon/src/addon_trace.inl); ids below 16 are the bridge's NFSTWEAK_SPAN_*.
+    const char *span_name(uint32_t span)
+    {
+        switch (span)
+        {
+        case 1: return "PreDisplay_Render";
+        case 2: return "sub_516F70";
+        case 3: return "FEManager_Render";
+        case 16: return "present";
+        case 17: return "render_effects (pre-HUD)";
+        case 18: return "ReShade effects";
+        case 19: return "reshade_reloaded_effects";
+        case 20: return "reshade_overlay";
+        default: return "span";
+        }
+    }
+
+    // Keep in sync with bridge_event_name (NFS_addon/src/addon_trace.inl); ids are NFSTWEAK_TIMELINE_* from NFSTweakBridgeAPI.h.
+    const char *bridge_event_name(uint32_t event)
+    {
+        switch (event)
+        {
+        case 5: return "BeginPreHudWindow";
+        case 6: return "EndPreHudWindow";
+        case 7: return "NotifyPrecipitationChanged";
+        case 8: return "NotifyPhaseInvalidate";
+        default: return "bridge event";
+        }
+    }
+
+    const char *kind_name(uint8_t kind)
+    {
+        switch (kind)
+        {
+        case NFSTWEAK_TRACE_KIND_RENDER: return "render";
+        case NFSTWEAK_TRACE_KIND_SKIP: return "skip";
+        case NFSTWEAK_TRACE_KIND_TRANSITION: return "transition";
+        case NFSTWEAK_TRACE_KIND_INVARIANT: return "invariant";
+        default: return "record";
+        }
+    }
+
+    bool in_file(const std::vector<uint8_t> &file, uint64_t offset, uint64_t size)
+    {
+        return offset <= file.size() && size <= file.size() - offset;
+    }
+
+    template <typename T>
+    T read_at(const std::vector<uint8_t> &file, uint64_t offset)
+    {
+        T value;
+        memcpy(&value, file.data() + offset, sizeof(T));
+        return value;
+    }
+
+    // Records in [tail, head) of one ring; stops at the first header that doesn't fit.
+    void collect_ring(const std::vector<uint8_t> &file, const NFSTweakTraceFileHeader &h, uint32_t index, std::vector<record> &out, uint32_t &out_thread)
+    {
+        const uint64_t ring_offset = uint64_t(h.rings_offset) + uint64_t(index) * h.ring_stride;
+        const NFSTweakTraceFileRing ring = read_at<NFSTweakTraceFileRing>(file, ring_offset);
+        out_thread = ring.thread_id;
+        if (ring.thread_id == 0 || ring.head <= ring.tail || ring.head - ring.tail > h.ring_data_bytes)
+            return;
+
+        const uint8_t *const data = file.data() + ring_offset + h.ring_data_offset;
+        for (uint64_t pos = ring.tail; pos < ring.head;)
+        {
+            const uint32_t offset = static_cast<uint32_t>(pos % h.ring_data_bytes);
+            if (data[offset] == NFSTWEAK_TRACE_KIND_WRAP)
+            {
+                pos += h.ring_data_bytes - offset;
+                continue;
+            }
+            if (offset + sizeof(NFSTweakTraceRecordHeader) > h.ring_data_bytes)
+                break;
+            record r = {};
+            memcpy(&r.header, data + offset, sizeof(r.header));
+            const uint32_t size = static_cast<uint32_t>(sizeof(r.header)) + 4u * r.header.words;
+            if (offset + size > h.ring_data_bytes || pos + size > ring.head)
+                break;
+            memcpy(r.words, data + offset + sizeof(r.header), 4u * r.header.words);
+            r.ring = index;
+            r.thread_id = ring.thread_id;
+            out.push_back(r);
+            pos += size;
+        }
+    }
+
+    bool lookup_signature(const std::vector<uint8_t> &file, const NFSTweakTraceFileHeader &h, uint32_t id, uint64_t &rtv, uint64_t &dsv)
+    {
+        rtv = dsv = 0;
+        if (id == 0 || id > h.signature_count)
+            return false;
+        const NFSTweakTraceFileSignature slot = read_at<NFSTweakTraceFileSignature>(file, uint64_t(h.signatures_offset) + uint64_t(id - 1) * h.signature_stride);
+        if (slot.state != 2)
+            return false;
+        rtv = slot.rtv;
+        dsv = slot.dsv;
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = nullptr;
+    size_t last = 0;
+    bool summary_only = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+            last = strtoul(argv[++i], nullptr, 10);
+        else if (strcmp(argv[i], "--summary") == 0)
+            summary_only = true;
+        else if (path == nullptr)
+            path = argv[i];
+    }
+    if (path == nullptr)
+    {
+        fprintf(stderr, "usage: %s <NFSTweakBridge_FlightRecorder.bin> [-n <last N records>] [--summary]\n", argv[0]);
+        return 2;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        fprintf(stderr, "error: cannot open '%s'\n", path);
+        return 1;
+    }
+    const std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (file.size() < sizeof(NFSTweakTraceFileHeader))
+    {
+        fprintf(stderr, "error: '%s' is too small for a trace header\n", path);
+        return 1;
+    }
+    const NFSTweakTraceFileHeader h = read_at<NFSTweakTraceFileHeader>(file, 0);
+    if (memcmp(h.magic, NFSTWEAK_TRACE_FILE_MAGIC, sizeof(h.magic)) != 0)
+    {
+        fprintf(stderr, "error: '%s' is not a flight recorder file\n", path);
+        return 1;
+    }
+    if (h.version != NFSTWEAK_TRACE_FILE_VERSION)
+    {
+        fprintf(stderr, "error: schema version %u, this decoder reads %u\n", h.version, NFSTWEAK_TRACE_FILE_VERSION);
+        return 1;
+    }
+    if (h.header_size < sizeof(NFSTweakTraceFileHeader) ||
+        h.signature_stride < sizeof(NFSTweakTraceFileSignature) ||
+        h.ring_data_offset < sizeof(NFSTweakTraceFileRing) || h.ring_data_bytes == 0 ||
+        h.ring_stride < uint64_t(h.ring_data_offset) + h.ring_data_bytes ||
+        !in_file(file, h.signatures_offset, uint64_t(h.signature_count) * h.signature_stride) ||
+        !in_file(file, h.rings_offset, uint64_t(h.ring_count) * h.ring_stride))
+    {
+        fprintf(stderr, "error: inconsistent layout (file %zu bytes)\n", file.size());
+        return 1;
+    }
+
+    const double freq = h.qpc_frequency != 0 ? static_cast<double>(h.qpc_frequency) : 1.0;
+    const auto session_ms = [&](uint64_t qpc) { return static_cast<double>(static_cast<int64_t>(qpc - h.open_qpc)) * 1000.0 / freq; };
+
+    printf("flight recorder: %s\n", path);
+    printf("  version=%u pid=%u state=%s\n", h.version, h.process_id,
+        h.state == NFSTWEAK_TRACE_STATE_CLOSED ? "closed" : h.state == NFSTWEAK_TRACE_STATE_OPEN ? "open (crashed, killed or still running)" : "unknown");
+    if (h.faults != 0)
+        printf("  render_effects faults=%u, last at t=%.3fms\n", h.faults, session_ms(h.last_fault_qpc));
+    else
+        printf("  render_effects faults=0\n");
+
+    std::vector<record> records;
+    for (uint32_t i = 0; i < h.ring_count; ++i)
+    {
+        const size_t before = records.size();
+        uint32_t thread_id = 0;
+        collect_ring(file, h, i, records, thread_id);
+        if (thread_id != 0)
+            printf("  ring %u: tid=%u records=%zu\n", i, thread_id, records.size() - before);
+    }
+    if (summary_only)
+        return 0;
+
+    std::stable_sort(records.begin(), records.end(), [](const record &a, const record &b) { return a.header.qpc < b.header.qpc; });
+    const size_t first = (last != 0 && last < records.size()) ? records.size() - last : 0;
+    for (size_t i = first; i < records.size(); ++i)
+    {
+        const record &r = records[i];
+        const uint32_t *const w = r.words; // trimmed words read back as zero
+        printf("t=%.3fms tid=%u seq=%u ", session_ms(r.header.qpc), r.thread_id, static_cast<uint32_t>(r.header.seq));
+        switch (r.header.kind)
+        {
+        case NFSTWEAK_TRACE_KIND_SPAN_BEGIN:
+        case NFSTWEAK_TRACE_KIND_SPAN_END:
+            printf("NFSSpan: %s %s (id=%u) frame=%u detail=%u\n", r.header.kind == NFSTWEAK_TRACE_KIND_SPAN_BEGIN ? "begin" : "end",
+                span_name(w[0]), w[0], w[2], w[1]);
+            break;
+        case NFSTWEAK_TRACE_KIND_BRIDGE_EVENT:
+            printf("NFSBridge: %s (id=%u) bridge_frame=%u value=%u\n", bridge_event_name(w[0]), w[0], w[2], w[1]);
+            break;
+        case NFSTWEAK_TRACE_KIND_TIMELINE:
+            printf("NFSTimeline: frame=%u bridge_frame=%u token=%u predisplay_token_us=%u token_pass_us=%u pass_render_us=%u render_present_us=%u total_us=%u stages=0x%X\n",
+                w[0], w[1], w[2], w[5], w[6], w[7], w[8], w[3], w[4]);
+            break;
+        default:
+        {
+            uint64_t rtv = 0, dsv = 0;
+            lookup_signature(file, h, w[2], rtv, dsv);
+            printf("NFSTrace: %s kind=%u frame=%u bp=%u token=%u sig=%u rtv=%" PRIu64 " dsv=%" PRIu64 " score=%u reason=0x%X\n",
+                kind_name(r.header.kind), static_cast<uint32_t>(r.header.kind), w[0], w[1], w[3], w[2], rtv, dsv, w[4], w[5]);
+            break;
+        }
+        }
+    }
+    return 0;
+}